@@ -5,11 +5,14 @@
 #include <SDL2/SDL.h>
 #include <SHADERed/EditorEngine.h>
 #include <SHADERed/Objects/CommandLineOptionParser.h>
+#include <SHADERed/Objects/Export/ExportSequence.h>
 #include <SHADERed/Objects/Logger.h>
 #include <SHADERed/Objects/Settings.h>
+#include <SHADERed/Objects/Tracer.h>
 #include <glslang/Public/ShaderLang.h>
 
 #include <chrono>
+#include <cmath>
 #include <filesystem>
 #include <fstream>
 #include <thread>
@@ -45,6 +48,9 @@ int main(int argc, char* argv[])
 	srand(time(NULL));
 
 	std::filesystem::path cmdDir = std::filesystem::current_path();
+	std::string exePath = argc > 0 ? std::filesystem::absolute(argv[0]).generic_string() : "";
+	if (!std::filesystem::exists(exePath) && std::filesystem::exists("/proc/self/exe"))
+		exePath = std::filesystem::read_symlink("/proc/self/exe").generic_string(); // started through PATH
 
 	if (argc > 0) {
 		if (std::filesystem::exists(std::filesystem::path(argv[0]).parent_path())) {
@@ -59,6 +65,35 @@ int main(int argc, char* argv[])
 	if (!coptsParser.LaunchUI)
 		return 0;
 
+	if (!coptsParser.TraceFile.empty())
+		ed::Tracer::Instance().Start(coptsParser.TraceFile);
+
+	// sequence export options
+	ed::ExportSequence::Options seqOpts;
+	seqOpts.Path = coptsParser.ExportSequenceFile;
+	seqOpts.Encoder = coptsParser.ExportEncoder;
+	seqOpts.Width = coptsParser.ExportWidth;
+	seqOpts.Height = coptsParser.ExportHeight;
+	seqOpts.Supersample = coptsParser.ExportSupersample;
+	seqOpts.TileSize = coptsParser.ExportTileSize;
+	seqOpts.FPS = coptsParser.ExportFPS;
+	seqOpts.FrameStart = coptsParser.ExportFrameStart;
+	seqOpts.FrameEnd = coptsParser.ExportFrameEnd;
+	if (seqOpts.FrameEnd < 0)
+		seqOpts.FrameEnd = seqOpts.FrameStart + (int)std::ceil(coptsParser.ExportDuration * seqOpts.FPS);
+
+	// coordinator doesn't need a window - it only starts the workers & merges their output
+	if (!coptsParser.ExportSequenceFile.empty() && coptsParser.ExportWorkers > 1) {
+		if (coptsParser.ProjectFile.empty()) {
+			printf("A project file is needed for the distributed sequence export\n");
+			return 1;
+		}
+
+		bool success = ed::ExportSequence::RenderDistributed(exePath, coptsParser.ProjectFile, seqOpts, coptsParser.ExportWorkers);
+		ed::Logger::Get().Save();
+		return success ? 0 : 1;
+	}
+
 #if defined(__linux__) || defined(__unix__)
 	bool linuxUseHomeDir = false;
 
@@ -192,15 +227,20 @@ int main(int argc, char* argv[])
 	SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 3);
 	SDL_GL_SetAttribute(SDL_GL_DOUBLEBUFFER, 1); // double buffering
 
-	// open window
-	SDL_Window* wnd = SDL_CreateWindow("SHADERed", (wndPosX == -1) ? SDL_WINDOWPOS_CENTERED : wndPosX, (wndPosY == -1) ? SDL_WINDOWPOS_CENTERED : wndPosY, wndWidth, wndHeight, SDL_WINDOW_OPENGL | SDL_WINDOW_RESIZABLE | SDL_WINDOW_ALLOW_HIGHDPI);
+	// open window (hidden one if we only need the GL context for command line tasks)
+	Uint32 wndCreateFlags = SDL_WINDOW_OPENGL | SDL_WINDOW_RESIZABLE | SDL_WINDOW_ALLOW_HIGHDPI;
+	if (coptsParser.IsHeadless())
+		wndCreateFlags |= SDL_WINDOW_HIDDEN;
+	SDL_Window* wnd = SDL_CreateWindow("SHADERed", (wndPosX == -1) ? SDL_WINDOWPOS_CENTERED : wndPosX, (wndPosY == -1) ? SDL_WINDOWPOS_CENTERED : wndPosY, wndWidth, wndHeight, wndCreateFlags);
 	SetDpiAware();
 	SDL_SetWindowMinimumSize(wnd, 200, 200);
 
-	if (maximized)
-		SDL_MaximizeWindow(wnd);
-	if (fullscreen)
-		SDL_SetWindowFullscreen(wnd, SDL_WINDOW_FULLSCREEN_DESKTOP);
+	if (!coptsParser.IsHeadless()) {
+		if (maximized)
+			SDL_MaximizeWindow(wnd);
+		if (fullscreen)
+			SDL_SetWindowFullscreen(wnd, SDL_WINDOW_FULLSCREEN_DESKTOP);
+	}
 
 	// get GL context
 	SDL_GLContext glContext = SDL_GL_CreateContext(wnd);
@@ -220,15 +260,21 @@ int main(int argc, char* argv[])
 	// create engine
 	ed::EditorEngine engine(wnd, &glContext);
 	ed::Logger::Get().Log("Creating EditorEngine...");
-	engine.Create();
+	{
+		ed::TraceScope trace("Startup", "EditorEngine::Create");
+		engine.Create();
+	}
 	ed::Logger::Get().Log("Created EditorEngine");
 
 	// set window icon:
 	SetIcon(wnd);
 
+	engine.UI().SetHeadless(coptsParser.IsHeadless());
+
 	// open an item if given in arguments
 	if (!coptsParser.ProjectFile.empty()) {
 		ed::Logger::Get().Log("Openning a file provided through argument " + coptsParser.ProjectFile);
+		ed::TraceScope trace("Startup", "Open project", coptsParser.ProjectFile);
 		engine.UI().Open(coptsParser.ProjectFile);
 	}
 
@@ -238,12 +284,47 @@ int main(int argc, char* argv[])
 
 	// timer for time delta
 	ed::eng::Timer timer;
+	ed::eng::Timer activityTimer; // time since the last event
 	SDL_Event event;
 	bool run = true;
+	int exitCode = 0;
+
+	// command line tasks - run them and exit (a non-zero exit code tells the coordinator that a worker failed)
+	if (coptsParser.IsHeadless()) {
+		ed::RenderEngine& renderer = engine.Interface().Renderer;
+		renderer.Render(); // compile the pipeline
+		renderer.Pause(true); // and keep the audio streams quiet
+
+		if (!coptsParser.ExportAudioFile.empty()) {
+			if (renderer.ExportAudio(coptsParser.ExportAudioFile, coptsParser.ExportDuration))
+				ed::Logger::Get().Log("Exported audio to " + coptsParser.ExportAudioFile);
+			else
+				exitCode = 1;
+		}
+
+		if (!coptsParser.ExportSequenceFile.empty()) {
+			bool exported = ed::ExportSequence::Render(&engine.Interface(), seqOpts, [](int frame) {
+				printf("frame %d\n", frame);
+				fflush(stdout);
+			});
+			if (!exported)
+				exitCode = 1;
+		}
+
+		run = false;
+	}
+
 	bool minimized = false;
 	bool hasFocus = true;
 	while (run) {
+		// nothing is animated and there was no input for a while -> sleep until the next event
+		// (the timeout keeps things like auto recompile running)
+		if (activityTimer.GetElapsedTime() > 1.0f && engine.CanIdle())
+			SDL_WaitEventTimeout(nullptr, 500);
+
 		while (SDL_PollEvent(&event)) {
+			activityTimer.Restart();
+
 			if (event.type == SDL_QUIT) {
 				bool cont = true;
 				if (engine.Interface().Parser.IsProjectModified()) {
@@ -356,9 +437,10 @@ int main(int argc, char* argv[])
 
 	ed::Logger::Get().Log("Destroyed EditorEngine and SDL2");
 
+	ed::Tracer::Instance().Save();
 	ed::Logger::Get().Save();
 
-	return 0;
+	return exitCode;
 }
 
 void SetIcon(SDL_Window* wnd)
@@ -22,8 +22,12 @@ namespace ed {
 	}
 	void EditorEngine::Update(float delta)
 	{
-		// first update system time delta value
-		SystemVariableManager::Instance().SetTimeDelta(delta);
+		// first update the clock and system time delta value
+		SystemVariableManager& systemVM = SystemVariableManager::Instance();
+		int fixedFPS = Settings::Instance().Preview.FixedTimeStepFPS;
+		systemVM.SetFixedTimeStep(fixedFPS > 0 ? 1.0 / fixedFPS : 0.0);
+		if (!systemVM.IsFixedTimeStep())
+			systemVM.SetTimeDelta(delta);
 
 		m_ui.Update(delta);
 		m_interface.Update(delta);
@@ -32,6 +36,10 @@ namespace ed {
 	{
 		m_ui.Render();
 	}
+	bool EditorEngine::CanIdle()
+	{
+		return Settings::Instance().Preview.IdleWhenStatic && !m_interface.Renderer.IsTimeDependent() && !m_ui.IsAnimating();
+	}
 	void EditorEngine::Destroy()
 	{
 		m_interface.Pipeline.Clear();
@@ -14,6 +14,9 @@ namespace ed {
 		void Update(float delta);
 		void Render();
 
+		// true when nothing changes on its own - the main loop can wait for the next event
+		bool CanIdle();
+
 		void Create();
 		void Destroy();
 
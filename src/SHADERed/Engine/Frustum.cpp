@@ -0,0 +1,33 @@
+#include <SHADERed/Engine/Frustum.h>
+
+namespace ed {
+	namespace eng {
+		Frustum::Frustum()
+			: m_viewProj(1.0f)
+		{
+		}
+		bool Frustum::IsBoxVisible(const glm::mat4& world, const glm::vec3& minb, const glm::vec3& maxb)
+		{
+			glm::mat4 mvp = m_viewProj * world;
+
+			// the box is culled only if all 8 corners are on the outer side of the same clip plane
+			int outside[6] = { 0 };
+			for (int i = 0; i < 8; i++) {
+				glm::vec4 p = mvp * glm::vec4((i & 1) ? maxb.x : minb.x, (i & 2) ? maxb.y : minb.y, (i & 4) ? maxb.z : minb.z, 1.0f);
+
+				outside[0] += p.x < -p.w;
+				outside[1] += p.x > p.w;
+				outside[2] += p.y < -p.w;
+				outside[3] += p.y > p.w;
+				outside[4] += p.z < -p.w;
+				outside[5] += p.z > p.w;
+			}
+
+			for (int i = 0; i < 6; i++)
+				if (outside[i] == 8)
+					return false;
+
+			return true;
+		}
+	}
+}
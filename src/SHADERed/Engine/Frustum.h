@@ -0,0 +1,19 @@
+#pragma once
+#include <glm/glm.hpp>
+
+namespace ed {
+	namespace eng {
+		class Frustum {
+		public:
+			Frustum();
+
+			inline void SetViewProjection(const glm::mat4& viewProj) { m_viewProj = viewProj; }
+
+			// is any part of the (world transformed) box inside the clip volume
+			bool IsBoxVisible(const glm::mat4& world, const glm::vec3& minb, const glm::vec3& maxb);
+
+		private:
+			glm::mat4 m_viewProj;
+		};
+	}
+}
@@ -100,6 +100,18 @@ namespace ed {
 
 			return ret;
 		}
+		GLuint CompileSPIRVShader(GLenum type, const std::vector<unsigned int>& spv, const std::string& entry)
+		{
+			GLuint ret = glCreateShader(type);
+
+			glShaderBinary(1, &ret, GL_SHADER_BINARY_FORMAT_SPIR_V_ARB, spv.data(), spv.size() * sizeof(unsigned int));
+			if (GLEW_VERSION_4_6)
+				glSpecializeShader(ret, entry.c_str(), 0, nullptr, nullptr);
+			else
+				glSpecializeShaderARB(ret, entry.c_str(), 0, nullptr, nullptr);
+
+			return ret;
+		}
 		bool CheckShaderCompilationStatus(GLuint shader, GLchar* msg)
 		{
 			GLint ret = 0;
@@ -23,6 +23,7 @@ namespace ed {
 		GLuint CreateShader(const char** vsCode, const char** psCode, const std::string& name = "");
 
 		GLuint CompileShader(GLenum type, const GLchar* str);
+		GLuint CompileSPIRVShader(GLenum type, const std::vector<unsigned int>& spv, const std::string& entry); // ARB_gl_spirv
 		bool CheckShaderCompilationStatus(GLuint shader, GLchar* msg = nullptr);
 		bool CheckShaderLinkStatus(GLuint shader, GLchar* msg);
 
@@ -8,6 +8,9 @@
 #include <GL/gl.h>
 #endif
 #include <glm/gtc/constants.hpp>
+#include <map>
+#include <tuple>
+#include <unordered_map>
 
 namespace ed {
 	namespace eng {
@@ -131,6 +134,30 @@ namespace ed {
 			pt6[5] = n.z;
 			memcpy(verts + 5 * 18, pt6, sizeof(GLfloat) * 18);
 		}
+		// (shape, size) -> vertex buffer, buffer -> number of items using it
+		static std::map<std::tuple<int, float, float, float>, GLuint> sharedBuffers;
+		static std::unordered_map<GLuint, int> sharedBufferRefs;
+
+		GLuint createSharedBuffer(int shape, const glm::vec3& size, const GLfloat* verts, GLuint vertCount)
+		{
+			auto key = std::make_tuple(shape, size.x, size.y, size.z);
+			auto it = sharedBuffers.find(key);
+			if (it != sharedBuffers.end()) {
+				sharedBufferRefs[it->second]++;
+				return it->second;
+			}
+
+			GLuint vbo = 0;
+			glGenBuffers(1, &vbo);
+			glBindBuffer(GL_ARRAY_BUFFER, vbo);
+			glBufferData(GL_ARRAY_BUFFER, vertCount * 18 * sizeof(GLfloat), verts, GL_STATIC_DRAW);
+			glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+			sharedBuffers[key] = vbo;
+			sharedBufferRefs[vbo] = 1;
+
+			return vbo;
+		}
 		void calcBinormalAndTangents(GLfloat* verts, GLuint vertCount)
 		{
 			/* http://www.opengl-tutorial.org/intermediate-tutorials/tutorial-13-normal-mapping/ */
@@ -256,10 +283,7 @@ namespace ed {
 			calcBinormalAndTangents(&cubeData[0], 36);
 
 			// create vbo
-			glGenBuffers(1, &vbo);
-			glBindBuffer(GL_ARRAY_BUFFER, vbo);
-			glBufferData(GL_ARRAY_BUFFER, 36 * 18 * sizeof(GLfloat), cubeData, GL_STATIC_DRAW | GL_STATIC_READ);
-			glBindBuffer(GL_ARRAY_BUFFER, 0);
+			vbo = createSharedBuffer(0, glm::vec3(sx, sy, sz), cubeData, 36);
 
 			GLuint vao = 0;
 			gl::CreateVAO(vao, vbo, inp);
@@ -296,10 +320,7 @@ namespace ed {
 			calcBinormalAndTangents(&circleData[0], numPoints);
 
 			// create vbo
-			glGenBuffers(1, &vbo);
-			glBindBuffer(GL_ARRAY_BUFFER, vbo);
-			glBufferData(GL_ARRAY_BUFFER, numPoints * 18 * sizeof(GLfloat), circleData, GL_STATIC_DRAW);
-			glBindBuffer(GL_ARRAY_BUFFER, 0);
+			vbo = createSharedBuffer(2, glm::vec3(rx, ry, 0.0f), circleData, numPoints);
 
 			GLuint vao;
 			gl::CreateVAO(vao, vbo, inp);
@@ -325,10 +346,7 @@ namespace ed {
 			calcBinormalAndTangents(&planeData[0], 6);
 
 			// create vbo
-			glGenBuffers(1, &vbo);
-			glBindBuffer(GL_ARRAY_BUFFER, vbo);
-			glBufferData(GL_ARRAY_BUFFER, 6 * 18 * sizeof(GLfloat), planeData, GL_STATIC_DRAW);
-			glBindBuffer(GL_ARRAY_BUFFER, 0);
+			vbo = createSharedBuffer(5, glm::vec3(sx, sy, 0.0f), planeData, 6);
 
 			GLuint vao;
 			gl::CreateVAO(vao, vbo, inp);
@@ -359,10 +377,7 @@ namespace ed {
 			calcBinormalAndTangents(&sphereData[0], count);
 
 			// create vbo
-			glGenBuffers(1, &vbo);
-			glBindBuffer(GL_ARRAY_BUFFER, vbo);
-			glBufferData(GL_ARRAY_BUFFER, count * 18 * sizeof(GLfloat), sphereData, GL_STATIC_DRAW);
-			glBindBuffer(GL_ARRAY_BUFFER, 0);
+			vbo = createSharedBuffer(4, glm::vec3(r, 0.0f, 0.0f), sphereData, count);
 
 			GLuint vao;
 			gl::CreateVAO(vao, vbo, inp);
@@ -383,10 +398,7 @@ namespace ed {
 			calcBinormalAndTangents(&triData[0], 3);
 
 			// create vbo
-			glGenBuffers(1, &vbo);
-			glBindBuffer(GL_ARRAY_BUFFER, vbo);
-			glBufferData(GL_ARRAY_BUFFER, 3 * 18 * sizeof(GLfloat), triData, GL_STATIC_DRAW);
-			glBindBuffer(GL_ARRAY_BUFFER, 0);
+			vbo = createSharedBuffer(3, glm::vec3(s, 0.0f, 0.0f), triData, 3);
 
 			GLuint vao;
 			gl::CreateVAO(vao, vbo, inp);
@@ -432,5 +444,22 @@ namespace ed {
 
 			return vao;
 		}
+		void GeometryFactory::Release(unsigned int vbo)
+		{
+			auto ref = sharedBufferRefs.find(vbo);
+			if (ref != sharedBufferRefs.end()) {
+				if (--ref->second > 0)
+					return;
+
+				sharedBufferRefs.erase(ref);
+				for (auto it = sharedBuffers.begin(); it != sharedBuffers.end(); it++)
+					if (it->second == vbo) {
+						sharedBuffers.erase(it);
+						break;
+					}
+			}
+
+			glDeleteBuffers(1, &vbo);
+		}
 	}
 }
\ No newline at end of file
@@ -25,6 +25,9 @@ namespace ed {
 			static unsigned int CreateSphere(unsigned int& vbo, float r, const std::vector<InputLayoutItem>& inp);
 			static unsigned int CreateTriangle(unsigned int& vbo, float s, const std::vector<InputLayoutItem>& inp);
 			static unsigned int CreateScreenQuadNDC(unsigned int& vbo, const std::vector<InputLayoutItem>& inp);
+
+			// geometry with the same shape & size shares one vertex buffer - use this instead of glDeleteBuffers
+			static void Release(unsigned int vbo);
 		};
 	}
 }
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include <SHADERed/Engine/Model.h>
+#include <SHADERed/Objects/GLState.h>
 #include <SHADERed/Objects/Logger.h>
 
 #ifdef _WIN32
@@ -55,7 +56,7 @@ namespace ed {
 		void Model::Mesh::Draw(bool instanced, int iCount)
 		{
 			// draw mesh
-			glBindVertexArray(VAO);
+			GLState::Instance().BindVertexArray(VAO);
 
 			if (instanced)
 				glDrawElementsInstanced(GL_TRIANGLES, Indices.size(), GL_UNSIGNED_INT, nullptr, iCount);
@@ -100,14 +101,16 @@ namespace ed {
 			m_maxBound = glm::vec3(-std::numeric_limits<float>::infinity());
 
 			for (auto& mesh : Meshes) {
+				mesh.MinBound = glm::vec3(std::numeric_limits<float>::infinity());
+				mesh.MaxBound = glm::vec3(-std::numeric_limits<float>::infinity());
+
 				for (auto& v : mesh.Vertices) {
-					m_minBound.x = std::min<float>(m_minBound.x, v.Position.x);
-					m_minBound.y = std::min<float>(m_minBound.y, v.Position.y);
-					m_minBound.z = std::min<float>(m_minBound.z, v.Position.z);
-					m_maxBound.x = std::max<float>(m_maxBound.x, v.Position.x);
-					m_maxBound.y = std::max<float>(m_maxBound.y, v.Position.y);
-					m_maxBound.z = std::max<float>(m_maxBound.z, v.Position.z);
+					mesh.MinBound = glm::min(mesh.MinBound, v.Position);
+					mesh.MaxBound = glm::max(mesh.MaxBound, v.Position);
 				}
+
+				m_minBound = glm::min(m_minBound, mesh.MinBound);
+				m_maxBound = glm::max(m_maxBound, mesh.MaxBound);
 			}
 		}
 		std::vector<std::string> Model::GetMeshNames()
@@ -36,6 +36,7 @@ namespace ed {
 				void Draw(bool instanced = false, int iCount = 0);
 
 				unsigned int VAO, VBO, EBO;
+				glm::vec3 MinBound, MaxBound; // set when the model is loaded
 
 			private:
 				void m_setup();
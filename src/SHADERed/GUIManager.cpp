@@ -3,6 +3,7 @@
 #include <SHADERed/InterfaceManager.h>
 #include <SHADERed/Objects/CameraSnapshots.h>
 #include <SHADERed/Objects/Export/ExportCPP.h>
+#include <SHADERed/Objects/Export/ExportSequence.h>
 #include <SHADERed/Objects/ChangelogFetcher.h>
 #include <SHADERed/Objects/TipFetcher.h>
 #include <SHADERed/Objects/FunctionVariableManager.h>
@@ -37,6 +38,7 @@
 #include <imgui/imgui.h>
 #include <ImGuiFileDialog/ImGuiFileDialog.h>
 
+#include <cmath>
 #include <filesystem>
 #include <fstream>
 
@@ -59,6 +61,7 @@
 
 #define HARRAYSIZE(a) (sizeof(a) / sizeof(*a))
 #define TOOLBAR_HEIGHT 48
+#define RECOVERY_INTERVAL 600.0f // seconds
 
 #define getByte(value, n) (value >> (n * 8) & 0xFF)
 
@@ -98,7 +101,9 @@ namespace ed {
 		m_isChangelogOpened = false;
 		m_savePreviewSeqDuration = 5.5f;
 		m_savePreviewSeqFPS = 30;
+		strcpy(m_savePreviewSeqEncoder, "ffmpeg -y -loglevel error -f yuv4mpegpipe -i - -pix_fmt yuv420p %s");
 		m_savePreviewSupersample = 0;
+		m_savePreviewTiles = 0;
 		m_iconFontLarge = nullptr;
 		m_expcppBackend = 0;
 		m_expcppCmakeFiles = true;
@@ -116,6 +121,7 @@ namespace ed {
 		m_recompiledAll = false;
 		m_isIncompatPluginsOpened = false;
 		m_minimalMode = false;
+		m_headless = false;
 		m_cubemapPathPtr = nullptr;
 
 		m_uiIniFile = "data/workspace.dat";
@@ -251,10 +257,24 @@ namespace ed {
 		ImGui::DestroyContext();
 	}
 
+	bool GUIManager::IsAnimating()
+	{
+		if (m_splashScreen || m_notifs.Has())
+			return true;
+
+		// menu bar is hidden a few seconds after entering the performance mode
+		if (m_performanceMode && m_perfModeClock.GetElapsedTime() < 3.0f)
+			return true;
+
+		return ((CodeEditorUI*)Get(ViewID::Code))->TrackedFilesNeedUpdate();
+	}
 	void GUIManager::OnEvent(const SDL_Event& e)
 	{
 		m_imguiHandleEvent(e);
 
+		// any input might change what the preview shows
+		m_data->Renderer.Invalidate();
+
 		if (m_splashScreen) {
 
 			return;
@@ -284,7 +304,7 @@ namespace ed {
 
 				const std::vector<std::string> imgExt = { "png", "jpeg", "jpg", "bmp", "gif", "psd", "pic", "pnm", "hdr", "tga" };
 				const std::vector<std::string> sndExt = { "ogg", "wav", "flac", "aiff", "raw" }; // TODO: more file ext
-				const std::vector<std::string> projExt = { "sprj" };
+				const std::vector<std::string> projExt = { "sprj", "sprjb" };
 
 				if (std::count(projExt.begin(), projExt.end(), ext) > 0) {
 					bool cont = true;
@@ -350,6 +370,13 @@ namespace ed {
 		Settings& settings = Settings::Instance();
 		m_performanceMode = m_perfModeFake;
 
+		// crash recovery - only the snapshot is taken here, files are written on a background thread
+		if (m_recoveryTimer.GetElapsedTime() >= RECOVERY_INTERVAL) {
+			if (settings.General.Recovery && m_data->Parser.IsProjectModified())
+				m_data->Parser.SaveRecovery();
+			m_recoveryTimer.Restart();
+		}
+
 		// update audio textures
 		FunctionVariableManager::Instance().ClearVariableList();
 
@@ -448,16 +475,10 @@ namespace ed {
 		// rebuild
 		if (((CodeEditorUI*)Get(ViewID::Code))->TrackedFilesNeedUpdate()) {
 			if (!m_recompiledAll) {
-				std::vector<bool> needsUpdate = ((CodeEditorUI*)Get(ViewID::Code))->TrackedNeedsUpdate();
-				std::vector<PipelineItem*> passes = m_data->Pipeline.GetList();
-				int ind = 0;
-				if (needsUpdate.size() >= passes.size()) {
-					for (PipelineItem*& pass : passes) {
-						if (needsUpdate[ind])
-							m_data->Renderer.Recompile(pass->Name);
-						ind++;
-					}
-				}
+				std::vector<std::string> needsUpdate = ((CodeEditorUI*)Get(ViewID::Code))->TrackedNeedsUpdate();
+				for (const auto& name : needsUpdate)
+					if (m_data->Pipeline.Has(name.c_str()))
+						m_data->Renderer.Recompile(name.c_str());
 			}
 
 			((CodeEditorUI*)Get(ViewID::Code))->EmptyTrackedFiles();
@@ -612,7 +633,7 @@ namespace ed {
 					}
 
 					if (cont)
-						igfd::ImGuiFileDialog::Instance()->OpenModal("OpenProjectDlg", "Open SHADERed project", "SHADERed project (*.sprj){.sprj},.*", ".");
+						igfd::ImGuiFileDialog::Instance()->OpenModal("OpenProjectDlg", "Open SHADERed project", "SHADERed project (*.sprj){.sprj},SHADERed binary project (*.sprjb){.sprjb},.*", ".");
 				}
 				if (ImGui::MenuItem("Save", KeyboardShortcuts::Instance().GetString("Project.Save").c_str()))
 					Save();
@@ -864,6 +885,7 @@ namespace ed {
 		// open popup for saving preview as image
 		if (m_savePreviewPopupOpened) {
 			ImGui::OpenPopup("Save Preview##main_save_preview");
+			m_savePreviewError.clear();
 			m_previewSavePath = "render.png";
 			m_savePreviewPopupOpened = false;
 			m_wasPausedPrior = m_data->Renderer.IsPaused();
@@ -1292,6 +1314,8 @@ namespace ed {
 			ImGui::TextWrapped("KeysWASD (vec4) - W, A, S or D keys state");
 			ImGui::TextWrapped("Mouse (vec4) - vec4(x,y,left,right) updated every frame");
 			ImGui::TextWrapped("MouseButton (vec4) - vec4(viewX,viewY,clickX,clickY) updated only when left mouse button is down");
+			ImGui::TextWrapped("ViewportOffset (vec2) - offset of the current tile when exporting in tiles, use (gl_FragCoord.xy + ViewportOffset) / ViewportSize");
+			ImGui::TextWrapped("IterationIndex (uint) - index of the current iteration of a compute pass that runs multiple times per frame");
 
 			ImGui::NewLine();
 			ImGui::Separator();
@@ -1357,7 +1381,7 @@ namespace ed {
 			ImGui::TextWrapped("Path: %s", m_previewSavePath.c_str());
 			ImGui::SameLine();
 			if (ImGui::Button("...##save_prev_path"))
-				igfd::ImGuiFileDialog::Instance()->OpenModal("SavePreviewDlg", "Save", "Image file (*.png;*.jpg;*.jpeg;*.bmp;*.tga){.png,.jpg,.jpeg,.bmp,.tga},.*", ".");
+				igfd::ImGuiFileDialog::Instance()->OpenModal("SavePreviewDlg", "Save", "Image file (*.png;*.jpg;*.jpeg;*.bmp;*.tga){.png,.jpg,.jpeg,.bmp,.tga},Video file (*.y4m;*.mp4;*.mkv;*.webm){.y4m,.mp4,.mkv,.webm},.*", ".");
 			if (igfd::ImGuiFileDialog::Instance()->FileDialog("SavePreviewDlg")) {
 				if (igfd::ImGuiFileDialog::Instance()->IsOk)
 					m_previewSavePath = igfd::ImGuiFileDialog::Instance()->GetFilepathName();
@@ -1382,6 +1406,14 @@ namespace ed {
 			ImGui::Combo("##save_prev_ssmp", &m_savePreviewSupersample, " 1x\0 2x\0 4x\0 8x\0");
 			ImGui::Unindent(Settings::Instance().CalculateSize(110));
 
+			ImGui::Text("Tiles: ");
+			ImGui::SameLine();
+			ImGui::Indent(Settings::Instance().CalculateSize(110));
+			ImGui::Combo("##save_prev_tiles", &m_savePreviewTiles, " Off\0 256x256\0 512x512\0 1024x1024\0 2048x2048\0");
+			ImGui::Unindent(Settings::Instance().CalculateSize(110));
+			if (ImGui::IsItemHovered())
+				ImGui::SetTooltip("Render the image in tiles to support sizes that don't fit in GPU memory.\nShaders that use gl_FragCoord should add the ViewportOffset system variable to it.");
+
 			ImGui::Separator();
 			if (ImGui::CollapsingHeader("Sequence")) {
 				ImGui::TextWrapped("Export a sequence of images");
@@ -1410,6 +1442,15 @@ namespace ed {
 				ImGui::DragInt("##save_prev_seqfps", &m_savePreviewSeqFPS);
 				ImGui::PopItemWidth();
 
+				/* VIDEO ENCODER */
+				ImGui::Text("Encoder:");
+				ImGui::SameLine();
+				ImGui::PushItemWidth(-1);
+				ImGui::InputText("##save_prev_seqenc", m_savePreviewSeqEncoder, sizeof(m_savePreviewSeqEncoder));
+				ImGui::PopItemWidth();
+				if (ImGui::IsItemHovered())
+					ImGui::SetTooltip("Command used for .mp4, .mkv, .webm, .mov, .avi and .nut files - it receives a YUV4MPEG2 stream\nthrough stdin, %%s is replaced with the output path. .y4m files are written directly.");
+
 				if (!m_savePreviewSeq) {
 					ImGui::PopItemFlag();
 					ImGui::PopStyleVar();
@@ -1490,7 +1531,12 @@ namespace ed {
 			bool rerenderPreview = false;
 			glm::ivec2 rerenderSize = m_data->Renderer.GetLastRenderSize();
 
+			if (!m_savePreviewError.empty())
+				ImGui::TextWrapped("Export failed: %s", m_savePreviewError.c_str());
+
 			if (ImGui::Button("Save")) {
+				m_savePreviewError.clear();
+
 				int sizeMulti = 1;
 				switch (m_savePreviewSupersample) {
 				case 1: sizeMulti = 2; break;
@@ -1499,11 +1545,21 @@ namespace ed {
 				}
 				int actualSizeX = m_previewSaveSize.x * sizeMulti;
 				int actualSizeY = m_previewSaveSize.y * sizeMulti;
+				int tileSize = m_savePreviewTiles == 0 ? 0 : (128 << m_savePreviewTiles);
 
 				SystemVariableManager::Instance().SetSavingToFile(true);
 
 				// normal render
 				if (!m_savePreviewSeq) {
+					// tiled render never needs the whole supersampled image in memory
+					unsigned char* pixels = tileSize > 0 ? nullptr : (unsigned char*)malloc(actualSizeX * actualSizeY * 4);
+					unsigned char* outPixels = nullptr;
+
+					if (sizeMulti != 1 || tileSize > 0)
+						outPixels = (unsigned char*)malloc(m_previewSaveSize.x * m_previewSaveSize.y * 4);
+					else
+						outPixels = pixels;
+
 					if (actualSizeX > 0 && actualSizeY > 0) {
 						SystemVariableManager::Instance().CopyState();
 
@@ -1513,30 +1569,27 @@ namespace ed {
 						SystemVariableManager::Instance().SetMousePosition(m_savePreviewMouse.x, m_savePreviewMouse.y);
 						SystemVariableManager::Instance().SetMouse(m_savePreviewMouse.x, m_savePreviewMouse.y, m_savePreviewMouse.z, m_savePreviewMouse.w);
 
-						m_data->Renderer.Render(actualSizeX, actualSizeY);
+						if (tileSize > 0)
+							m_data->Renderer.RenderTiled(m_previewSaveSize.x, m_previewSaveSize.y, tileSize, sizeMulti, outPixels);
+						else
+							m_data->Renderer.Render(actualSizeX, actualSizeY);
 
 						SystemVariableManager::Instance().AdvanceTimer(m_savePreviewCachedTime - m_savePreviewTime);
 					
 						rerenderPreview = true;
 					}
 
-					unsigned char* pixels = (unsigned char*)malloc(actualSizeX * actualSizeY * 4);
-					unsigned char* outPixels = nullptr;
-
-					if (sizeMulti != 1)
-						outPixels = (unsigned char*)malloc(m_previewSaveSize.x * m_previewSaveSize.y * 4);
-					else
-						outPixels = pixels;
-
-					GLuint tex = m_data->Renderer.GetTexture();
-					glBindTexture(GL_TEXTURE_2D, tex);
-					glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
-					glBindTexture(GL_TEXTURE_2D, 0);
-
-					// resize image
-					if (sizeMulti != 1) {
-						stbir_resize_uint8(pixels, actualSizeX, actualSizeY, actualSizeX * 4,
-							outPixels, m_previewSaveSize.x, m_previewSaveSize.y, m_previewSaveSize.x * 4, 4);
+					if (tileSize == 0) {
+						GLuint tex = m_data->Renderer.GetTexture();
+						glBindTexture(GL_TEXTURE_2D, tex);
+						glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+						glBindTexture(GL_TEXTURE_2D, 0);
+
+						// resize image
+						if (sizeMulti != 1) {
+							stbir_resize_uint8(pixels, actualSizeX, actualSizeY, actualSizeX * 4,
+								outPixels, m_previewSaveSize.x, m_previewSaveSize.y, m_previewSaveSize.x * 4, 4);
+						}
 					}
 
 					std::string ext = m_previewSavePath.substr(m_previewSavePath.find_last_of('.') + 1);
@@ -1550,162 +1603,38 @@ namespace ed {
 					else
 						stbi_write_png(m_previewSavePath.c_str(), m_previewSaveSize.x, m_previewSaveSize.y, 4, outPixels, m_previewSaveSize.x * 4);
 
-					if (sizeMulti != 1) free(outPixels);
+					if (outPixels != pixels) free(outPixels);
 					free(pixels);
-				} else { // sequence render
-					float seqDelta = 1.0f / m_savePreviewSeqFPS;
-
-					if (actualSizeX > 0 && actualSizeY > 0) {
-						SystemVariableManager::Instance().SetKeysWASD(m_savePreviewWASD[0], m_savePreviewWASD[1], m_savePreviewWASD[2], m_savePreviewWASD[3]);
-						SystemVariableManager::Instance().SetMousePosition(m_savePreviewMouse.x, m_savePreviewMouse.y);
-						SystemVariableManager::Instance().SetMouse(m_savePreviewMouse.x, m_savePreviewMouse.y, m_savePreviewMouse.z, m_savePreviewMouse.w);
-
-						float curTime = 0.0f;
-
-						GLuint tex = m_data->Renderer.GetTexture();
-
-						size_t lastDot = m_previewSavePath.find_last_of('.');
-						std::string ext = lastDot == std::string::npos ? "png" : m_previewSavePath.substr(lastDot + 1);
-						std::string filename = m_previewSavePath;
-
-						// allow only one %??d
-						bool inFormat = false;
-						int lastFormatPos = -1;
-						int formatCount = 0;
-						for (int i = 0; i < filename.size(); i++) {
-							if (filename[i] == '%') {
-								inFormat = true;
-								lastFormatPos = i;
-								continue;
-							}
-
-							if (inFormat) {
-								if (isdigit(filename[i])) {
-								} else {
-									if (filename[i] != '%' && ((filename[i] == 'd' && formatCount > 0) || (filename[i] != 'd'))) {
-										filename.insert(lastFormatPos, 1, '%');
-									}
-
-									if (filename[i] == 'd')
-										formatCount++;
-									inFormat = false;
-								}
-							}
-						}
-
-						// no %d found? add one
-						if (formatCount == 0)
-							filename.insert(lastDot == std::string::npos ? filename.size() : lastDot, "%d"); // frame%d
-
-						SystemVariableManager::Instance().AdvanceTimer(m_savePreviewCachedTime - m_savePreviewTimeDelta);
-						SystemVariableManager::Instance().SetTimeDelta(seqDelta);
-
-						stbi_write_png_compression_level = 5; // set to lowest compression level
-
-						int tCount = std::thread::hardware_concurrency();
-						tCount = tCount == 0 ? 2 : tCount;
-
-						unsigned char** pixels = new unsigned char*[tCount];
-						unsigned char** outPixels = new unsigned char*[tCount];
-						int* curFrame = new int[tCount];
-						bool* needsUpdate = new bool[tCount];
-						std::thread** threadPool = new std::thread*[tCount];
-						std::atomic<bool> isOver = false;
-
-						for (int i = 0; i < tCount; i++) {
-							curFrame[i] = 0;
-							needsUpdate[i] = true;
-							pixels[i] = (unsigned char*)malloc(actualSizeX * actualSizeY * 4);
-
-							if (sizeMulti != 1)
-								outPixels[i] = (unsigned char*)malloc(m_previewSaveSize.x * m_previewSaveSize.y * 4);
-							else
-								outPixels[i] = nullptr;
-
-							threadPool[i] = new std::thread([ext, filename, sizeMulti, actualSizeX, actualSizeY, &outPixels, &pixels, &needsUpdate, &curFrame, &isOver](int worker, int w, int h) {
-								char prevSavePath[SHADERED_MAX_PATH];
-								while (!isOver) {
-									if (needsUpdate[worker])
-										continue;
-
-									// resize image
-									if (sizeMulti != 1) {
-										stbir_resize_uint8(pixels[worker], actualSizeX, actualSizeY, actualSizeX * 4,
-											outPixels[worker], w, h, w * 4, 4);
-									} else
-										outPixels[worker] = pixels[worker];
-
-									sprintf(prevSavePath, filename.c_str(), curFrame[worker]);
-
-									if (ext == "jpg" || ext == "jpeg")
-										stbi_write_jpg(prevSavePath, w, h, 4, outPixels[worker], 100);
-									else if (ext == "bmp")
-										stbi_write_bmp(prevSavePath, w, h, 4, outPixels[worker]);
-									else if (ext == "tga")
-										stbi_write_tga(prevSavePath, w, h, 4, outPixels[worker]);
-									else
-										stbi_write_png(prevSavePath, w, h, 4, outPixels[worker], w * 4);
-
-									needsUpdate[worker] = true;
-								}
-							},
-								i, m_previewSaveSize.x, m_previewSaveSize.y);
-						}
-
-						int globalFrame = 0;
-						while (curTime < m_savePreviewSeqDuration) {
-							int hasWork = -1;
-							for (int i = 0; i < tCount; i++)
-								if (needsUpdate[i]) {
-									hasWork = i;
-									break;
-								}
-
-							if (hasWork == -1)
-								continue;
-
-							SystemVariableManager::Instance().CopyState();
-							SystemVariableManager::Instance().SetFrameIndex(m_savePreviewFrameIndex + globalFrame);
-
-							m_data->Renderer.Render(actualSizeX, actualSizeY);
-
-							glBindTexture(GL_TEXTURE_2D, tex);
-							glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels[hasWork]);
-							glBindTexture(GL_TEXTURE_2D, 0);
-
-							SystemVariableManager::Instance().AdvanceTimer(seqDelta);
-
-							curTime += seqDelta;
-							curFrame[hasWork] = globalFrame;
-							needsUpdate[hasWork] = false;
-							globalFrame++;
-						}
-						isOver = true;
-
-						for (int i = 0; i < tCount; i++) {
-							if (threadPool[i]->joinable())
-								threadPool[i]->join();
-							free(pixels[i]);
-							if (sizeMulti != 1)
-								free(outPixels[i]);
-							delete threadPool[i];
-						}
-						delete[] pixels;
-						delete[] outPixels;
-						delete[] curFrame;
-						delete[] needsUpdate;
-						delete[] threadPool;
-
-						stbi_write_png_compression_level = 8; // set back to default compression level
-
-						rerenderPreview = true;
-					}
+				} else if (actualSizeX > 0 && actualSizeY > 0) { // sequence render
+					SystemVariableManager::Instance().SetKeysWASD(m_savePreviewWASD[0], m_savePreviewWASD[1], m_savePreviewWASD[2], m_savePreviewWASD[3]);
+					SystemVariableManager::Instance().SetMousePosition(m_savePreviewMouse.x, m_savePreviewMouse.y);
+					SystemVariableManager::Instance().SetMouse(m_savePreviewMouse.x, m_savePreviewMouse.y, m_savePreviewMouse.z, m_savePreviewMouse.w);
+
+					ExportSequence::Options opts;
+					opts.Path = m_previewSavePath;
+					opts.Encoder = m_savePreviewSeqEncoder;
+					opts.Width = m_previewSaveSize.x;
+					opts.Height = m_previewSaveSize.y;
+					opts.Supersample = sizeMulti;
+					opts.TileSize = tileSize;
+					opts.FPS = m_savePreviewSeqFPS;
+					opts.FrameStart = m_savePreviewFrameIndex;
+					opts.FrameEnd = opts.FrameStart + (int)std::ceil(m_savePreviewSeqDuration * m_savePreviewSeqFPS);
+					opts.StartTime = m_savePreviewTime;
+
+					if (!ExportSequence::Render(m_data, opts, nullptr, &m_savePreviewError) && m_savePreviewError.empty())
+						m_savePreviewError = "Failed to export the sequence";
+
+					rerenderPreview = true;
 				}
 
 				SystemVariableManager::Instance().SetSavingToFile(false);
 
-				m_data->Renderer.Pause(m_wasPausedPrior);
-				ImGui::CloseCurrentPopup();
+				// keep the popup open so that the error can be read
+				if (m_savePreviewError.empty()) {
+					m_data->Renderer.Pause(m_wasPausedPrior);
+					ImGui::CloseCurrentPopup();
+				}
 			}
 			ImGui::SameLine();
 			if (ImGui::Button("Cancel")) {
@@ -2001,6 +1930,10 @@ namespace ed {
 		codeUI->SaveSnippets();
 		codeUI->SetTrackFileChanges(false);
 		codeUI->StopThreads();
+
+		// closed normally - unsaved changes were either saved or thrown away
+		if (!m_headless)
+			m_data->Parser.DiscardRecovery(m_data->Parser.GetOpenedFile());
 	}
 
 	int GUIManager::AreYouSure()
@@ -2071,7 +2004,7 @@ namespace ed {
 			}
 
 			if (cont)
-				igfd::ImGuiFileDialog::Instance()->OpenModal("OpenProjectDlg", "Open SHADERed project", "SHADERed project (*.sprj){.sprj},.*", ".");
+				igfd::ImGuiFileDialog::Instance()->OpenModal("OpenProjectDlg", "Open SHADERed project", "SHADERed project (*.sprj){.sprj},SHADERed binary project (*.sprjb){.sprjb},.*", ".");
 		}
 		ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(0, 0, 0, 0));
 		m_tooltip("Open a project");
@@ -2462,7 +2395,7 @@ namespace ed {
 		m_saveAsRestoreCache = restoreCached;
 		m_saveAsHandle = handle;
 		m_saveAsPreHandle = preHandle;
-		igfd::ImGuiFileDialog::Instance()->OpenModal("SaveProjectDlg", "Save project", "SHADERed project (*.sprj){.sprj},.*", ".");
+		igfd::ImGuiFileDialog::Instance()->OpenModal("SaveProjectDlg", "Save project", "SHADERed project (*.sprj){.sprj},SHADERed binary project (*.sprjb){.sprjb},.*", ".");
 	}
 	void GUIManager::Open(const std::string& file)
 	{
@@ -2470,10 +2403,28 @@ namespace ed {
 
 		glm::ivec2 curSize = m_data->Renderer.GetLastRenderSize();
 
+		// command line tasks render the saved project and keep the recovery files for the next interactive run
+		int restoreID = -1;
+		if (!m_headless && m_data->Parser.HasRecovery(file)) {
+			restoreID = UIHelper::MessageBox_YesNoCancel(m_wnd, "SHADERed wasn't closed properly while this project had unsaved changes. Restore them?");
+			if (restoreID == 2)
+				return;
+		}
+
+		// the project that is being closed doesn't need its recovery files anymore
+		if (!m_headless)
+			m_data->Parser.DiscardRecovery(m_data->Parser.GetOpenedFile());
+
 		this->ResetWorkspace();
 		m_data->Renderer.Pause(false); // unpause
 
-		m_data->Parser.Open(file);
+		if (restoreID == 0)
+			m_data->Parser.OpenRecovery(file);
+		else {
+			if (restoreID == 1)
+				m_data->Parser.DiscardRecovery(file);
+			m_data->Parser.Open(file);
+		}
 
 		std::string projName = m_data->Parser.GetOpenedFile();
 		projName = projName.substr(projName.find_last_of("/\\") + 1);
@@ -2537,7 +2488,7 @@ namespace ed {
 			}
 
 			if (cont)
-				igfd::ImGuiFileDialog::Instance()->OpenModal("OpenProjectDlg", "Open SHADERed project", "SHADERed project (*.sprj){.sprj},.*", ".");
+				igfd::ImGuiFileDialog::Instance()->OpenModal("OpenProjectDlg", "Open SHADERed project", "SHADERed project (*.sprj){.sprj},SHADERed binary project (*.sprjb){.sprjb},.*", ".");
 		});
 		KeyboardShortcuts::Instance().SetCallback("Project.New", [=]() {
 			this->ResetWorkspace();
@@ -75,6 +75,10 @@ namespace ed {
 		inline void SetPerformanceMode(bool mode) { m_perfModeFake = mode; }
 		inline void SetMinimalMode(bool mode) { m_minimalMode = mode; }
 		inline bool IsMinimalMode() { return m_minimalMode; }
+		inline void SetHeadless(bool headless) { m_headless = headless; } // command line tasks - no prompts, recovery files are left alone
+
+		// is some part of the UI animated/waiting on its own (without any input)
+		bool IsAnimating();
 
 		void AddNotification(int id, const char* text, const char* btnText, std::function<void(int, IPlugin1*)> fn, IPlugin1* plugin = nullptr);
 
@@ -112,6 +116,7 @@ namespace ed {
 		bool m_fontNeedsUpdate;
 
 		bool m_minimalMode;
+		bool m_headless;
 
 		bool m_cacheProjectModified;
 		bool m_recompiledAll;
@@ -131,6 +136,7 @@ namespace ed {
 		float m_savePreviewTime, m_savePreviewCachedTime, m_savePreviewTimeDelta;
 		int m_savePreviewFrameIndex, m_savePreviewCachedFIndex;
 		int m_savePreviewSupersample;
+		int m_savePreviewTiles;
 		bool m_savePreviewWASD[4];
 		glm::vec4 m_savePreviewMouse;
 		std::string m_previewSavePath;
@@ -171,10 +177,14 @@ namespace ed {
 		bool m_savePreviewSeq;
 		float m_savePreviewSeqDuration;
 		int m_savePreviewSeqFPS;
+		char m_savePreviewSeqEncoder[512];
+		std::string m_savePreviewError; // shown in the popup after a failed video export
 
 		bool m_performanceMode, m_perfModeFake;
 		eng::Timer m_perfModeClock;
 
+		eng::Timer m_recoveryTimer; // time since the last recovery snapshot
+
 		std::string m_uiIniFile;
 
 		std::string* m_cubemapPathPtr;
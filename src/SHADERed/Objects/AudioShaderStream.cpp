@@ -4,6 +4,7 @@
 #include <SHADERed/Objects/ShaderCompiler.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
 #include <vector>
 
 namespace ed {
@@ -15,13 +16,17 @@ namespace ed {
 		memset(m_pixels, 0, sizeof(char) * 1024);
 		m_needsUpdate = false;
 
+		m_offlineFbo = m_offlineRt = m_offlineDepth = 0;
+
 		initialize(2, 44100);
 	}
 	AudioShaderStream::~AudioShaderStream()
 	{
 		gl::FreeSimpleFramebuffer(m_fbo, m_rt, m_depth);
+		if (m_offlineFbo != 0)
+			gl::FreeSimpleFramebuffer(m_offlineFbo, m_offlineRt, m_offlineDepth);
 		glDeleteVertexArrays(1, &m_fsRectVAO);
-		glDeleteBuffers(1, &m_fsRectVBO);
+		ed::eng::GeometryFactory::Release(m_fsRectVBO);
 		glDeleteProgram(m_shader);
 		stop();
 	}
@@ -51,7 +56,7 @@ namespace ed {
 			layout (location = 1) in vec2 uv;
 
 			void main() {
-				gl_Position = vec4(pos, 0.0, 0.0);	
+				gl_Position = vec4(pos, 0.0, 1.0);	
 			}
 		)";
 		std::string psCodeIn = str;
@@ -66,7 +71,7 @@ namespace ed {
 					float sedCurrentTime;
 				};
 				float4 main(PSInput inp) : SV_TARGET {
-					float time = sedCurrentTime + inp.Pos.x / 44100.0f;
+					float time = sedCurrentTime + (inp.Pos.x + floor(inp.Pos.y) * 1024.0f) / 44100.0f;
 					float2 v = mainSound(time);
 					return float4(v.x, v.y, 0, 0); // TODO: put 4 samples in one pixel
 				}
@@ -76,7 +81,7 @@ namespace ed {
 				out vec4 fragColor;
 				uniform float sedCurrentTime;
 				void main() {
-					float time = sedCurrentTime + gl_FragCoord.x / 44100.0f;
+					float time = sedCurrentTime + (gl_FragCoord.x + floor(gl_FragCoord.y) * 1024.0) / 44100.0f;
 					vec2 v = mainSound(time);
 					fragColor = vec4(v.x, v.y, 0, 0); // TODO: put 4 samples in one pixel
 				}
@@ -122,13 +127,16 @@ namespace ed {
 		if (getStatus() != sf::SoundSource::Status::Playing)
 			play();
 	}
-	void AudioShaderStream::renderAudio()
+	void AudioShaderStream::renderAudio(float time)
 	{
 		if (!m_needsUpdate)
 			return;
 
 		m_mutex.lock();
 
+		if (time >= 0.0f)
+			m_curTime = time;
+
 		glUseProgram(m_shader);
 		glBindFramebuffer(GL_FRAMEBUFFER, m_fbo);
 		glDrawBuffers(1, &m_fboBuffers);
@@ -155,6 +163,38 @@ namespace ed {
 
 		m_mutex.unlock();
 	}
+	int AudioShaderStream::renderOffline(float startTime, int sampleCount, float* out)
+	{
+		sampleCount = std::min<int>(sampleCount, OfflineBlockSize);
+		int rows = (sampleCount + 1023) / 1024;
+
+		// each row of the render target holds 1024 consecutive samples
+		if (m_offlineFbo == 0)
+			m_offlineFbo = gl::CreateSimpleFramebuffer(1024, OfflineBlockSize / 1024, m_offlineRt, m_offlineDepth, GL_RGBA32F);
+
+		glUseProgram(m_shader);
+		glBindFramebuffer(GL_FRAMEBUFFER, m_offlineFbo);
+		glDrawBuffers(1, &m_fboBuffers);
+		glClearBufferfi(GL_DEPTH_STENCIL, 0, 1.0f, 0);
+		glClearBufferfv(GL_COLOR, 0, glm::value_ptr(glm::vec4(0.0f, 0.0f, 0.0f, 0.0f)));
+		glViewport(0, 0, 1024, rows);
+
+		glUniform1f(m_svarCurTimeLoc, startTime);
+		glBindVertexArray(m_fsRectVAO);
+		glDrawArrays(GL_TRIANGLES, 0, 6);
+
+		m_offlinePixels.resize(1024 * rows * 4);
+		glReadBuffer(GL_COLOR_ATTACHMENT0);
+		glReadPixels(0, 0, 1024, rows, GL_RGBA, GL_FLOAT, m_offlinePixels.data());
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+		for (int s = 0; s < sampleCount; s++) {
+			out[s * 2] = m_offlinePixels[s * 4 + 0];
+			out[s * 2 + 1] = m_offlinePixels[s * 4 + 1];
+		}
+
+		return sampleCount;
+	}
 	void AudioShaderStream::onSeek(sf::Time timeOffset)
 	{
 		m_curTime = timeOffset.asSeconds();
@@ -25,7 +25,13 @@ namespace ed {
 		~AudioShaderStream();
 
 		void compileFromShaderSource(ProjectParser* project, MessageStack* msgs, const std::string& str, std::vector<ed::ShaderMacro>& macros, bool isHLSL = false);
-		void renderAudio();
+		void renderAudio(float time = -1.0f); // time < 0 -> use the stream's playing position
+
+		// render up to OfflineBlockSize samples starting at startTime in one draw call - out = interleaved stereo, returns number of samples written
+		int renderOffline(float startTime, int sampleCount, float* out);
+
+		static const int SampleRate = 44100;
+		static const int OfflineBlockSize = 1024 * 1024;
 
 		inline GLuint getShader() { return m_shader; }
 
@@ -41,5 +47,9 @@ namespace ed {
 
 		sf::Int16 m_audio[1024 * 2];
 		float m_pixels[1024 * 4];
+
+		// offline rendering - 1024 samples per row
+		GLuint m_offlineFbo, m_offlineRt, m_offlineDepth;
+		std::vector<float> m_offlinePixels;
 	};
 }
\ No newline at end of file
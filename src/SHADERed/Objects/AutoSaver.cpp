@@ -0,0 +1,198 @@
+#include <SHADERed/Objects/AutoSaver.h>
+#include <SHADERed/Objects/BinaryProject.h>
+#include <SHADERed/Objects/Logger.h>
+#include <SHADERed/Objects/Tracer.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <sstream>
+#include <stdio.h>
+#include <string.h>
+#include <string_view>
+
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace ed {
+	// write to a temporary file first so that a crash mid-write never leaves a half written recovery file
+	static bool writeDurable(const std::string& path, const char* data, size_t size)
+	{
+		std::string tempPath = path + ".tmp";
+		FILE* file = fopen(tempPath.c_str(), "wb");
+		if (file == nullptr)
+			return false;
+
+		bool ok = fwrite(data, 1, size, file) == size && fflush(file) == 0;
+#if defined(_WIN32)
+		ok = ok && _commit(_fileno(file)) == 0;
+#else
+		ok = ok && fsync(fileno(file)) == 0;
+#endif
+		fclose(file);
+
+		std::error_code errc;
+		if (ok)
+			std::filesystem::rename(tempPath, path, errc);
+		if (!ok || errc) {
+			std::filesystem::remove(tempPath, errc);
+			return false;
+		}
+
+		return true;
+	}
+
+	void ProjectSnapshot::ExportValue(pugi::xml_node& node, ShaderVariable* var, bool packed)
+	{
+		if (packed) {
+			node.append_child("packed").text().set(BinaryProject::ToHex(var->Data, ShaderVariable::GetSize(var->GetType())).c_str());
+			return;
+		}
+
+		pugi::xml_node valueRowNode = node.append_child("row");
+
+		int rowID = 0;
+		int limit = ShaderVariable::GetSize(var->GetType()) / 4;
+		for (int i = 0; i < limit; i++) {
+			if (var->GetType() >= ShaderVariable::ValueType::Boolean1 && var->GetType() <= ShaderVariable::ValueType::Boolean4)
+				valueRowNode.append_child("value").text().set(var->AsBoolean(i));
+			else if (var->GetType() >= ShaderVariable::ValueType::Integer1 && var->GetType() <= ShaderVariable::ValueType::Integer4)
+				valueRowNode.append_child("value").text().set(var->AsInteger(i));
+			else
+				valueRowNode.append_child("value").text().set(var->AsFloat(i % var->GetColumnCount(), rowID));
+
+			if ((i + 1) % var->GetColumnCount() == 0 && i != 0 && i != limit - 1) {
+				valueRowNode = node.append_child("row");
+				rowID++;
+			}
+		}
+	}
+
+	AutoSaver::AutoSaver()
+	{
+		m_pending = nullptr;
+		m_running = true;
+		m_busy = false;
+		m_thread = new std::thread(&AutoSaver::m_run, this);
+	}
+	AutoSaver::~AutoSaver()
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_running = false;
+		}
+		m_wake.notify_one();
+
+		m_thread->join();
+		delete m_thread;
+		delete m_pending;
+	}
+	void AutoSaver::Submit(ProjectSnapshot* snapshot)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+
+			// every snapshot holds all of the buffers, the older one isn't needed anymore
+			delete m_pending;
+			m_pending = snapshot;
+		}
+		m_wake.notify_one();
+	}
+	void AutoSaver::Discard()
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+
+		delete m_pending;
+		m_pending = nullptr;
+
+		m_idle.wait(lock, [&]() { return !m_busy; });
+		m_bufferHashes.clear();
+	}
+	void AutoSaver::SetBufferHash(const std::string& path, size_t hash)
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_bufferHashes[path] = hash;
+	}
+
+	void AutoSaver::m_run()
+	{
+		while (true) {
+			ProjectSnapshot* snapshot = nullptr;
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_wake.wait(lock, [&]() { return m_pending != nullptr || !m_running; });
+				if (!m_running)
+					break;
+
+				snapshot = m_pending;
+				m_pending = nullptr;
+				m_busy = true;
+			}
+
+			m_write(snapshot);
+			delete snapshot;
+
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_busy = false;
+			}
+			m_idle.notify_all();
+		}
+	}
+	void AutoSaver::m_write(ProjectSnapshot* snapshot)
+	{
+		TraceScope trace("Project", "Write recovery file", snapshot->File);
+
+		for (const auto& value : snapshot->Values) {
+			ShaderVariable var(value.Type);
+			memcpy(var.Data, value.Data.data(), std::min<size_t>(value.Data.size(), ShaderVariable::GetSize(value.Type)));
+
+			pugi::xml_node node = value.Node;
+			ProjectSnapshot::ExportValue(node, &var, snapshot->Binary);
+			free(var.Data);
+		}
+
+		// buffers first - the project file should never point to buffers that aren't there yet
+		for (const auto& buffer : snapshot->Buffers) {
+			size_t hash = std::hash<std::string_view>()(std::string_view(buffer.Data.data(), buffer.Data.size()));
+
+			// skip the buffers that didn't change since they were last written (as a recovery buffer or by a save)
+			bool unchanged = false;
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				auto written = m_bufferHashes.find(buffer.Path);
+				if (written != m_bufferHashes.end())
+					unchanged = written->second == hash && std::filesystem::exists(buffer.Path);
+				else
+					unchanged = buffer.HasSavedHash && buffer.SavedHash == hash;
+			}
+			if (unchanged)
+				continue;
+
+			std::error_code errc;
+			std::filesystem::create_directories(std::filesystem::path(buffer.Path).parent_path(), errc);
+
+			if (writeDurable(buffer.Path, buffer.Data.data(), buffer.Data.size())) {
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_bufferHashes[buffer.Path] = hash;
+			} else
+				Logger::Get().Log(Logger::Category::Project, Logger::Level::Error, "Failed to write the recovery buffer " + buffer.Path);
+		}
+
+		std::string data;
+		if (snapshot->Binary)
+			BinaryProject::Encode(snapshot->Document, data);
+		else {
+			std::ostringstream stream;
+			snapshot->Document.save(stream);
+			data = stream.str();
+		}
+
+		if (writeDurable(snapshot->File, data.data(), data.size()))
+			Logger::Get().Log(Logger::Category::Project, Logger::Level::Info, "Saved recovery file " + snapshot->File);
+		else
+			Logger::Get().Log(Logger::Category::Project, Logger::Level::Error, "Failed to write the recovery file " + snapshot->File);
+	}
+}
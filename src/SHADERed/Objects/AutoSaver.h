@@ -0,0 +1,66 @@
+#pragma once
+#include <SHADERed/Objects/ShaderVariable.h>
+#include <pugixml/src/pugixml.hpp>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace ed {
+	// everything a recovery save needs, copied out of the project on the main thread
+	struct ProjectSnapshot {
+		// raw value of a variable, formatted into Node on the AutoSaver thread
+		struct Value {
+			pugi::xml_node Node;
+			ShaderVariable::ValueType Type;
+			std::vector<char> Data;
+		};
+		// raw contents of a buffer, only written if it differs from the file on the disk
+		struct Buffer {
+			std::string Path; // .buf.recovery file
+			std::vector<char> Data;
+			bool HasSavedHash;
+			size_t SavedHash; // hash of the .buf written by the last save
+		};
+
+		std::string File; // recovery project file
+		bool Binary;
+		pugi::xml_document Document; // project structure, without the values
+		std::vector<Value> Values;
+		std::vector<Buffer> Buffers;
+
+		// <row><value>...</value></row> nodes (or hex when packed) for a variable without a function
+		static void ExportValue(pugi::xml_node& node, ShaderVariable* var, bool packed);
+	};
+
+	/* Finishes project snapshots on a background thread: formats the variable values,
+	   hashes the buffers, serializes the document, writes to a temporary file, fsyncs and
+	   renames it over the previous recovery file. Only one snapshot waits at a time - a
+	   newer one replaces it. */
+	class AutoSaver {
+	public:
+		AutoSaver();
+		~AutoSaver();
+
+		void Submit(ProjectSnapshot* snapshot); // takes the ownership
+
+		// the recovery buffer at path already holds data with this hash (restored from the disk)
+		void SetBufferHash(const std::string& path, size_t hash);
+
+		// drops the snapshot that wasn't written yet and waits for the current write to finish
+		void Discard();
+
+	private:
+		void m_run();
+		void m_write(ProjectSnapshot* snapshot);
+
+		std::thread* m_thread;
+		std::mutex m_mutex;
+		std::condition_variable m_wake, m_idle;
+		ProjectSnapshot* m_pending;
+		bool m_running, m_busy;
+		std::unordered_map<std::string, size_t> m_bufferHashes; // recovery buffer path -> hash of its contents
+	};
+}
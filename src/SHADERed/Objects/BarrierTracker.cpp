@@ -0,0 +1,81 @@
+#include <SHADERed/Objects/BarrierTracker.h>
+
+namespace ed {
+	// every way the rest of the app can read a buffer / an image after a shader wrote it
+	static const GLbitfield BufferAccessBits = GL_SHADER_STORAGE_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT | GL_ELEMENT_ARRAY_BARRIER_BIT | GL_UNIFORM_BARRIER_BIT | GL_COMMAND_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT | GL_PIXEL_BUFFER_BARRIER_BIT;
+	static const GLbitfield ImageAccessBits = GL_SHADER_IMAGE_ACCESS_BARRIER_BIT | GL_TEXTURE_FETCH_BARRIER_BIT | GL_TEXTURE_UPDATE_BARRIER_BIT | GL_FRAMEBUFFER_BARRIER_BIT;
+
+	BarrierTracker::BarrierTracker()
+	{
+		m_required = 0;
+		m_barriers = m_skipped = 0;
+		m_lastBarriers = m_lastSkipped = 0;
+	}
+
+	void BarrierTracker::Write(GLuint id, bool image)
+	{
+		if (id == 0)
+			return;
+
+		m_pending[m_key(id, image)] = image ? ImageAccessBits : BufferAccessBits;
+	}
+	void BarrierTracker::Read(GLuint id, bool image, GLbitfield access)
+	{
+		if (m_pending.empty())
+			return;
+
+		auto it = m_pending.find(m_key(id, image));
+		if (it != m_pending.end())
+			m_required |= it->second & access;
+	}
+	void BarrierTracker::Flush()
+	{
+		if (m_required == 0) {
+			if (!m_pending.empty())
+				m_skipped++;
+			return;
+		}
+
+		m_issue(m_required);
+		m_required = 0;
+	}
+	void BarrierTracker::FlushAll()
+	{
+		GLbitfield bits = 0;
+		for (const auto& pair : m_pending)
+			bits |= pair.second;
+
+		m_required = 0;
+		if (bits != 0)
+			m_issue(bits);
+		m_pending.clear();
+	}
+	void BarrierTracker::Clear()
+	{
+		m_pending.clear();
+		m_required = 0;
+	}
+	void BarrierTracker::EndFrame()
+	{
+		FlushAll();
+
+		m_lastBarriers = m_barriers;
+		m_lastSkipped = m_skipped;
+		m_barriers = m_skipped = 0;
+	}
+
+	void BarrierTracker::m_issue(GLbitfield bits)
+	{
+		glMemoryBarrier(bits);
+		m_barriers++;
+
+		// a barrier covers every write issued before it, not only the ones that asked for it
+		for (auto it = m_pending.begin(); it != m_pending.end();) {
+			it->second &= ~bits;
+			if (it->second == 0)
+				it = m_pending.erase(it);
+			else
+				++it;
+		}
+	}
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <unordered_map>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+#include <GL/glew.h>
+#if defined(__APPLE__)
+#include <OpenGL/gl.h>
+#else
+#include <GL/gl.h>
+#endif
+
+namespace ed {
+	/* Remembers which buffers & images compute passes wrote to and which kinds of access
+	   still can't see those writes. Passes report what they read before they run and only
+	   the barrier bits for resources that are actually pending get issued - dispatches that
+	   don't touch each other's resources run back to back without any barrier. */
+	class BarrierTracker {
+	public:
+		BarrierTracker();
+
+		// a dispatch wrote to this resource (both reads & writes are possible through a binding)
+		void Write(GLuint id, bool image);
+
+		// the next pass accesses this resource through the given barrier bit
+		void Read(GLuint id, bool image, GLbitfield access);
+
+		// issue the bits collected by Read()
+		void Flush();
+
+		// make every pending write visible - used before code we can't inspect & at the end of the frame
+		void FlushAll();
+
+		void Clear();
+
+		// barriers issued / dispatches that didn't need one during the last frame
+		inline int GetBarrierCount() { return m_lastBarriers; }
+		inline int GetSkippedCount() { return m_lastSkipped; }
+		void EndFrame();
+
+	private:
+		inline unsigned long long m_key(GLuint id, bool image) { return ((unsigned long long)id << 1) | image; }
+		void m_issue(GLbitfield bits);
+
+		std::unordered_map<unsigned long long, GLbitfield> m_pending; // resource -> access types that don't see the last write yet
+		GLbitfield m_required;
+		int m_barriers, m_skipped;
+		int m_lastBarriers, m_lastSkipped;
+	};
+}
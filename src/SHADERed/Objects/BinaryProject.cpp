@@ -0,0 +1,324 @@
+#include <SHADERed/Objects/BinaryProject.h>
+#include <SHADERed/Objects/Logger.h>
+
+#include <fstream>
+#include <string.h>
+#include <unordered_map>
+#include <vector>
+
+namespace ed {
+	const char BinaryProject::Signature[8] = { 'S', 'H', 'D', 'R', 'P', 'R', 'J', 'B' };
+	const char* BinaryProject::Extension = ".sprjb";
+
+	namespace {
+		// explicit record ids so that the format doesn't depend on pugi::xml_node_type
+		enum class Record : unsigned char {
+			End, // closes a child list
+			Element,
+			PCData,
+			CData,
+			Comment,
+			PI,
+			Declaration,
+			Doctype
+		};
+		const int MaxDepth = 256;
+
+		struct Writer {
+			std::string Body;
+			std::vector<const char*> Names;
+			std::unordered_map<std::string, unsigned int> NameIDs;
+		};
+		struct Reader {
+			const char* Pos;
+			const char* End;
+			std::vector<const char*> Names;
+		};
+
+		void writeVarint(std::string& out, unsigned int val)
+		{
+			while (val >= 0x80) {
+				out.push_back((char)(val | 0x80));
+				val >>= 7;
+			}
+			out.push_back((char)val);
+		}
+		void writeString(std::string& out, const char* str)
+		{
+			out.append(str);
+			out.push_back(0);
+		}
+		void writeName(Writer& out, const char* name)
+		{
+			auto it = out.NameIDs.find(name);
+			if (it == out.NameIDs.end()) {
+				it = out.NameIDs.insert(std::make_pair(std::string(name), (unsigned int)out.Names.size())).first;
+				out.Names.push_back(it->first.c_str());
+			}
+			writeVarint(out.Body, it->second);
+		}
+		void writeAttributes(Writer& out, const pugi::xml_node& node)
+		{
+			unsigned int count = 0;
+			for (pugi::xml_attribute attr = node.first_attribute(); attr; attr = attr.next_attribute())
+				count++;
+
+			writeVarint(out.Body, count);
+			for (pugi::xml_attribute attr = node.first_attribute(); attr; attr = attr.next_attribute()) {
+				writeName(out, attr.name());
+				writeString(out.Body, attr.value());
+			}
+		}
+		void writeChildren(Writer& out, const pugi::xml_node& parent)
+		{
+			for (pugi::xml_node node = parent.first_child(); node; node = node.next_sibling()) {
+				switch (node.type()) {
+				case pugi::node_element:
+					out.Body.push_back((char)Record::Element);
+					writeName(out, node.name());
+					writeAttributes(out, node);
+					writeChildren(out, node);
+					break;
+				case pugi::node_declaration:
+					out.Body.push_back((char)Record::Declaration);
+					writeName(out, node.name());
+					writeAttributes(out, node);
+					break;
+				case pugi::node_pi:
+					out.Body.push_back((char)Record::PI);
+					writeName(out, node.name());
+					writeString(out.Body, node.value());
+					break;
+				case pugi::node_pcdata:
+					out.Body.push_back((char)Record::PCData);
+					writeString(out.Body, node.value());
+					break;
+				case pugi::node_cdata:
+					out.Body.push_back((char)Record::CData);
+					writeString(out.Body, node.value());
+					break;
+				case pugi::node_comment:
+					out.Body.push_back((char)Record::Comment);
+					writeString(out.Body, node.value());
+					break;
+				case pugi::node_doctype:
+					out.Body.push_back((char)Record::Doctype);
+					writeString(out.Body, node.value());
+					break;
+				default: break;
+				}
+			}
+			out.Body.push_back((char)Record::End);
+		}
+
+		bool readVarint(Reader& in, unsigned int& val)
+		{
+			val = 0;
+			for (int shift = 0; shift < 35; shift += 7) {
+				if (in.Pos >= in.End)
+					return false;
+
+				unsigned char byte = (unsigned char)*in.Pos++;
+				val |= (unsigned int)(byte & 0x7F) << shift;
+				if ((byte & 0x80) == 0)
+					return true;
+			}
+			return false;
+		}
+		const char* readString(Reader& in)
+		{
+			const char* str = in.Pos;
+			const char* term = (const char*)memchr(in.Pos, 0, in.End - in.Pos);
+			if (term == nullptr)
+				return nullptr;
+
+			in.Pos = term + 1;
+			return str;
+		}
+		const char* readName(Reader& in)
+		{
+			unsigned int id = 0;
+			if (!readVarint(in, id) || id >= in.Names.size())
+				return nullptr;
+			return in.Names[id];
+		}
+		bool readAttributes(Reader& in, pugi::xml_node& node)
+		{
+			unsigned int count = 0;
+			if (!readVarint(in, count))
+				return false;
+
+			for (unsigned int i = 0; i < count; i++) {
+				const char* name = readName(in);
+				const char* value = name ? readString(in) : nullptr;
+				if (value == nullptr)
+					return false;
+
+				node.append_attribute(name).set_value(value);
+			}
+			return true;
+		}
+		bool readChildren(Reader& in, pugi::xml_node& parent, int depth)
+		{
+			if (depth > MaxDepth)
+				return false;
+
+			while (in.Pos < in.End) {
+				Record type = (Record)*in.Pos++;
+				if (type == Record::End)
+					return true;
+
+				if (type == Record::Element || type == Record::Declaration) {
+					const char* name = readName(in);
+					if (name == nullptr)
+						return false;
+
+					pugi::xml_node node = parent.append_child(type == Record::Element ? pugi::node_element : pugi::node_declaration);
+					node.set_name(name);
+
+					if (!readAttributes(in, node))
+						return false;
+					if (type == Record::Element && !readChildren(in, node, depth + 1))
+						return false;
+				} else if (type == Record::PI) {
+					const char* name = readName(in);
+					const char* value = name ? readString(in) : nullptr;
+					if (value == nullptr)
+						return false;
+
+					pugi::xml_node node = parent.append_child(pugi::node_pi);
+					node.set_name(name);
+					node.set_value(value);
+				} else {
+					pugi::xml_node_type nodeType = pugi::node_null;
+					switch (type) {
+					case Record::PCData: nodeType = pugi::node_pcdata; break;
+					case Record::CData: nodeType = pugi::node_cdata; break;
+					case Record::Comment: nodeType = pugi::node_comment; break;
+					case Record::Doctype: nodeType = pugi::node_doctype; break;
+					default: return false;
+					}
+
+					const char* value = readString(in);
+					if (value == nullptr)
+						return false;
+
+					parent.append_child(nodeType).set_value(value);
+				}
+			}
+
+			return false; // missing the End record
+		}
+	}
+
+	bool BinaryProject::IsBinary(const std::string& file)
+	{
+		std::ifstream in(file, std::ios::binary);
+		char sig[sizeof(Signature)] = { 0 };
+		if (!in.read(sig, sizeof(sig)))
+			return false;
+
+		return memcmp(sig, Signature, sizeof(Signature)) == 0;
+	}
+	bool BinaryProject::HasBinaryExtension(const std::string& file)
+	{
+		size_t extLen = strlen(Extension);
+		return file.size() >= extLen && file.compare(file.size() - extLen, extLen, Extension) == 0;
+	}
+	bool BinaryProject::Load(const std::string& file, pugi::xml_document& doc)
+	{
+		std::ifstream in(file, std::ios::binary | std::ios::ate);
+		if (!in.is_open())
+			return false;
+
+		std::vector<char> data((size_t)in.tellg());
+		in.seekg(0, std::ios::beg);
+		if (!in.read(data.data(), data.size()) || data.size() < sizeof(Signature) || memcmp(data.data(), Signature, sizeof(Signature)) != 0)
+			return false;
+
+		Reader reader;
+		reader.Pos = data.data() + sizeof(Signature);
+		reader.End = data.data() + data.size();
+
+		unsigned int version = 0, nameCount = 0;
+		if (!readVarint(reader, version) || version > Version) {
+			Logger::Get().Log(Logger::Category::Project, Logger::Level::Error, "Binary project was saved by a newer version of SHADERed (format " + std::to_string(version) + ")");
+			return false;
+		}
+		if (!readVarint(reader, nameCount))
+			return false;
+
+		reader.Names.reserve(nameCount);
+		for (unsigned int i = 0; i < nameCount; i++) {
+			const char* name = readString(reader);
+			if (name == nullptr)
+				return false;
+			reader.Names.push_back(name);
+		}
+
+		doc.reset();
+		if (!readChildren(reader, doc, 0) || reader.Pos != reader.End) {
+			Logger::Get().Log(Logger::Category::Project, Logger::Level::Error, "Binary project file is corrupted");
+			doc.reset();
+			return false;
+		}
+
+		return true;
+	}
+	bool BinaryProject::Save(const std::string& file, const pugi::xml_document& doc)
+	{
+		std::string data;
+		Encode(doc, data);
+
+		std::ofstream out(file, std::ios::binary | std::ios::trunc);
+		out.write(data.data(), data.size());
+		out.close();
+
+		return !out.fail();
+	}
+	void BinaryProject::Encode(const pugi::xml_document& doc, std::string& out)
+	{
+		Writer writer;
+		writer.Body.reserve(64 * 1024);
+		writeChildren(writer, doc);
+
+		out.assign(Signature, sizeof(Signature));
+		writeVarint(out, Version);
+		writeVarint(out, (unsigned int)writer.Names.size());
+		for (const char* name : writer.Names)
+			writeString(out, name);
+		out.append(writer.Body);
+	}
+
+	std::string BinaryProject::ToHex(const void* data, size_t size)
+	{
+		static const char digits[] = "0123456789abcdef";
+
+		const unsigned char* bytes = (const unsigned char*)data;
+		std::string ret(size * 2, '0');
+		for (size_t i = 0; i < size; i++) {
+			ret[i * 2 + 0] = digits[bytes[i] >> 4];
+			ret[i * 2 + 1] = digits[bytes[i] & 0xF];
+		}
+
+		return ret;
+	}
+	bool BinaryProject::FromHex(const char* text, void* data, size_t size)
+	{
+		auto nibble = [](char c) -> int {
+			if (c >= '0' && c <= '9') return c - '0';
+			if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+			return c - 'A' + 10;
+		};
+
+		// validate first so that the output isn't left half written
+		if (strlen(text) != size * 2 || strspn(text, "0123456789abcdefABCDEF") != size * 2)
+			return false;
+
+		unsigned char* bytes = (unsigned char*)data;
+		for (size_t i = 0; i < size; i++)
+			bytes[i] = (unsigned char)((nibble(text[i * 2]) << 4) | nibble(text[i * 2 + 1]));
+
+		return true;
+	}
+}
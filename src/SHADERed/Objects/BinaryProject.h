@@ -0,0 +1,28 @@
+#pragma once
+#include <pugixml/src/pugixml.hpp>
+#include <string>
+
+namespace ed {
+	/* Compact binary encoding of a project document (.sprjb). It stores the same
+	   pugixml tree as a .sprj file, so both formats convert into each other without loss:
+	   - element & attribute names are written once in a table and referenced by index
+	   - values are null terminated, so reading them needs no unescaping or tokenizing (pugixml still copies each one)
+	   - no indentation or entity escaping */
+	class BinaryProject {
+	public:
+		static const char Signature[8];
+		static const unsigned int Version = 1;
+		static const char* Extension; // ".sprjb"
+
+		static bool IsBinary(const std::string& file); // checks the file signature, not the extension
+		static bool HasBinaryExtension(const std::string& file);
+
+		static bool Load(const std::string& file, pugi::xml_document& doc);
+		static bool Save(const std::string& file, const pugi::xml_document& doc);
+		static void Encode(const pugi::xml_document& doc, std::string& out);
+
+		// raw bytes <-> hex text, used for packed variable values
+		static std::string ToHex(const void* data, size_t size);
+		static bool FromHex(const char* text, void* data, size_t size);
+	};
+}
@@ -1,5 +1,6 @@
 #include <SHADERed/Objects/CommandLineOptionParser.h>
 #include <string.h>
+#include <algorithm>
 #include <filesystem>
 #include <vector>
 
@@ -12,7 +13,20 @@ namespace ed {
 		PerformanceMode = false;
 		LaunchUI = true;
 		ProjectFile = "";
+		TraceFile = "";
 		WindowWidth = WindowHeight = 0;
+		ExportAudioFile = "";
+		ExportSequenceFile = "";
+		ExportEncoder = "ffmpeg -y -loglevel error -f yuv4mpegpipe -i - -pix_fmt yuv420p %s";
+		ExportDuration = 10.0f;
+		ExportFPS = 30;
+		ExportWidth = 1920;
+		ExportHeight = 1080;
+		ExportSupersample = 1;
+		ExportTileSize = 0;
+		ExportFrameStart = 0;
+		ExportFrameEnd = -1;
+		ExportWorkers = 1;
 	}
 	void CommandLineOptionParser::Parse(const std::filesystem::path& cmdDir, int argc, char* argv[])
 	{
@@ -51,6 +65,84 @@ namespace ed {
 			else if (strcmp(argv[i], "--performance") == 0 || strcmp(argv[i], "-p") == 0) {
 				PerformanceMode = true;
 			}
+			// --export-audio, -ea [file]
+			else if (strcmp(argv[i], "--export-audio") == 0 || strcmp(argv[i], "-ea") == 0) {
+				if (i + 1 < argc) {
+					ExportAudioFile = (cmdDir / argv[i + 1]).generic_string();
+					i++;
+				}
+			}
+			// --duration, -d [seconds]
+			else if (strcmp(argv[i], "--duration") == 0 || strcmp(argv[i], "-d") == 0) {
+				if (i + 1 < argc) {
+					ExportDuration = atof(argv[i + 1]);
+					i++;
+				}
+			}
+			// --export-sequence, -es [file]
+			else if (strcmp(argv[i], "--export-sequence") == 0 || strcmp(argv[i], "-es") == 0) {
+				if (i + 1 < argc) {
+					ExportSequenceFile = (cmdDir / argv[i + 1]).generic_string();
+					i++;
+				}
+			}
+			// --fps [fps]
+			else if (strcmp(argv[i], "--fps") == 0) {
+				if (i + 1 < argc) {
+					ExportFPS = std::max(1, atoi(argv[i + 1]));
+					i++;
+				}
+			}
+			// --size [width]x[height]
+			else if (strcmp(argv[i], "--size") == 0) {
+				if (i + 1 < argc) {
+					sscanf(argv[i + 1], "%dx%d", &ExportWidth, &ExportHeight);
+					i++;
+				}
+			}
+			// --supersample, -ss [1|2|4|8]
+			else if (strcmp(argv[i], "--supersample") == 0 || strcmp(argv[i], "-ss") == 0) {
+				if (i + 1 < argc) {
+					ExportSupersample = std::max(1, atoi(argv[i + 1]));
+					i++;
+				}
+			}
+			// --tiles [size]
+			else if (strcmp(argv[i], "--tiles") == 0) {
+				if (i + 1 < argc) {
+					ExportTileSize = std::max(0, atoi(argv[i + 1]));
+					i++;
+				}
+			}
+			// --frames [start] [end]
+			else if (strcmp(argv[i], "--frames") == 0) {
+				if (i + 2 < argc) {
+					ExportFrameStart = atoi(argv[i + 1]);
+					ExportFrameEnd = atoi(argv[i + 2]);
+					i += 2;
+				}
+			}
+			// --workers, -w [count]
+			else if (strcmp(argv[i], "--workers") == 0 || strcmp(argv[i], "-w") == 0) {
+				if (i + 1 < argc) {
+					ExportWorkers = std::max(1, atoi(argv[i + 1]));
+					i++;
+				}
+			}
+			// --encoder [command]
+			else if (strcmp(argv[i], "--encoder") == 0) {
+				if (i + 1 < argc) {
+					ExportEncoder = argv[i + 1];
+					i++;
+				}
+			}
+			// --trace [file]
+			else if (strcmp(argv[i], "--trace") == 0) {
+				if (i + 1 < argc) {
+					TraceFile = (cmdDir / argv[i + 1]).generic_string();
+					i++;
+				}
+			}
 			// --help, -h
 			else if (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0) {
 				static const std::vector<std::pair<std::string, std::string>> opts = {
@@ -61,6 +153,17 @@ namespace ed {
 					{ "--fullscreen | -fs", "launch SHADERed in fullscreen mode" },
 					{ "--maxmimized | -max", "maximize SHADERed's window" },
 					{ "--performance | -p", "launch SHADERed in performance mode" },
+					{ "--export-audio | -ea [file]", "render the project's audio passes to a .wav/.flac/.ogg file and exit" },
+					{ "--duration | -d [seconds]", "length of the exported audio or sequence (default: 10s)" },
+					{ "--export-sequence | -es [file]", "render a sequence of images (use %d in the name) or a video and exit" },
+					{ "--fps [fps]", "frame rate of the exported sequence (default: 30)" },
+					{ "--size [width]x[height]", "size of the exported sequence (default: 1920x1080)" },
+					{ "--supersample | -ss [1|2|4|8]", "supersampling of the exported sequence" },
+					{ "--tiles [size]", "render the exported sequence in size x size tiles" },
+					{ "--frames [start] [end]", "export only the frames in [start, end)" },
+					{ "--workers | -w [count]", "split the exported sequence between multiple processes" },
+					{ "--encoder [command]", "video encoder command, %s is replaced with the (quoted) output file" },
+					{ "--trace [file]", "write project loading and shader compilation timings as Chrome trace JSON" },
 				};
 
 				int maxSize = 0;
@@ -17,5 +17,20 @@ namespace ed {
 		int WindowWidth, WindowHeight;
 		bool MinimalMode;
 		std::string ProjectFile;
+		std::string TraceFile; // Chrome trace JSON with project loading / shader compilation timings
+
+		// headless tasks - executed without entering the main loop
+		std::string ExportAudioFile;
+		std::string ExportSequenceFile;
+		std::string ExportEncoder;
+		float ExportDuration;
+		int ExportFPS;
+		int ExportWidth, ExportHeight;
+		int ExportSupersample;
+		int ExportTileSize;
+		int ExportFrameStart, ExportFrameEnd; // ExportFrameEnd < 0 -> calculate from ExportDuration
+		int ExportWorkers;
+
+		inline bool IsHeadless() { return !ExportAudioFile.empty() || !ExportSequenceFile.empty(); }
 	};
 }
\ No newline at end of file
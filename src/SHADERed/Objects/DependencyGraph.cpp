@@ -0,0 +1,134 @@
+#include <SHADERed/Objects/DependencyGraph.h>
+
+#include <filesystem>
+
+namespace ed {
+	struct DependencyRecording {
+		std::string Item;
+		std::unordered_set<std::string> Files;
+	};
+	static thread_local std::vector<DependencyRecording> recordingStack;
+
+	DependencyGraph::DependencyGraph()
+	{
+		m_version = 0;
+	}
+
+	void DependencyGraph::BeginItem(const std::string& item)
+	{
+		DependencyRecording rec;
+		rec.Item = item;
+		recordingStack.push_back(rec);
+	}
+	void DependencyGraph::AddFile(const std::string& path)
+	{
+		if (recordingStack.empty() || path.empty())
+			return;
+
+		recordingStack.back().Files.insert(Normalize(path));
+	}
+	void DependencyGraph::EndItem()
+	{
+		if (recordingStack.empty())
+			return;
+
+		DependencyRecording rec = std::move(recordingStack.back());
+		recordingStack.pop_back();
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		auto it = m_files.find(rec.Item);
+		if (it != m_files.end() && it->second == rec.Files)
+			return;
+
+		m_unlink(rec.Item);
+		for (const auto& file : rec.Files)
+			m_dependents[file].insert(rec.Item);
+		m_files[rec.Item] = std::move(rec.Files);
+
+		m_version++;
+	}
+
+	void DependencyGraph::RenameItem(const std::string& item, const std::string& newName)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		auto it = m_files.find(item);
+		if (it == m_files.end())
+			return;
+
+		std::unordered_set<std::string> files = std::move(it->second);
+		m_unlink(item);
+
+		for (const auto& file : files)
+			m_dependents[file].insert(newName);
+		m_files[newName] = std::move(files);
+	}
+	void DependencyGraph::RemoveItem(const std::string& item)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (m_files.count(item) == 0)
+			return;
+
+		m_unlink(item);
+		m_version++;
+	}
+	void DependencyGraph::Clear()
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_files.clear();
+		m_dependents.clear();
+		m_version++;
+	}
+
+	std::vector<std::string> DependencyGraph::GetDependents(const std::string& path)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		auto it = m_dependents.find(Normalize(path));
+		if (it == m_dependents.end())
+			return std::vector<std::string>();
+
+		return std::vector<std::string>(it->second.begin(), it->second.end());
+	}
+	std::vector<std::string> DependencyGraph::GetFiles()
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		std::vector<std::string> ret;
+		ret.reserve(m_dependents.size());
+		for (const auto& dep : m_dependents)
+			ret.push_back(dep.first);
+
+		return ret;
+	}
+
+	std::string DependencyGraph::Normalize(const std::string& path)
+	{
+		std::error_code errCode;
+		std::filesystem::path ret = std::filesystem::weakly_canonical(path, errCode);
+		if (errCode)
+			ret = std::filesystem::absolute(path, errCode).lexically_normal();
+
+		return ret.generic_string();
+	}
+
+	void DependencyGraph::m_unlink(const std::string& item)
+	{
+		auto it = m_files.find(item);
+		if (it == m_files.end())
+			return;
+
+		for (const auto& file : it->second) {
+			auto dep = m_dependents.find(file);
+			if (dep == m_dependents.end())
+				continue;
+
+			dep->second.erase(item);
+			if (dep->second.empty())
+				m_dependents.erase(dep);
+		}
+
+		m_files.erase(it);
+	}
+}
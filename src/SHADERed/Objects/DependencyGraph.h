@@ -0,0 +1,49 @@
+#pragma once
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace ed {
+	/* Files that each pipeline item was built from (its shader files and everything they #include)
+	   together with the reverse mapping, so that a changed file can be traced back to the
+	   passes that need to be recompiled. Recording is done per thread between BeginItem() and EndItem(). */
+	class DependencyGraph {
+	public:
+		DependencyGraph();
+
+		static DependencyGraph& Instance()
+		{
+			static DependencyGraph ret;
+			return ret;
+		}
+
+		// all files added until EndItem() replace the item's previous file set
+		void BeginItem(const std::string& item);
+		void AddFile(const std::string& path);
+		void EndItem();
+
+		void RenameItem(const std::string& item, const std::string& newName);
+		void RemoveItem(const std::string& item);
+		void Clear();
+
+		// items that have to be rebuilt when the given file changes
+		std::vector<std::string> GetDependents(const std::string& path);
+		std::vector<std::string> GetFiles();
+
+		// incremented whenever the set of files changes
+		inline unsigned int GetVersion() { return m_version; }
+
+		static std::string Normalize(const std::string& path);
+
+	private:
+		void m_unlink(const std::string& item);
+
+		std::mutex m_mutex;
+		std::atomic<unsigned int> m_version;
+		std::unordered_map<std::string, std::unordered_set<std::string>> m_files;	  // item -> files
+		std::unordered_map<std::string, std::unordered_set<std::string>> m_dependents; // file -> items
+	};
+}
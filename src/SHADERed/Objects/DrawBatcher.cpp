@@ -0,0 +1,324 @@
+#include <SHADERed/Engine/GLUtils.h>
+#include <SHADERed/Engine/GeometryFactory.h>
+#include <SHADERed/Engine/Model.h>
+#include <SHADERed/Objects/DrawBatcher.h>
+#include <SHADERed/Objects/GLState.h>
+#include <SHADERed/Objects/SystemVariableManager.h>
+
+#include <string.h>
+
+namespace ed {
+	static const GLsizeiptr BatchVertexSize = 18 * sizeof(GLfloat); // same layout for geometry & models
+
+	struct DrawArraysIndirectCommand {
+		GLuint Count;
+		GLuint InstanceCount;
+		GLuint First;
+		GLuint BaseInstance;
+	};
+	struct DrawElementsIndirectCommand {
+		GLuint Count;
+		GLuint InstanceCount;
+		GLuint FirstIndex;
+		GLint BaseVertex;
+		GLuint BaseInstance;
+	};
+
+	static size_t floatBits(float val)
+	{
+		unsigned int ret = 0;
+		memcpy(&ret, &val, sizeof(val));
+		return ret;
+	}
+
+	DrawBatcher::DrawBatcher()
+	{
+	}
+	DrawBatcher::~DrawBatcher()
+	{
+		Clear();
+	}
+
+	bool DrawBatcher::IsSupported()
+	{
+		return GLEW_VERSION_4_3 || (GLEW_ARB_shader_storage_buffer_object && GLEW_ARB_multi_draw_indirect && GLEW_ARB_base_instance);
+	}
+	bool DrawBatcher::CanBatch(pipe::ShaderPass* pass)
+	{
+		if (!pass->Batch || !IsSupported())
+			return false;
+
+		// GeometryTransform is read from the transform buffer (the uniform holds the first item's value)
+		for (ShaderVariable* var : pass->Variables.GetVariables()) {
+			if (var->System == SystemShaderVariable::IsPicked || var->System == SystemShaderVariable::PluginVariable)
+				return false;
+			if (var->Function == FunctionShaderVariable::PluginFunction)
+				return false;
+		}
+
+		return true;
+	}
+	bool DrawBatcher::IsBatchable(PipelineItem* item)
+	{
+		if (item->Type == PipelineItem::ItemType::Geometry) {
+			pipe::GeometryItem* geo = (pipe::GeometryItem*)item->Data;
+			return !geo->Instanced && geo->VBO != 0 && geo->Type != pipe::GeometryItem::ScreenQuadNDC; // NDC quad has its own vertex format
+		} else if (item->Type == PipelineItem::ItemType::Model) {
+			pipe::Model* model = (pipe::Model*)item->Data;
+			return !model->Instanced && model->Data != nullptr && !model->Data->Meshes.empty();
+		}
+
+		return false;
+	}
+	bool DrawBatcher::IsCompatible(PipelineItem* a, PipelineItem* b)
+	{
+		if (a->Type != b->Type)
+			return false;
+
+		if (a->Type == PipelineItem::ItemType::Geometry)
+			return ((pipe::GeometryItem*)a->Data)->Topology == ((pipe::GeometryItem*)b->Data)->Topology;
+
+		return true;
+	}
+
+	void DrawBatcher::Draw(pipe::ShaderPass* pass, int run, PipelineItem** items, int count)
+	{
+		std::vector<Batch>& batches = m_batches[pass];
+		if (batches.size() <= run)
+			batches.resize(run + 1);
+
+		Batch& batch = batches[run];
+
+		// rebuild only when the items, their buffers or the input layout change
+		m_getSignature(pass, items, count, m_sigTemp);
+		if (m_sigTemp != batch.Signature) {
+			m_build(batch, pass, items, count);
+			batch.Signature = m_sigTemp;
+		}
+
+		if (batch.DrawCount == 0)
+			return;
+
+		// items move around - only upload the transforms when they change
+		SystemVariableManager& systemVM = SystemVariableManager::Instance();
+		m_transformTemp.resize(batch.InstanceItems.size());
+		for (int i = 0; i < batch.InstanceItems.size(); i++)
+			m_transformTemp[i] = systemVM.GetGeometryTransform(items[batch.InstanceItems[i]]);
+
+		if (m_transformTemp != batch.TransformData) {
+			glBindBuffer(GL_SHADER_STORAGE_BUFFER, batch.Transforms);
+			glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, m_transformTemp.size() * sizeof(glm::mat4), m_transformTemp.data());
+			glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+			batch.TransformData = m_transformTemp;
+		}
+
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, TransformBinding, batch.Transforms);
+		GLState::Instance().BindVertexArray(batch.VAO);
+
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, batch.Indirect);
+		if (batch.Indexed)
+			glMultiDrawElementsIndirect(batch.Topology, GL_UNSIGNED_INT, nullptr, batch.DrawCount, 0);
+		else
+			glMultiDrawArraysIndirect(batch.Topology, nullptr, batch.DrawCount, 0);
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+	}
+	void DrawBatcher::Remove(pipe::ShaderPass* pass)
+	{
+		auto it = m_batches.find(pass);
+		if (it == m_batches.end())
+			return;
+
+		for (Batch& batch : it->second)
+			m_destroy(batch);
+		m_batches.erase(it);
+	}
+	void DrawBatcher::Clear()
+	{
+		for (auto& pair : m_batches)
+			for (Batch& batch : pair.second)
+				m_destroy(batch);
+		m_batches.clear();
+	}
+
+	void DrawBatcher::m_getSignature(pipe::ShaderPass* pass, PipelineItem** items, int count, std::vector<size_t>& sig)
+	{
+		sig.clear();
+
+		sig.push_back(pass->InputLayout.size());
+		for (const auto& layItem : pass->InputLayout)
+			sig.push_back((size_t)layItem.Value);
+
+		for (int i = 0; i < count; i++) {
+			if (items[i]->Type == PipelineItem::ItemType::Geometry) {
+				// buffer names get reused when the geometry is recreated, so also check the size
+				pipe::GeometryItem* geo = (pipe::GeometryItem*)items[i]->Data;
+				sig.push_back(geo->VBO);
+				sig.push_back(geo->Type);
+				sig.push_back(geo->Topology);
+				sig.push_back(floatBits(geo->Size.x));
+				sig.push_back(floatBits(geo->Size.y));
+				sig.push_back(floatBits(geo->Size.z));
+			} else {
+				eng::Model* model = ((pipe::Model*)items[i]->Data)->Data;
+				sig.push_back((size_t)model);
+				for (const auto& mesh : model->Meshes) {
+					sig.push_back(mesh.VBO);
+					sig.push_back(mesh.EBO);
+					sig.push_back(mesh.Vertices.size());
+					sig.push_back(mesh.Indices.size());
+				}
+			}
+		}
+	}
+	void DrawBatcher::m_build(Batch& batch, pipe::ShaderPass* pass, PipelineItem** items, int count)
+	{
+		m_destroy(batch);
+
+		batch.Indexed = items[0]->Type == PipelineItem::ItemType::Model;
+		batch.Topology = batch.Indexed ? GL_TRIANGLES : ((pipe::GeometryItem*)items[0]->Data)->Topology;
+
+		// source ranges - items that share a buffer (same geometry shape & size, same model file) are stored once
+		struct Range {
+			GLuint VBO, EBO;
+			GLsizei VertexCount, IndexCount;
+			GLint FirstVertex, FirstIndex;
+			bool Copy;
+			int Item;
+		};
+		std::vector<Range> ranges;
+		std::unordered_map<GLuint, size_t> stored; // source VBO -> range that copies it
+		GLsizeiptr vertexCount = 0, indexCount = 0;
+
+		auto addRange = [&](int item, GLuint vbo, GLuint ebo, GLsizei vertCount, GLsizei idxCount) {
+			auto it = stored.find(vbo);
+			if (it != stored.end()) {
+				Range range = ranges[it->second];
+				range.Copy = false;
+				range.Item = item;
+				ranges.push_back(range);
+				return;
+			}
+
+			stored[vbo] = ranges.size();
+			ranges.push_back({ vbo, ebo, vertCount, idxCount, (GLint)vertexCount, (GLint)indexCount, true, item });
+			vertexCount += vertCount;
+			indexCount += idxCount;
+		};
+
+		for (int i = 0; i < count; i++) {
+			if (items[i]->Type == PipelineItem::ItemType::Geometry) {
+				pipe::GeometryItem* geo = (pipe::GeometryItem*)items[i]->Data;
+				addRange(i, geo->VBO, 0, eng::GeometryFactory::VertexCount[geo->Type], 0);
+			} else {
+				eng::Model* model = ((pipe::Model*)items[i]->Data)->Data;
+				for (const auto& mesh : model->Meshes)
+					addRange(i, mesh.VBO, mesh.EBO, (GLsizei)mesh.Vertices.size(), (GLsizei)mesh.Indices.size());
+			}
+		}
+
+		// copy the vertex & index data into one buffer each - GPU side, nothing is read back
+		glGenBuffers(1, &batch.VBO);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, batch.VBO);
+		glBufferData(GL_COPY_WRITE_BUFFER, vertexCount * BatchVertexSize, nullptr, GL_STATIC_DRAW);
+
+		for (const auto& range : ranges) {
+			if (!range.Copy)
+				continue;
+
+			glBindBuffer(GL_COPY_READ_BUFFER, range.VBO);
+			glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, range.FirstVertex * BatchVertexSize, range.VertexCount * BatchVertexSize);
+		}
+
+		if (batch.Indexed) {
+			glGenBuffers(1, &batch.EBO);
+			glBindBuffer(GL_COPY_WRITE_BUFFER, batch.EBO);
+			glBufferData(GL_COPY_WRITE_BUFFER, indexCount * sizeof(GLuint), nullptr, GL_STATIC_DRAW);
+
+			for (const auto& range : ranges) {
+				if (!range.Copy)
+					continue;
+
+				glBindBuffer(GL_COPY_READ_BUFFER, range.EBO);
+				glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, range.FirstIndex * sizeof(GLuint), range.IndexCount * sizeof(GLuint));
+			}
+		}
+
+		glBindBuffer(GL_COPY_READ_BUFFER, 0);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+		gl::CreateVAO(batch.VAO, batch.VBO, pass->InputLayout, batch.EBO);
+		GLState::Instance().InvalidateVertexArray();
+
+		// an item with the same geometry as the previous one becomes another instance of its draw commands
+		struct Command {
+			size_t Range;
+			std::vector<int> Items;
+		};
+		std::vector<Command> commands;
+		size_t groupStart = 0; // commands of the previous item
+		for (size_t r = 0; r < ranges.size();) {
+			size_t rEnd = r;
+			while (rEnd < ranges.size() && ranges[rEnd].Item == ranges[r].Item)
+				rEnd++;
+
+			bool same = r > 0 && commands.size() - groupStart == rEnd - r;
+			for (size_t c = 0; same && c < rEnd - r; c++)
+				same = ranges[commands[groupStart + c].Range].VBO == ranges[r + c].VBO;
+
+			if (same) {
+				for (size_t c = groupStart; c < commands.size(); c++)
+					commands[c].Items.push_back(ranges[r].Item);
+			} else {
+				groupStart = commands.size();
+				for (size_t k = r; k < rEnd; k++)
+					commands.push_back({ k, { ranges[k].Item } });
+			}
+
+			r = rEnd;
+		}
+
+		// draw commands - the base instance points the shader to the transforms of the items
+		std::vector<DrawArraysIndirectCommand> arrayCmds;
+		std::vector<DrawElementsIndirectCommand> elementCmds;
+		for (const auto& cmd : commands) {
+			const Range& range = ranges[cmd.Range];
+			GLuint baseInstance = (GLuint)batch.InstanceItems.size();
+			GLuint instanceCount = (GLuint)cmd.Items.size();
+			batch.InstanceItems.insert(batch.InstanceItems.end(), cmd.Items.begin(), cmd.Items.end());
+
+			if (batch.Indexed)
+				elementCmds.push_back({ (GLuint)range.IndexCount, instanceCount, (GLuint)range.FirstIndex, range.FirstVertex, baseInstance });
+			else
+				arrayCmds.push_back({ (GLuint)range.VertexCount, instanceCount, (GLuint)range.FirstVertex, baseInstance });
+		}
+		batch.DrawCount = (GLsizei)commands.size();
+
+		glGenBuffers(1, &batch.Indirect);
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, batch.Indirect);
+		if (batch.Indexed)
+			glBufferData(GL_DRAW_INDIRECT_BUFFER, elementCmds.size() * sizeof(DrawElementsIndirectCommand), elementCmds.data(), GL_STATIC_DRAW);
+		else
+			glBufferData(GL_DRAW_INDIRECT_BUFFER, arrayCmds.size() * sizeof(DrawArraysIndirectCommand), arrayCmds.data(), GL_STATIC_DRAW);
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+		glGenBuffers(1, &batch.Transforms);
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, batch.Transforms);
+		glBufferData(GL_SHADER_STORAGE_BUFFER, batch.InstanceItems.size() * sizeof(glm::mat4), nullptr, GL_DYNAMIC_DRAW);
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+	}
+	void DrawBatcher::m_destroy(Batch& batch)
+	{
+		glDeleteVertexArrays(1, &batch.VAO);
+		glDeleteBuffers(1, &batch.VBO);
+		glDeleteBuffers(1, &batch.EBO);
+		glDeleteBuffers(1, &batch.Indirect);
+		glDeleteBuffers(1, &batch.Transforms);
+		GLState::Instance().InvalidateVertexArray(); // deleting a bound VAO binds 0
+
+		batch.VAO = batch.VBO = batch.EBO = batch.Indirect = batch.Transforms = 0;
+		batch.DrawCount = 0;
+		batch.Signature.clear();
+		batch.InstanceItems.clear();
+		batch.TransformData.clear();
+	}
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include <SHADERed/Objects/PipelineItem.h>
+#include <glm/glm.hpp>
+#include <unordered_map>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+#include <GL/glew.h>
+#if defined(__APPLE__)
+#include <OpenGL/gl.h>
+#else
+#include <GL/gl.h>
+#endif
+
+namespace ed {
+	/* Merges runs of non-instanced geometry & models in a shader pass into one vertex/index
+	   buffer and submits them with a single glMultiDraw*Indirect call. Neighbouring items with
+	   the same shared geometry are drawn as instances of one command. Only used for passes
+	   with the Batch property: their shaders read the world matrix of each item from
+	   layout(std430, binding = TransformBinding) buffer { mat4 transforms[]; } at
+	   gl_BaseInstance + gl_InstanceID, and gl_VertexID doesn't start at 0 for every item.
+	   Values that can't be stored per item (IsPicked, plugin values) disable batching. */
+	class DrawBatcher {
+	public:
+		DrawBatcher();
+		~DrawBatcher();
+
+		static const GLuint TransformBinding = 15;
+
+		// SSBOs & indirect multi-draw
+		static bool IsSupported();
+
+		// did the pass opt in & are the values bound for every item in this pass the same
+		static bool CanBatch(pipe::ShaderPass* pass);
+
+		// can this item be merged with its neighbours
+		static bool IsBatchable(PipelineItem* item);
+
+		// do these two batchable items fit in the same draw call
+		static bool IsCompatible(PipelineItem* a, PipelineItem* b);
+
+		// draw items [first, first + count) - run is the index of this run in the pass, transforms must be set already
+		void Draw(pipe::ShaderPass* pass, int run, PipelineItem** items, int count);
+
+		void Remove(pipe::ShaderPass* pass);
+		void Clear();
+
+	private:
+		struct Batch {
+			Batch()
+			{
+				VAO = VBO = EBO = Indirect = Transforms = 0;
+				DrawCount = 0;
+				Topology = GL_TRIANGLES;
+				Indexed = false;
+			}
+
+			std::vector<size_t> Signature; // buffers, sizes & layout the batch was built from
+			GLuint VAO, VBO, EBO, Indirect, Transforms;
+			GLsizei DrawCount;
+			GLenum Topology;
+			bool Indexed;
+
+			std::vector<int> InstanceItems;			   // item that each transform belongs to
+			std::vector<glm::mat4> TransformData; // last uploaded transforms
+		};
+
+		void m_getSignature(pipe::ShaderPass* pass, PipelineItem** items, int count, std::vector<size_t>& sig);
+		void m_build(Batch& batch, pipe::ShaderPass* pass, PipelineItem** items, int count);
+		void m_destroy(Batch& batch);
+
+		std::vector<size_t> m_sigTemp;
+		std::vector<glm::mat4> m_transformTemp;
+		std::unordered_map<pipe::ShaderPass*, std::vector<Batch>> m_batches;
+	};
+}
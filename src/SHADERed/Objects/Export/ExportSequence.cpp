@@ -0,0 +1,255 @@
+#include <SHADERed/Objects/Export/ExportSequence.h>
+#include <SHADERed/Objects/Export/ShellCommand.h>
+#include <SHADERed/Objects/Export/VideoWriter.h>
+#include <SHADERed/Objects/Logger.h>
+#include <SHADERed/Objects/SystemVariableManager.h>
+#include <SHADERed/Options.h>
+
+#include <atomic>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <string.h>
+
+#include <stb/stb_image_resize.h>
+#include <stb/stb_image_write.h>
+
+#if defined(_WIN32)
+#define pclose _pclose
+#endif
+
+namespace ed {
+	// encode & write an image on a background thread
+	static void writeImage(const std::string& path, const std::string& ext, int width, int height, const unsigned char* pixels)
+	{
+		if (ext == "jpg" || ext == "jpeg")
+			stbi_write_jpg(path.c_str(), width, height, 4, pixels, 100);
+		else if (ext == "bmp")
+			stbi_write_bmp(path.c_str(), width, height, 4, pixels);
+		else if (ext == "tga")
+			stbi_write_tga(path.c_str(), width, height, 4, pixels);
+		else
+			stbi_write_png(path.c_str(), width, height, 4, pixels, width * 4);
+	}
+
+	bool ExportSequence::Render(InterfaceManager* data, const Options& opts, std::function<void(int)> onFrame, std::string* error)
+	{
+		SystemVariableManager& systemVM = SystemVariableManager::Instance();
+
+		if (opts.Width <= 0 || opts.Height <= 0 || opts.FPS <= 0 || opts.Supersample <= 0) {
+			Logger::Get().Log(Logger::Category::Export, Logger::Level::Error, "Invalid size or FPS for the sequence export");
+			if (error)
+				*error = "Invalid size or FPS";
+			return false;
+		}
+
+		int actualSizeX = opts.Width * opts.Supersample;
+		int actualSizeY = opts.Height * opts.Supersample;
+
+		size_t lastDot = opts.Path.find_last_of('.');
+		std::string ext = lastDot == std::string::npos ? "png" : opts.Path.substr(lastDot + 1);
+		std::string filename = GetFilenameFormat(opts.Path);
+
+		VideoWriter video;
+		bool isVideo = VideoWriter::IsVideoExtension(ext);
+		if (isVideo && !video.Open(opts.Path, opts.Width, opts.Height, opts.FPS, ext == "y4m" ? "" : opts.Encoder)) {
+			if (error)
+				*error = video.GetError();
+			return false;
+		}
+
+		// frames are advanced manually with the fixed step clock so that every frame is reproducible
+		bool wasPaused = data->Renderer.IsPaused();
+		double prevTimeStep = systemVM.GetFixedTimeStep();
+		data->Renderer.Pause(true);
+		systemVM.SetFixedTimeStep(1.0 / opts.FPS);
+		systemVM.JumpToFrame(opts.FrameStart);
+		if (opts.StartTime >= 0.0f)
+			systemVM.AdvanceTimer(opts.StartTime - systemVM.GetTime());
+		systemVM.SetSavingToFile(true);
+
+		std::vector<unsigned char> pixels(opts.TileSize > 0 ? 0 : actualSizeX * actualSizeY * 4);
+
+		// images are encoded in parallel, each writer owns one output buffer
+		int writerCount = isVideo ? 1 : std::max<int>(1, std::thread::hardware_concurrency());
+		std::vector<std::vector<unsigned char>> outPixels(writerCount, std::vector<unsigned char>(opts.Width * opts.Height * 4));
+		std::vector<std::thread> writers(isVideo ? 0 : writerCount);
+		char framePath[SHADERED_MAX_PATH];
+
+		int prevCompression = stbi_write_png_compression_level;
+		stbi_write_png_compression_level = 5; // encoding time matters more than the file size here
+
+		for (int frame = opts.FrameStart; frame < opts.FrameEnd; frame++) {
+			int slot = (frame - opts.FrameStart) % writerCount;
+			if (!isVideo && writers[slot].joinable())
+				writers[slot].join();
+
+			unsigned char* result = outPixels[slot].data();
+
+			if (opts.TileSize > 0)
+				data->Renderer.RenderTiled(opts.Width, opts.Height, opts.TileSize, opts.Supersample, result);
+			else {
+				data->Renderer.Render(actualSizeX, actualSizeY);
+
+				glBindTexture(GL_TEXTURE_2D, data->Renderer.GetTexture());
+				glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, opts.Supersample != 1 ? pixels.data() : result);
+				glBindTexture(GL_TEXTURE_2D, 0);
+
+				if (opts.Supersample != 1)
+					stbir_resize_uint8(pixels.data(), actualSizeX, actualSizeY, actualSizeX * 4,
+						result, opts.Width, opts.Height, opts.Width * 4, 4);
+			}
+
+			if (isVideo) {
+				video.Push(result, opts.Width, opts.Height);
+				if (video.HasFailed())
+					break;
+			} else {
+				snprintf(framePath, SHADERED_MAX_PATH, filename.c_str(), frame);
+				writers[slot] = std::thread(writeImage, std::string(framePath), ext, opts.Width, opts.Height, result);
+			}
+
+			systemVM.Tick();
+			data->Renderer.StepPingPong();
+
+			if (onFrame)
+				onFrame(frame);
+		}
+
+		for (auto& writer : writers)
+			if (writer.joinable())
+				writer.join();
+		stbi_write_png_compression_level = prevCompression;
+
+		bool success = !isVideo || video.Close();
+		if (!success && error)
+			*error = video.GetError();
+
+		systemVM.SetSavingToFile(false);
+		systemVM.SetFixedTimeStep(prevTimeStep);
+		data->Renderer.Pause(wasPaused);
+
+		return success;
+	}
+	bool ExportSequence::RenderDistributed(const std::string& exe, const std::string& project, const Options& opts, int workerCount)
+	{
+		int frameCount = opts.FrameEnd - opts.FrameStart;
+		if (frameCount <= 0) {
+			Logger::Get().Log(Logger::Category::Export, Logger::Level::Error, "Sequence export has no frames to render");
+			return false;
+		}
+		workerCount = std::max(1, std::min(workerCount, frameCount));
+
+		size_t lastDot = opts.Path.find_last_of('.');
+		std::string ext = lastDot == std::string::npos ? "png" : opts.Path.substr(lastDot + 1);
+		bool isVideo = VideoWriter::IsVideoExtension(ext);
+
+		std::vector<std::string> outputs(workerCount);
+		std::vector<std::thread> workers;
+		std::mutex progressMutex;
+		std::atomic<bool> failed = false;
+		int framesDone = 0;
+
+		Logger::Get().Log(Logger::Category::Export, Logger::Level::Info, "Rendering " + std::to_string(frameCount) + " frames with " + std::to_string(workerCount) + " worker processes");
+
+		for (int w = 0; w < workerCount; w++) {
+			int start = opts.FrameStart + (int)((long long)frameCount * w / workerCount);
+			int end = opts.FrameStart + (int)((long long)frameCount * (w + 1) / workerCount);
+
+			// every worker writes its own part of the video, images already have unique names
+			outputs[w] = isVideo ? (opts.Path + ".part" + std::to_string(w) + ".y4m") : opts.Path;
+
+			std::string cmd = ShellCommand::Quote(exe) + " " + ShellCommand::Quote(project) + " --export-sequence " + ShellCommand::Quote(outputs[w])
+				+ " --fps " + std::to_string(opts.FPS)
+				+ " --size " + std::to_string(opts.Width) + "x" + std::to_string(opts.Height)
+				+ " --supersample " + std::to_string(opts.Supersample)
+				+ " --tiles " + std::to_string(opts.TileSize)
+				+ " --frames " + std::to_string(start) + " " + std::to_string(end);
+
+			workers.push_back(std::thread([&, cmd, w]() {
+				FILE* pipe = ShellCommand::Open(cmd, "r");
+				if (pipe == nullptr) {
+					failed = true;
+					return;
+				}
+
+				// workers report each written frame with "frame <index>"
+				char line[256];
+				while (fgets(line, sizeof(line), pipe) != nullptr) {
+					if (strncmp(line, "frame ", 6) != 0)
+						continue;
+
+					std::lock_guard<std::mutex> lock(progressMutex);
+					framesDone++;
+					printf("[%d/%d] worker %d: frame %s", framesDone, frameCount, w, line + 6);
+					fflush(stdout);
+				}
+
+				if (pclose(pipe) != 0)
+					failed = true;
+			}));
+		}
+
+		for (auto& worker : workers)
+			worker.join();
+
+		if (failed)
+			Logger::Get().Log(Logger::Category::Export, Logger::Level::Error, "One or more sequence export workers failed");
+
+		// reassemble the video in frame order
+		if (isVideo) {
+			if (!failed) {
+				VideoWriter video;
+				if (video.Open(opts.Path, opts.Width, opts.Height, opts.FPS, ext == "y4m" ? "" : opts.Encoder)) {
+					for (const auto& part : outputs)
+						failed = !video.Append(part) || failed;
+					failed = !video.Close() || failed;
+				} else
+					failed = true;
+			}
+
+			std::error_code errCode;
+			for (const auto& part : outputs)
+				std::filesystem::remove(part, errCode);
+		}
+
+		return !failed;
+	}
+	std::string ExportSequence::GetFilenameFormat(const std::string& path)
+	{
+		std::string filename = path;
+		size_t lastDot = filename.find_last_of('.');
+
+		// allow only one %??d
+		bool inFormat = false;
+		int lastFormatPos = -1;
+		int formatCount = 0;
+		for (int i = 0; i < filename.size(); i++) {
+			if (filename[i] == '%') {
+				inFormat = true;
+				lastFormatPos = i;
+				continue;
+			}
+
+			if (inFormat) {
+				if (isdigit(filename[i])) {
+				} else {
+					if (filename[i] != '%' && ((filename[i] == 'd' && formatCount > 0) || (filename[i] != 'd'))) {
+						filename.insert(lastFormatPos, 1, '%');
+					}
+
+					if (filename[i] == 'd')
+						formatCount++;
+					inFormat = false;
+				}
+			}
+		}
+
+		// no %d found? add one
+		if (formatCount == 0)
+			filename.insert(lastDot == std::string::npos ? filename.size() : lastDot, "%d"); // frame%d
+
+		return filename;
+	}
+}
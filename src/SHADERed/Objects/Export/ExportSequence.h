@@ -0,0 +1,41 @@
+#pragma once
+#include <SHADERed/InterfaceManager.h>
+#include <functional>
+#include <string>
+
+namespace ed {
+	class ExportSequence {
+	public:
+		struct Options {
+			Options()
+			{
+				Width = 1920;
+				Height = 1080;
+				Supersample = 1;
+				TileSize = 0;
+				FPS = 30;
+				FrameStart = 0;
+				FrameEnd = 0;
+				StartTime = -1.0f;
+			}
+
+			std::string Path;	 // image path (%d is replaced with the frame index) or a video file
+			std::string Encoder; // external encoder command for video files other than .y4m
+			int Width, Height;
+			int Supersample; // 1, 2, 4 or 8
+			int TileSize;	 // 0 -> render whole frames
+			int FPS;
+			int FrameStart, FrameEnd; // [FrameStart, FrameEnd)
+			float StartTime;		  // Time on FrameStart, < 0 -> FrameStart / FPS
+		};
+
+		// render the frames in this process - onFrame is called after each rendered frame, error receives the reason of a failure
+		static bool Render(InterfaceManager* data, const Options& opts, std::function<void(int)> onFrame = nullptr, std::string* error = nullptr);
+
+		// split the frame range between worker processes (exe + project + --export-sequence ...) and merge their output
+		static bool RenderDistributed(const std::string& exe, const std::string& project, const Options& opts, int workerCount);
+
+		// makes sure that the image path contains exactly one %d
+		static std::string GetFilenameFormat(const std::string& path);
+	};
+}
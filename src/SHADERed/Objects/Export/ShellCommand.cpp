@@ -0,0 +1,37 @@
+#include <SHADERed/Objects/Export/ShellCommand.h>
+
+#if defined(_WIN32)
+#define popen _popen
+#endif
+
+namespace ed {
+	std::string ShellCommand::Quote(const std::string& arg)
+	{
+#if defined(_WIN32)
+		std::string ret = "\"";
+		for (char c : arg)
+			if (c != '"') // not allowed in file names anyway
+				ret += c;
+		return ret + "\"";
+#else
+		// nothing is expanded inside single quotes - only ' itself has to be closed, escaped & reopened
+		std::string ret = "'";
+		for (char c : arg) {
+			if (c == '\'')
+				ret += "'\\''";
+			else
+				ret += c;
+		}
+		return ret + "'";
+#endif
+	}
+	FILE* ShellCommand::Open(const std::string& cmd, const char* mode)
+	{
+#if defined(_WIN32)
+		// cmd.exe strips the first & the last quote of the whole command line
+		return popen(("\"" + cmd + "\"").c_str(), mode);
+#else
+		return popen(cmd.c_str(), mode);
+#endif
+	}
+}
@@ -0,0 +1,15 @@
+#pragma once
+#include <cstdio>
+#include <string>
+
+namespace ed {
+	// helpers for running external programs through the shell (video encoders, export workers)
+	class ShellCommand {
+	public:
+		// quote an argument so that spaces & shell metacharacters ($, `, ", ...) stay a part of it
+		static std::string Quote(const std::string& arg);
+
+		// popen() that also works with commands that start with a quoted path on Windows
+		static FILE* Open(const std::string& cmd, const char* mode);
+	};
+}
@@ -0,0 +1,269 @@
+#include <SHADERed/Objects/Export/ShellCommand.h>
+#include <SHADERed/Objects/Export/VideoWriter.h>
+#include <SHADERed/Objects/Logger.h>
+
+#include <algorithm>
+#include <signal.h>
+#include <string.h>
+
+#include <stb/stb_image_resize.h>
+
+#if defined(_WIN32)
+#define pclose _pclose
+#else
+#include <sys/wait.h>
+#endif
+
+namespace ed {
+	VideoWriter::VideoWriter()
+	{
+		m_file = nullptr;
+		m_isPipe = false;
+		m_width = m_height = 0;
+		m_worker = nullptr;
+		m_closing = false;
+		m_pending = 0;
+		m_failed = false;
+#if !defined(_WIN32)
+		m_oldSigpipe = SIG_DFL;
+#endif
+	}
+	VideoWriter::~VideoWriter()
+	{
+		Close();
+	}
+
+	bool VideoWriter::Open(const std::string& path, int width, int height, int fps, const std::string& encoderCmd)
+	{
+		Close();
+
+		m_failed = false;
+		m_error.clear();
+		m_isPipe = !encoderCmd.empty();
+		if (m_isPipe) {
+			std::string cmd = encoderCmd;
+			size_t pathPos = cmd.find("%s");
+			if (pathPos != std::string::npos) {
+				// older commands quoted the placeholder themselves
+				size_t pathLen = 2;
+				if (pathPos > 0 && pathPos + 2 < cmd.size() && (cmd[pathPos - 1] == '"' || cmd[pathPos - 1] == '\'') && cmd[pathPos + 2] == cmd[pathPos - 1]) {
+					pathPos--;
+					pathLen += 2;
+				}
+				cmd.replace(pathPos, pathLen, ShellCommand::Quote(path));
+			}
+
+			Logger::Get().Log(Logger::Category::Export, Logger::Level::Info, "Starting video encoder: " + cmd);
+#if defined(_WIN32)
+			m_file = ShellCommand::Open(cmd, "wb");
+#else
+			// an encoder that is missing or crashed would otherwise kill the editor on the next write
+			m_oldSigpipe = signal(SIGPIPE, SIG_IGN);
+			m_file = ShellCommand::Open(cmd, "w"); // glibc rejects "b"
+#endif
+		} else
+			m_file = fopen(path.c_str(), "wb");
+
+		if (m_file == nullptr) {
+			m_fail("Failed to open video output " + path);
+#if !defined(_WIN32)
+			if (m_isPipe)
+				signal(SIGPIPE, m_oldSigpipe);
+#endif
+			return false;
+		}
+
+		m_width = width;
+		m_height = height;
+
+		if (fprintf(m_file, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C444\n", width, height, std::max(fps, 1)) < 0) {
+			m_fail("Failed to write to video output " + path);
+			Close();
+			return false;
+		}
+
+		m_closing = false;
+		m_pending = 0;
+		m_worker = new std::thread(&VideoWriter::m_encode, this);
+
+		return true;
+	}
+	bool VideoWriter::Close()
+	{
+		if (m_worker != nullptr) {
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_closing = true;
+			}
+			m_canPop.notify_one();
+
+			if (m_worker->joinable())
+				m_worker->join();
+			delete m_worker;
+			m_worker = nullptr;
+		}
+
+		if (m_file != nullptr) {
+			if (m_isPipe) {
+				int status = pclose(m_file);
+#if defined(_WIN32)
+				if (status != 0)
+					m_fail("Video encoder exited with status " + std::to_string(status));
+#else
+				signal(SIGPIPE, m_oldSigpipe);
+
+				if (status == -1)
+					m_fail("Failed to wait for the video encoder");
+				else if (WIFSIGNALED(status))
+					m_fail("Video encoder was killed by signal " + std::to_string(WTERMSIG(status)));
+				else if (WIFEXITED(status) && WEXITSTATUS(status) != 0)
+					m_fail("Video encoder exited with status " + std::to_string(WEXITSTATUS(status)));
+#endif
+			} else if (fclose(m_file) != 0)
+				m_fail("Failed to finish writing the video file");
+			m_file = nullptr;
+		}
+
+		m_queue.clear();
+		m_pool.clear();
+
+		return !m_failed;
+	}
+
+	void VideoWriter::Push(const unsigned char* pixels, int srcWidth, int srcHeight)
+	{
+		if (m_file == nullptr || m_failed)
+			return;
+
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_canPush.wait(lock, [&] { return m_queue.size() < QueueSize; });
+
+		// reuse buffers of already encoded frames
+		Frame frame;
+		if (!m_pool.empty()) {
+			frame = std::move(m_pool.back());
+			m_pool.pop_back();
+		}
+		frame.Width = srcWidth;
+		frame.Height = srcHeight;
+		frame.Pixels.resize(srcWidth * srcHeight * 4);
+		memcpy(frame.Pixels.data(), pixels, frame.Pixels.size());
+
+		m_queue.push_back(std::move(frame));
+		m_pending++;
+
+		lock.unlock();
+		m_canPop.notify_one();
+	}
+
+	bool VideoWriter::Append(const std::string& y4mPath)
+	{
+		if (m_file == nullptr || m_failed)
+			return false;
+
+		FILE* in = fopen(y4mPath.c_str(), "rb");
+		if (in == nullptr) {
+			Logger::Get().Log(Logger::Category::Export, Logger::Level::Error, "Failed to open " + y4mPath);
+			return false;
+		}
+
+		// wait for the queued frames so that the order is kept
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_canPush.wait(lock, [&] { return m_pending == 0; });
+		}
+
+		// skip the stream header
+		int c = 0;
+		while ((c = fgetc(in)) != EOF && c != '\n')
+			;
+
+		char buffer[64 * 1024];
+		size_t read = 0;
+		while ((read = fread(buffer, 1, sizeof(buffer), in)) > 0)
+			if (fwrite(buffer, 1, read, m_file) != read) {
+				m_fail("Failed to write to the video output while merging " + y4mPath);
+				break;
+			}
+
+		fclose(in);
+
+		return !m_failed;
+	}
+
+	bool VideoWriter::IsVideoExtension(const std::string& ext)
+	{
+		static const char* videoExts[] = { "y4m", "mp4", "mkv", "webm", "mov", "avi", "nut" };
+		for (const char* videoExt : videoExts)
+			if (ext == videoExt)
+				return true;
+		return false;
+	}
+
+	void VideoWriter::m_encode()
+	{
+		while (true) {
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_canPop.wait(lock, [&] { return m_closing || !m_queue.empty(); });
+
+			if (m_queue.empty())
+				break; // closing & nothing left to encode
+
+			Frame frame = std::move(m_queue.front());
+			m_queue.pop_front();
+			lock.unlock();
+
+			// keep draining the queue after a failure so that Push() doesn't block forever
+			if (!m_failed && !m_writeFrame(frame))
+				m_fail("Failed to write a frame to the video output - the encoder might have exited");
+
+			lock.lock();
+			m_pool.push_back(std::move(frame));
+			m_pending--;
+			lock.unlock();
+			m_canPush.notify_one();
+		}
+	}
+	void VideoWriter::m_fail(const std::string& error)
+	{
+		// only the first error is kept, the rest is usually caused by it
+		if (m_error.empty()) {
+			m_error = error;
+			Logger::Get().Log(Logger::Category::Export, Logger::Level::Error, error);
+		}
+		m_failed = true;
+	}
+	bool VideoWriter::m_writeFrame(Frame& frame)
+	{
+		const unsigned char* rgba = frame.Pixels.data();
+		if (frame.Width != m_width || frame.Height != m_height) {
+			m_resized.resize(m_width * m_height * 4);
+			stbir_resize_uint8(rgba, frame.Width, frame.Height, frame.Width * 4,
+				m_resized.data(), m_width, m_height, m_width * 4, 4);
+			rgba = m_resized.data();
+		}
+
+		// RGBA -> planar Y'CbCr 4:4:4 (BT.601, studio range), flipped since GL images are bottom-up
+		size_t planeSize = m_width * m_height;
+		m_planes.resize(planeSize * 3);
+		unsigned char* planeY = m_planes.data();
+		unsigned char* planeU = planeY + planeSize;
+		unsigned char* planeV = planeU + planeSize;
+
+		for (int y = 0; y < m_height; y++) {
+			const unsigned char* row = rgba + (m_height - y - 1) * m_width * 4;
+			for (int x = 0; x < m_width; x++) {
+				int r = row[x * 4 + 0], g = row[x * 4 + 1], b = row[x * 4 + 2];
+				size_t out = y * m_width + x;
+
+				planeY[out] = ((66 * r + 129 * g + 25 * b + 128) >> 8) + 16;
+				planeU[out] = ((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128;
+				planeV[out] = ((112 * r - 94 * g - 18 * b + 128) >> 8) + 128;
+			}
+		}
+
+		if (fputs("FRAME\n", m_file) < 0)
+			return false;
+		return fwrite(m_planes.data(), 1, m_planes.size(), m_file) == m_planes.size();
+	}
+}
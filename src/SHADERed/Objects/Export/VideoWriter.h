@@ -0,0 +1,68 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ed {
+	/* Streams frames as YUV4MPEG2 (C444) either into a .y4m file or into
+	   stdin of an external encoder. Frames are encoded on a worker thread
+	   in the same order in which they were pushed. */
+	class VideoWriter {
+	public:
+		VideoWriter();
+		~VideoWriter();
+
+		// maximum number of frames waiting to be encoded - Push() blocks when the queue is full
+		static const int QueueSize = 4;
+
+		// encoderCmd is ran through popen() with %s replaced by the quoted path - leave it empty to write a raw .y4m file
+		bool Open(const std::string& path, int width, int height, int fps, const std::string& encoderCmd = "");
+		bool Close(); // false if a write failed or the encoder didn't exit with 0 - see GetError()
+
+		// pixels = bottom-up RGBA8 image, resized to the video size if srcWidth x srcHeight doesn't match it
+		void Push(const unsigned char* pixels, int srcWidth, int srcHeight);
+
+		// copy all frames from a .y4m file with the same format (used to merge the output of multiple processes)
+		bool Append(const std::string& y4mPath);
+
+		inline bool IsOpen() { return m_file != nullptr; }
+		inline bool HasFailed() { return m_failed; } // frames pushed after a failed write are dropped
+		inline const std::string& GetError() { return m_error; }
+
+		static bool IsVideoExtension(const std::string& ext);
+
+	private:
+		struct Frame {
+			std::vector<unsigned char> Pixels;
+			int Width, Height;
+		};
+
+		void m_encode();
+		bool m_writeFrame(Frame& frame);
+		void m_fail(const std::string& error);
+
+		FILE* m_file;
+		bool m_isPipe;
+		std::atomic<bool> m_failed;
+		std::string m_error;
+#if !defined(_WIN32)
+		void (*m_oldSigpipe)(int); // restored in Close()
+#endif
+		int m_width, m_height;
+
+		std::thread* m_worker;
+		std::mutex m_mutex;
+		std::condition_variable m_canPush, m_canPop;
+		std::deque<Frame> m_queue;
+		std::vector<Frame> m_pool;
+		bool m_closing;
+		int m_pending; // pushed but not yet written frames
+
+		std::vector<unsigned char> m_resized, m_planes;
+	};
+}
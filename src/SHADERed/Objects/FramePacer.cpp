@@ -0,0 +1,111 @@
+#include <SHADERed/Objects/FramePacer.h>
+
+#include <thread>
+
+namespace ed {
+	FramePacer::FramePacer()
+	{
+		m_initialized = false;
+		m_timerQueries = false;
+		m_current = 0;
+		m_cpuTime = 0.0f;
+		m_gpuTime = -1.0f;
+
+		for (int i = 0; i < FrameSlots; i++) {
+			m_frames[i].Fence = nullptr;
+			m_frames[i].Queries[0] = m_frames[i].Queries[1] = 0;
+		}
+	}
+	FramePacer::~FramePacer()
+	{
+		if (!m_initialized)
+			return;
+
+		for (int i = 0; i < FrameSlots; i++) {
+			if (m_frames[i].Fence != nullptr)
+				glDeleteSync(m_frames[i].Fence);
+			if (m_timerQueries)
+				glDeleteQueries(2, m_frames[i].Queries);
+		}
+	}
+
+	void FramePacer::BeginFrame()
+	{
+		m_init();
+
+		// the GPU has to finish the frame that used this slot before we queue another one
+		Frame& frame = m_frames[m_current];
+		if (frame.Fence != nullptr)
+			m_finish(frame);
+
+		if (m_timerQueries)
+			glQueryCounter(frame.Queries[0], GL_TIMESTAMP);
+
+		m_submitStart = std::chrono::steady_clock::now();
+	}
+	void FramePacer::EndFrame()
+	{
+		if (!m_initialized)
+			return;
+
+		Frame& frame = m_frames[m_current];
+		if (m_timerQueries)
+			glQueryCounter(frame.Queries[1], GL_TIMESTAMP);
+		frame.Fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		glFlush();
+
+		m_cpuTime = std::chrono::duration<float>(std::chrono::steady_clock::now() - m_submitStart).count();
+		m_current = (m_current + 1) % FrameSlots;
+	}
+	void FramePacer::Wait(float fps)
+	{
+		auto now = std::chrono::steady_clock::now();
+		if (fps <= 0.0f) {
+			m_deadline = now;
+			return;
+		}
+
+		auto interval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / fps));
+
+		// don't try to catch up after a hitch, just continue from now
+		if (now - m_deadline > interval)
+			m_deadline = now;
+		m_deadline += interval;
+
+		// sleep_for is only accurate to a millisecond or two, spin for the rest
+		const auto spinTime = std::chrono::microseconds(2000);
+		if (m_deadline - now > spinTime)
+			std::this_thread::sleep_for(m_deadline - now - spinTime);
+		while (std::chrono::steady_clock::now() < m_deadline)
+			std::this_thread::yield();
+	}
+
+	void FramePacer::m_init()
+	{
+		if (m_initialized)
+			return;
+		m_initialized = true;
+
+		m_timerQueries = GLEW_VERSION_3_3 || GLEW_ARB_timer_query;
+		if (m_timerQueries)
+			for (int i = 0; i < FrameSlots; i++)
+				glGenQueries(2, m_frames[i].Queries);
+
+		m_deadline = std::chrono::steady_clock::now();
+	}
+	void FramePacer::m_finish(Frame& frame)
+	{
+		GLenum status = GL_TIMEOUT_EXPIRED;
+		while (status == GL_TIMEOUT_EXPIRED)
+			status = glClientWaitSync(frame.Fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000); // 1s
+		glDeleteSync(frame.Fence);
+		frame.Fence = nullptr;
+
+		if (m_timerQueries && status != GL_WAIT_FAILED) {
+			GLuint64 start = 0, end = 0;
+			glGetQueryObjectui64v(frame.Queries[0], GL_QUERY_RESULT, &start);
+			glGetQueryObjectui64v(frame.Queries[1], GL_QUERY_RESULT, &end);
+			m_gpuTime = (end - start) / 1000000000.0f;
+		}
+	}
+}
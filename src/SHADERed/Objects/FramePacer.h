@@ -0,0 +1,52 @@
+#pragma once
+#ifdef _WIN32
+#include <windows.h>
+#endif
+#include <GL/glew.h>
+#if defined(__APPLE__)
+#include <OpenGL/gl.h>
+#else
+#include <GL/gl.h>
+#endif
+#include <chrono>
+
+namespace ed {
+	/* Keeps at most one preview frame in flight (GL fences), measures how long a frame
+	   took to submit on the CPU and to execute on the GPU and waits for the next frame
+	   with a sleep + spin so that the frame interval doesn't depend on the OS timer resolution. */
+	class FramePacer {
+	public:
+		FramePacer();
+		~FramePacer();
+
+		// call before/after submitting the frame's GL commands
+		void BeginFrame();
+		void EndFrame();
+
+		// wait until 1/fps seconds have passed since the previous frame
+		void Wait(float fps);
+
+		inline float GetCPUTime() { return m_cpuTime; } // seconds
+		inline float GetGPUTime() { return m_gpuTime; } // seconds, -1 if timer queries are not supported
+
+	private:
+		static const int FrameSlots = 2; // current frame + one in flight
+
+		struct Frame {
+			GLsync Fence;
+			GLuint Queries[2];
+		};
+
+		void m_init();
+		void m_finish(Frame& frame);
+
+		bool m_initialized;
+		bool m_timerQueries;
+		Frame m_frames[FrameSlots];
+		int m_current;
+
+		std::chrono::steady_clock::time_point m_submitStart;
+		std::chrono::steady_clock::time_point m_deadline;
+		float m_cpuTime, m_gpuTime;
+	};
+}
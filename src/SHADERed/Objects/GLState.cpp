@@ -0,0 +1,245 @@
+#include <SHADERed/Objects/GLState.h>
+
+namespace ed {
+	GLState::GLState()
+	{
+		m_tracking = false;
+		m_issued = m_skipped = 0;
+		m_lastIssued = m_lastSkipped = 0;
+		Invalidate();
+	}
+
+	void GLState::Begin()
+	{
+		Invalidate();
+		m_tracking = true;
+		m_issued = m_skipped = 0;
+	}
+	void GLState::End()
+	{
+		m_tracking = false;
+		m_lastIssued = m_issued;
+		m_lastSkipped = m_skipped;
+	}
+	void GLState::Invalidate()
+	{
+		for (int i = 0; i < CapCount; i++)
+			m_caps[i] = Unknown;
+
+		m_polygonMode = m_cullFace = m_frontFace = m_depthMask = m_depthFunc = Unknown;
+		m_blendEq[0] = m_blendEq[1] = Unknown;
+		for (int i = 0; i < 4; i++)
+			m_blendFunc[i] = Unknown;
+		for (int i = 0; i < 2; i++)
+			for (int j = 0; j < 3; j++)
+				m_stencilFunc[i][j] = m_stencilOp[i][j] = Unknown;
+		m_stencilMask = Unknown;
+		m_polygonOffsetValid = m_blendColorValid = m_sampleCoverageValid = false;
+
+		m_program = m_vao = m_fbo = Unknown;
+		m_drawBufferCount = -1;
+		m_activeUnit = -1;
+		for (int i = 0; i < MaxTextureUnits; i++) {
+			m_texTarget[i] = Unknown;
+			m_texture[i] = Unknown;
+		}
+	}
+
+	void GLState::Enable(GLenum cap, bool enable)
+	{
+		int index = m_capIndex(cap);
+		GLuint val = enable;
+		if (index >= 0 && !m_changed(&m_caps[index], &val, 1))
+			return;
+
+		if (enable)
+			glEnable(cap);
+		else
+			glDisable(cap);
+	}
+	void GLState::PolygonMode(GLenum mode)
+	{
+		if (m_changed(&m_polygonMode, &mode, 1))
+			glPolygonMode(GL_FRONT_AND_BACK, mode);
+	}
+	void GLState::CullFace(GLenum mode)
+	{
+		if (m_changed(&m_cullFace, &mode, 1))
+			glCullFace(mode);
+	}
+	void GLState::FrontFace(GLenum mode)
+	{
+		if (m_changed(&m_frontFace, &mode, 1))
+			glFrontFace(mode);
+	}
+	void GLState::DepthMask(GLboolean mask)
+	{
+		GLuint val = mask;
+		if (m_changed(&m_depthMask, &val, 1))
+			glDepthMask(mask);
+	}
+	void GLState::DepthFunc(GLenum func)
+	{
+		if (m_changed(&m_depthFunc, &func, 1))
+			glDepthFunc(func);
+	}
+	void GLState::PolygonOffset(float factor, float units)
+	{
+		float val[2] = { factor, units };
+		if (m_changed(m_polygonOffset, val, 2, m_polygonOffsetValid))
+			glPolygonOffset(factor, units);
+	}
+	void GLState::BlendEquation(GLenum color, GLenum alpha)
+	{
+		GLuint val[2] = { color, alpha };
+		if (m_changed(m_blendEq, val, 2))
+			glBlendEquationSeparate(color, alpha);
+	}
+	void GLState::BlendFunc(GLenum srcRGB, GLenum dstRGB, GLenum srcAlpha, GLenum dstAlpha)
+	{
+		GLuint val[4] = { srcRGB, dstRGB, srcAlpha, dstAlpha };
+		if (m_changed(m_blendFunc, val, 4))
+			glBlendFuncSeparate(srcRGB, dstRGB, srcAlpha, dstAlpha);
+	}
+	void GLState::BlendColor(float r, float g, float b, float a)
+	{
+		float val[4] = { r, g, b, a };
+		if (m_changed(m_blendColor, val, 4, m_blendColorValid))
+			glBlendColor(r, g, b, a);
+	}
+	void GLState::SampleCoverage(float value, GLboolean invert)
+	{
+		float val[2] = { value, (float)invert };
+		if (m_changed(m_sampleCoverage, val, 2, m_sampleCoverageValid))
+			glSampleCoverage(value, invert);
+	}
+	void GLState::StencilFunc(GLenum face, GLenum func, GLint ref, GLuint mask)
+	{
+		GLuint val[3] = { func, (GLuint)ref, mask };
+		if (m_changed(m_stencilFunc[face == GL_BACK], val, 3))
+			glStencilFuncSeparate(face, func, ref, mask);
+	}
+	void GLState::StencilMask(GLuint mask)
+	{
+		if (m_changed(&m_stencilMask, &mask, 1))
+			glStencilMask(mask);
+	}
+	void GLState::StencilOp(GLenum face, GLenum sfail, GLenum dpfail, GLenum dppass)
+	{
+		GLuint val[3] = { sfail, dpfail, dppass };
+		if (m_changed(m_stencilOp[face == GL_BACK], val, 3))
+			glStencilOpSeparate(face, sfail, dpfail, dppass);
+	}
+
+	void GLState::UseProgram(GLuint program)
+	{
+		if (m_changed(&m_program, &program, 1))
+			glUseProgram(program);
+	}
+	void GLState::BindVertexArray(GLuint vao)
+	{
+		if (m_changed(&m_vao, &vao, 1))
+			glBindVertexArray(vao);
+	}
+	void GLState::BindFramebuffer(GLuint fbo)
+	{
+		if (m_changed(&m_fbo, &fbo, 1)) {
+			glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+			m_drawBufferCount = -1; // draw buffers are part of the framebuffer object
+		}
+	}
+	void GLState::DrawBuffers(int count, const GLenum* buffers)
+	{
+		bool same = m_tracking && count == m_drawBufferCount;
+		for (int i = 0; same && i < count; i++)
+			same = m_drawBuffers[i] == buffers[i];
+
+		if (same) {
+			m_skipped++;
+			return;
+		}
+
+		if (m_tracking) {
+			m_issued++;
+			m_drawBufferCount = count <= MaxDrawBuffers ? count : -1;
+			for (int i = 0; i < count && i < MaxDrawBuffers; i++)
+				m_drawBuffers[i] = buffers[i];
+		}
+
+		glDrawBuffers(count, buffers);
+	}
+	void GLState::BindTexture(int unit, GLenum target, GLuint texture)
+	{
+		if (unit >= MaxTextureUnits) {
+			glActiveTexture(GL_TEXTURE0 + unit);
+			glBindTexture(target, texture);
+			m_activeUnit = -1;
+			return;
+		}
+
+		GLuint val[2] = { target, texture };
+		GLuint cur[2] = { m_texTarget[unit], m_texture[unit] };
+		if (!m_changed(cur, val, 2))
+			return;
+		m_texTarget[unit] = target;
+		m_texture[unit] = texture;
+
+		if (!m_tracking || m_activeUnit != unit) {
+			glActiveTexture(GL_TEXTURE0 + unit);
+			m_activeUnit = m_tracking ? unit : -1;
+		}
+		glBindTexture(target, texture);
+	}
+
+	bool GLState::m_changed(GLuint* cur, const GLuint* val, int count)
+	{
+		if (!m_tracking)
+			return true;
+
+		bool same = true;
+		for (int i = 0; i < count; i++)
+			if (cur[i] != val[i]) {
+				same = false;
+				cur[i] = val[i];
+			}
+
+		if (same)
+			m_skipped++;
+		else
+			m_issued++;
+
+		return !same;
+	}
+	bool GLState::m_changed(float* cur, const float* val, int count, bool& valid)
+	{
+		if (!m_tracking)
+			return true;
+
+		bool same = valid;
+		for (int i = 0; i < count; i++)
+			if (cur[i] != val[i]) {
+				same = false;
+				cur[i] = val[i];
+			}
+		valid = true;
+
+		if (same)
+			m_skipped++;
+		else
+			m_issued++;
+
+		return !same;
+	}
+	int GLState::m_capIndex(GLenum cap)
+	{
+		switch (cap) {
+		case GL_DEPTH_CLAMP: return 0;
+		case GL_CULL_FACE: return 1;
+		case GL_BLEND: return 2;
+		case GL_DEPTH_TEST: return 3;
+		case GL_STENCIL_TEST: return 4;
+		}
+
+		return -1;
+	}
+}
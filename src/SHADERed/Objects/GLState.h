@@ -0,0 +1,87 @@
+#pragma once
+#ifdef _WIN32
+#include <windows.h>
+#endif
+#include <GL/glew.h>
+#if defined(__APPLE__)
+#include <OpenGL/gl.h>
+#else
+#include <GL/gl.h>
+#endif
+
+namespace ed {
+	/* Shadows the GL state that the renderer changes for every shader pass & item and skips
+	   calls that wouldn't change anything. Tracking is only active between Begin() and End()
+	   since ImGui & plugins change the state behind our back - outside of that every call
+	   is issued. Call Invalidate() after handing control to code that doesn't use this class. */
+	class GLState {
+	public:
+		GLState();
+
+		static GLState& Instance()
+		{
+			static GLState ret;
+			return ret;
+		}
+
+		void Begin();
+		void End();
+
+		void Invalidate();
+		inline void InvalidateFramebuffer() { m_fbo = Unknown; m_drawBufferCount = -1; }
+		inline void InvalidateVertexArray() { m_vao = Unknown; }
+
+		void Enable(GLenum cap, bool enable);
+		void PolygonMode(GLenum mode);
+		void CullFace(GLenum mode);
+		void FrontFace(GLenum mode);
+		void DepthMask(GLboolean mask);
+		void DepthFunc(GLenum func);
+		void PolygonOffset(float factor, float units);
+		void BlendEquation(GLenum color, GLenum alpha);
+		void BlendFunc(GLenum srcRGB, GLenum dstRGB, GLenum srcAlpha, GLenum dstAlpha);
+		void BlendColor(float r, float g, float b, float a);
+		void SampleCoverage(float value, GLboolean invert);
+		void StencilFunc(GLenum face, GLenum func, GLint ref, GLuint mask);
+		void StencilMask(GLuint mask);
+		void StencilOp(GLenum face, GLenum sfail, GLenum dpfail, GLenum dppass);
+
+		void UseProgram(GLuint program);
+		void BindVertexArray(GLuint vao);
+		void BindFramebuffer(GLuint fbo);
+		void DrawBuffers(int count, const GLenum* buffers);
+		void BindTexture(int unit, GLenum target, GLuint texture);
+
+		// calls made / skipped during the last Begin() & End()
+		inline int GetIssuedCount() { return m_lastIssued; }
+		inline int GetSkippedCount() { return m_lastSkipped; }
+
+	private:
+		static const GLuint Unknown = 0xFFFFFFFF;
+		static const int CapCount = 5;
+		static const int MaxTextureUnits = 32;
+		static const int MaxDrawBuffers = 16;
+
+		bool m_changed(GLuint* cur, const GLuint* val, int count);
+		bool m_changed(float* cur, const float* val, int count, bool& valid);
+		int m_capIndex(GLenum cap);
+
+		bool m_tracking;
+		int m_issued, m_skipped;
+		int m_lastIssued, m_lastSkipped;
+
+		GLuint m_caps[CapCount];
+		GLuint m_polygonMode, m_cullFace, m_frontFace, m_depthMask, m_depthFunc;
+		GLuint m_blendEq[2], m_blendFunc[4];
+		GLuint m_stencilFunc[2][3], m_stencilMask, m_stencilOp[2][3];
+		float m_polygonOffset[2], m_blendColor[4], m_sampleCoverage[2];
+		bool m_polygonOffsetValid, m_blendColorValid, m_sampleCoverageValid;
+
+		GLuint m_program, m_vao, m_fbo;
+		int m_drawBufferCount;
+		GLenum m_drawBuffers[MaxDrawBuffers];
+		int m_activeUnit;
+		GLenum m_texTarget[MaxTextureUnits];
+		GLuint m_texture[MaxTextureUnits];
+	};
+}
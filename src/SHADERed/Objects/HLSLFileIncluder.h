@@ -37,10 +37,12 @@
 #pragma once
 
 #include <algorithm>
-#include <fstream>
 #include <string>
 #include <vector>
+#include <string.h>
 
+#include <SHADERed/Objects/DependencyGraph.h>
+#include <SHADERed/Objects/IncludeCache.h>
 #include <glslang/Public/ShaderLang.h>
 
 namespace ed {
@@ -109,10 +111,11 @@ namespace ed {
 			for (auto it = directoryStack.rbegin(); it != directoryStack.rend(); ++it) {
 				std::string path = *it + '/' + headerName;
 				std::replace(path.begin(), path.end(), '\\', '/');
-				std::ifstream file(path, std::ios_base::binary | std::ios_base::ate);
-				if (file) {
+				std::string content, key = DependencyGraph::Normalize(path);
+				if (IncludeCache::Instance().Get(key, content)) {
 					directoryStack.push_back(getDirectory(path));
-					return newIncludeResult(path, file, (int)file.tellg());
+					DependencyGraph::Instance().AddFile(key);
+					return newIncludeResult(path, content);
 				}
 			}
 
@@ -126,12 +129,12 @@ namespace ed {
 			return this->readLocalPath(headerName, "", 1);
 		}
 
-		// Do actual reading of the file, filling in a new include result.
-		virtual IncludeResult* newIncludeResult(const std::string& path, std::ifstream& file, int length) const
+		// Fill in a new include result with the (cached) file content.
+		virtual IncludeResult* newIncludeResult(const std::string& path, const std::string& source) const
 		{
+			size_t length = source.size();
 			char* content = new tUserDataElement[length];
-			file.seekg(0, file.beg);
-			file.read(content, length);
+			memcpy(content, source.data(), length);
 			return new IncludeResult(path, content, length, content);
 		}
 
@@ -0,0 +1,50 @@
+#include <SHADERed/Objects/IncludeCache.h>
+
+#include <fstream>
+
+namespace ed {
+	bool IncludeCache::Get(const std::string& path, std::string& out)
+	{
+		std::error_code errCode;
+		std::filesystem::file_time_type time = std::filesystem::last_write_time(path, errCode);
+		if (errCode) {
+			Invalidate(path);
+			return false;
+		}
+		uintmax_t size = std::filesystem::file_size(path, errCode);
+		if (errCode) {
+			Invalidate(path);
+			return false;
+		}
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		auto it = m_files.find(path);
+		if (it != m_files.end() && it->second.Time == time && it->second.Size == size) {
+			out = it->second.Content;
+			return true;
+		}
+
+		std::ifstream file(path, std::ios_base::binary);
+		if (!file.is_open())
+			return false;
+
+		Entry& entry = m_files[path];
+		entry.Time = time;
+		entry.Size = size;
+		entry.Content = std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+		out = entry.Content;
+		return true;
+	}
+	void IncludeCache::Invalidate(const std::string& path)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_files.erase(path);
+	}
+	void IncludeCache::Clear()
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_files.clear();
+	}
+}
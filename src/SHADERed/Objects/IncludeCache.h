@@ -0,0 +1,35 @@
+#pragma once
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace ed {
+	/* Contents of the files pulled in through #include, shared between all shader compiles.
+	   An entry is reloaded when the file's modification time or size changes or when
+	   the file watcher reports that it was modified. */
+	class IncludeCache {
+	public:
+		static IncludeCache& Instance()
+		{
+			static IncludeCache ret;
+			return ret;
+		}
+
+		// copies the file's content to out - returns false if the file doesn't exist
+		bool Get(const std::string& path, std::string& out);
+
+		void Invalidate(const std::string& path);
+		void Clear();
+
+	private:
+		struct Entry {
+			std::filesystem::file_time_type Time;
+			uintmax_t Size;
+			std::string Content;
+		};
+
+		std::mutex m_mutex;
+		std::unordered_map<std::string, Entry> m_files;
+	};
+}
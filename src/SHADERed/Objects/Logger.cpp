@@ -1,71 +1,245 @@
 #include <SHADERed/Objects/Logger.h>
 #include <SHADERed/Objects/Settings.h>
+#include <algorithm>
+#include <chrono>
 #include <ctime>
-#include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <sstream>
+#include <string.h>
 
 namespace ed {
-	void Logger::Log(const std::string& msg, bool error, const std::string& file, int line)
+	static const char* LevelNames[] = { "DEBUG", "INFO", "WARNING", "ERROR" };
+	static const char* CategoryNames[] = { "", "Render", "Shader", "Project", "Objects", "Plugin", "Export" };
+
+	static void copyTruncated(char* dst, size_t dstSize, const std::string& src)
 	{
-		if (!Settings::Instance().General.Log)
-			return;
+		size_t len = std::min<size_t>(src.size(), dstSize - 1);
+		memcpy(dst, src.c_str(), len);
+		dst[len] = 0;
 
-		time_t now = time(0);
-		tm* ltm = localtime(&now);
+		if (len < src.size() && dstSize > 4)
+			memcpy(dst + dstSize - 4, "...", 4);
+	}
 
-		std::stringstream data;
+	Logger::Logger()
+	{
+		Stack = nullptr;
 
-		// time
-		data << "[" << std::setw(2) << std::setfill('0') << ltm->tm_hour << ":" << std::setw(2) << std::setfill('0') << ltm->tm_min << ":" << std::setw(2) << std::setfill('0') << ltm->tm_sec << "] ";
+		m_ring = new Record[RingSize];
+		for (int i = 0; i < RingSize; i++)
+			m_ring[i].Sequence = i;
 
-		// file and line
-		if (file.size() != 0)
-			data << "<" << file;
+		m_head = 0;
+		m_written = 0;
+		m_dropped = 0;
+		for (int i = 0; i < (int)Category::Count; i++)
+			m_minLevel[i] = (int)Level::Info;
 
-		if (line != -1) {
-			if (file.size() == 0)
-				data << "<";
-			else
-				data << " ";
-			data << "at line " << line;
+		m_running = true;
+		m_flushRequest = false;
+		m_writer = new std::thread(&Logger::m_write, this);
+	}
+	Logger::~Logger()
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_running = false;
 		}
+		m_wake.notify_one();
 
-		if (file.size() != 0 || line != -1)
-			data << "> ";
+		m_writer->join();
+		delete m_writer;
+		delete[] m_ring;
+	}
 
-		// error
-		if (error)
-			data << "(ERROR) ";
+	void Logger::Log(const std::string& msg, bool error, const std::string& file, int line)
+	{
+		Log(Category::General, error ? Level::Error : Level::Info, msg, file, line);
+	}
+	void Logger::Log(Category cat, Level level, const std::string& msg, const std::string& file, int line)
+	{
+		Settings& settings = Settings::Instance();
+		if (!settings.General.Log || (int)level < m_minLevel[(int)cat])
+			return;
 
-		// message
-		data << msg;
+		// claim a slot - a slot is free once its sequence number equals the position
+		unsigned int pos = m_head.load(std::memory_order_relaxed);
+		Record* rec = nullptr;
+		while (true) {
+			rec = &m_ring[pos & (RingSize - 1)];
+			unsigned int seq = rec->Sequence.load(std::memory_order_acquire);
+			int diff = (int)(seq - pos);
+
+			if (diff == 0) {
+				if (m_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+					break;
+			} else if (diff < 0) {
+				m_dropped.fetch_add(1, std::memory_order_relaxed); // writer can't keep up
+				return;
+			} else
+				pos = m_head.load(std::memory_order_relaxed);
+		}
 
-		if (Settings::Instance().General.PipeLogsToTerminal)
-			std::cout << data.str() << std::endl;
+		rec->Time = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+		rec->Level = (char)level;
+		rec->Category = (char)cat;
+		rec->Stream = settings.General.StreamLogs;
+		rec->Pipe = settings.General.PipeLogsToTerminal;
+		rec->Line = line;
+		copyTruncated(rec->File, sizeof(rec->File), file);
+		copyTruncated(rec->Text, sizeof(rec->Text), msg);
 
-		if (Settings::Instance().General.StreamLogs) {
-			std::ofstream log("log.txt", std::ios_base::app | std::ios_base::out);
-			log << data.str() << std::endl;
-			log.close();
-		} else
-			m_msgs.push_back(data.str());
+		// publish
+		rec->Sequence.store(pos + 1, std::memory_order_release);
+
+		// wake the writer early for errors (we might be about to crash) & when the ring is filling up
+		if (level == Level::Error || pos - m_written.load(std::memory_order_relaxed) == RingSize / 2)
+			m_wake.notify_one();
+	}
+	void Logger::Flush()
+	{
+		unsigned int target = m_head.load(std::memory_order_acquire);
+
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_flushRequest = true;
+		m_wake.notify_one();
+		m_drained.wait(lock, [&]() { return (int)(m_written.load() - target) >= 0 || !m_running; });
 	}
 	void Logger::Save()
 	{
 		if (!Settings::Instance().General.Log || Settings::Instance().General.StreamLogs)
 			return;
 
+		Flush();
+
 		time_t now = time(0);
 		tm* ltm = localtime(&now);
 
+		std::lock_guard<std::mutex> lock(m_mutex); // writer only touches the history while holding the lock
+
 		std::ofstream file("log.txt");
 		file << "Log -> " << ltm->tm_mday << "." << ltm->tm_mon + 1 << "." << 1900 + ltm->tm_year << "\n";
 
-		for (auto& line : m_msgs)
+		for (auto& line : m_history)
 			file << line << std::endl;
 
 		file.close();
 	}
-}
\ No newline at end of file
+
+	void Logger::m_write()
+	{
+		std::string line;
+		unsigned int lastDropped = 0;
+
+		while (true) {
+			bool running = true;
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				if (m_running && !m_flushRequest)
+					m_wake.wait_for(lock, std::chrono::milliseconds(100));
+				m_flushRequest = false;
+				running = m_running;
+			}
+
+			// drain everything that was published
+			bool streamed = false;
+			unsigned int pos = m_written.load(std::memory_order_relaxed);
+			while (true) {
+				Record& rec = m_ring[pos & (RingSize - 1)];
+				if (rec.Sequence.load(std::memory_order_acquire) != pos + 1)
+					break;
+
+				m_format(rec, line);
+				bool stream = rec.Stream, pipe = rec.Pipe;
+
+				// hand the slot back to the producers
+				rec.Sequence.store(pos + RingSize, std::memory_order_release);
+				pos++;
+
+				if (pipe)
+					std::cout << line << '\n';
+
+				if (stream) {
+					if (!m_stream.is_open())
+						m_stream.open("log.txt", std::ios_base::app | std::ios_base::out);
+					m_stream << line << '\n';
+					streamed = true;
+				} else {
+					std::lock_guard<std::mutex> lock(m_mutex);
+					m_history.push_back(line);
+					if (m_history.size() > HistorySize)
+						m_history.pop_front();
+				}
+			}
+
+			unsigned int dropped = m_dropped.load(std::memory_order_relaxed);
+			if (dropped != lastDropped) {
+				line = "(WARNING) " + std::to_string(dropped - lastDropped) + " log messages were dropped";
+				if (m_stream.is_open()) {
+					m_stream << line << '\n';
+					streamed = true;
+				} else {
+					std::lock_guard<std::mutex> lock(m_mutex);
+					m_history.push_back(line);
+				}
+				lastDropped = dropped;
+			}
+
+			if (streamed)
+				m_stream.flush();
+			std::cout.flush();
+
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_written.store(pos, std::memory_order_release);
+			}
+			m_drained.notify_all();
+
+			if (!running)
+				break;
+		}
+
+		if (m_stream.is_open())
+			m_stream.close();
+	}
+	void Logger::m_format(const Record& rec, std::string& out)
+	{
+		time_t secs = (time_t)(rec.Time / 1000000);
+		int micros = (int)(rec.Time % 1000000);
+		tm* ltm = localtime(&secs);
+
+		std::stringstream data;
+
+		// time
+		data << "[" << std::setw(2) << std::setfill('0') << ltm->tm_hour << ":" << std::setw(2) << std::setfill('0') << ltm->tm_min << ":" << std::setw(2) << std::setfill('0') << ltm->tm_sec << "." << std::setw(6) << std::setfill('0') << micros << "] ";
+
+		// subsystem
+		if (rec.Category != (char)Category::General)
+			data << "[" << CategoryNames[(int)rec.Category] << "] ";
+
+		// file and line
+		if (rec.File[0] != 0)
+			data << "<" << rec.File;
+
+		if (rec.Line != -1) {
+			if (rec.File[0] == 0)
+				data << "<";
+			else
+				data << " ";
+			data << "at line " << rec.Line;
+		}
+
+		if (rec.File[0] != 0 || rec.Line != -1)
+			data << "> ";
+
+		// level
+		if (rec.Level != (char)Level::Info)
+			data << "(" << LevelNames[(int)rec.Level] << ") ";
+
+		// message
+		data << rec.Text;
+
+		out = data.str();
+	}
+}
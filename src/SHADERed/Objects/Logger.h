@@ -1,16 +1,40 @@
 #pragma once
 #include <SHADERed/Objects/MessageStack.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <mutex>
 #include <string>
+#include <thread>
 
 namespace ed {
+	/* Log() only copies the message into a fixed size ring buffer - formatting, terminal
+	   and file output happen on a background thread. Any thread can log. When the ring
+	   is full, messages are dropped (and counted) instead of blocking the caller. */
 	class Logger {
 	public:
+		enum class Level {
+			Debug,
+			Info,
+			Warning,
+			Error
+		};
+		enum class Category {
+			General,
+			Render,
+			Shader,
+			Project,
+			Objects,
+			Plugin,
+			Export,
+			Count
+		};
+
 		MessageStack* Stack;
 
-		Logger()
-		{
-			Stack = nullptr;
-		}
+		Logger();
+		~Logger();
 
 		static Logger& Get()
 		{
@@ -19,9 +43,49 @@ namespace ed {
 		}
 
 		void Log(const std::string& msg, bool error = false, const std::string& file = "", int line = -1);
+		void Log(Category cat, Level level, const std::string& msg, const std::string& file = "", int line = -1);
+
+		// messages below this level are ignored - Info by default
+		inline void SetLevel(Category cat, Level level) { m_minLevel[(int)cat] = (int)level; }
+		inline Level GetLevel(Category cat) { return (Level)m_minLevel[(int)cat].load(); }
+
+		// wait until everything logged so far has been written out
+		void Flush();
 		void Save();
 
+		inline unsigned int GetDroppedCount() { return m_dropped; }
+
+		static const int RingSize = 1024;  // messages, must be a power of two
+		static const int MessageSize = 512; // longer messages are truncated
+		static const int HistorySize = 4096; // lines kept for Save() when logs aren't streamed
+
 	private:
-		std::vector<std::string> m_msgs;
+		struct Record {
+			std::atomic<unsigned int> Sequence;
+			long long Time; // microseconds since epoch
+			char Level, Category;
+			bool Stream, Pipe;
+			int Line;
+			char File[128];
+			char Text[MessageSize];
+		};
+
+		void m_write();
+		void m_format(const Record& rec, std::string& out);
+
+		Record* m_ring;
+		std::atomic<unsigned int> m_head;	 // next slot producers claim
+		std::atomic<unsigned int> m_written; // slots processed by the writer
+		std::atomic<unsigned int> m_dropped;
+		std::atomic<int> m_minLevel[(int)Category::Count];
+
+		std::thread* m_writer;
+		std::mutex m_mutex;
+		std::condition_variable m_wake, m_drained;
+		bool m_running, m_flushRequest;
+
+		// only touched by the writer thread (and by Save() after a flush)
+		std::ofstream m_stream;
+		std::deque<std::string> m_history;
 	};
-}
\ No newline at end of file
+}
@@ -1,64 +1,148 @@
 #include <SHADERed/Objects/MessageStack.h>
+#include <algorithm>
 
 namespace ed {
 	MessageStack::MessageStack()
 	{
 		BuildOccured = false;
+		m_count[0] = m_count[1] = m_count[2] = 0;
+		m_generation = 1;
+		m_allGeneration = 0;
 	}
 	MessageStack::~MessageStack()
 	{
 	}
 	void MessageStack::Add(const std::vector<Message>& msgs)
 	{
-		m_msgs.insert(m_msgs.end(), msgs.begin(), msgs.end());
+		for (const auto& msg : msgs)
+			m_add(msg);
+		m_generation++;
 	}
 	void MessageStack::Add(Type type, const std::string& group, const std::string& message, int ln, ShaderStage sh)
 	{
-		m_msgs.push_back({ type, group, message, ln, sh });
+		m_add({ type, group, message, ln, sh });
+		m_generation++;
 	}
 	void MessageStack::ClearGroup(const std::string& group, int type)
 	{
-		for (int i = 0; i < m_msgs.size(); i++)
-			if (m_msgs[i].Group == group && (type == -1 || m_msgs[i].MType == (ed::MessageStack::Type)type)) {
-				m_msgs.erase(m_msgs.begin() + i);
-				i--;
-			}
+		auto it = m_groups.find(group);
+		if (it == m_groups.end())
+			return;
+
+		Group& grp = it->second;
+		if (type == -1) {
+			for (int i = 0; i < 3; i++)
+				m_count[i] -= grp.Count[i];
+			m_groups.erase(it);
+			m_order.erase(std::remove(m_order.begin(), m_order.end(), group), m_order.end());
+		} else {
+			if (grp.Count[type] == 0)
+				return;
+
+			grp.Messages.erase(std::remove_if(grp.Messages.begin(), grp.Messages.end(), [&](const Message& msg) {
+				return msg.MType == (Type)type;
+			}), grp.Messages.end());
+			m_count[type] -= grp.Count[type];
+			grp.Count[type] = 0;
+		}
+
+		m_generation++;
+	}
+	void MessageStack::Clear()
+	{
+		if (m_groups.empty())
+			return;
+
+		m_groups.clear();
+		m_order.clear();
+		m_count[0] = m_count[1] = m_count[2] = 0;
+		m_generation++;
 	}
 	int MessageStack::GetGroupWarningMsgCount(const std::string& group)
 	{
-		int cnt = 0;
-		for (int i = 0; i < m_msgs.size(); i++)
-			if (m_msgs[i].Group == group && m_msgs[i].MType == ed::MessageStack::Type::Warning)
-				cnt++;
-		return cnt;
+		auto it = m_groups.find(group);
+		if (it == m_groups.end())
+			return 0;
+		return it->second.Count[(int)Type::Warning];
 	}
 	int MessageStack::GetErrorAndWarningMsgCount()
 	{
-		int cnt = 0;
-		for (int i = 0; i < m_msgs.size(); i++)
-			if (m_msgs[i].MType == ed::MessageStack::Type::Warning || m_msgs[i].MType == ed::MessageStack::Type::Error)
-				cnt++;
-		return cnt;
+		return m_count[(int)Type::Warning] + m_count[(int)Type::Error];
 	}
 	int MessageStack::GetGroupErrorAndWarningMsgCount(const std::string& group)
 	{
-		int cnt = 0;
-		for (int i = 0; i < m_msgs.size(); i++)
-			if ((m_msgs[i].MType == ed::MessageStack::Type::Warning || m_msgs[i].MType == ed::MessageStack::Type::Error) && m_msgs[i].Group == group)
-				cnt++;
-		return cnt;
+		auto it = m_groups.find(group);
+		if (it == m_groups.end())
+			return 0;
+		return it->second.Count[(int)Type::Warning] + it->second.Count[(int)Type::Error];
 	}
 	void MessageStack::RenameGroup(const std::string& group, const std::string& newName)
 	{
-		for (int i = 0; i < m_msgs.size(); i++)
-			if (m_msgs[i].Group == group)
-				m_msgs[i].Group = newName;
+		auto it = m_groups.find(group);
+		if (it == m_groups.end() || group == newName)
+			return;
+
+		Group grp = std::move(it->second);
+		m_groups.erase(it);
+		for (auto& msg : grp.Messages)
+			msg.Group = newName;
+
+		auto dstIt = m_groups.find(newName);
+		if (dstIt == m_groups.end()) {
+			std::replace(m_order.begin(), m_order.end(), group, newName);
+			m_groups[newName] = std::move(grp);
+		} else {
+			// merge with the messages that already exist under the new name
+			Group& dst = dstIt->second;
+			dst.Messages.insert(dst.Messages.end(), grp.Messages.begin(), grp.Messages.end());
+			for (int i = 0; i < 3; i++)
+				dst.Count[i] += grp.Count[i];
+			m_order.erase(std::remove(m_order.begin(), m_order.end(), group), m_order.end());
+		}
+
+		m_generation++;
 	}
 	bool MessageStack::CanRenderPreview()
 	{
-		for (int i = 0; i < m_msgs.size(); i++)
-			if (m_msgs[i].MType == Type::Error)
-				return false;
-		return true;
+		return m_count[(int)Type::Error] == 0;
+	}
+	const std::vector<MessageStack::Message>& MessageStack::GetMessages()
+	{
+		if (m_allGeneration != m_generation) {
+			m_all.clear();
+			for (const auto& name : m_order) {
+				const Group& grp = m_groups[name];
+				m_all.insert(m_all.end(), grp.Messages.begin(), grp.Messages.end());
+			}
+			m_allGeneration = m_generation;
+		}
+
+		return m_all;
+	}
+	const std::vector<MessageStack::Message>& MessageStack::GetGroupMessages(const std::string& group)
+	{
+		auto it = m_groups.find(group);
+		if (it == m_groups.end())
+			return m_empty;
+		return it->second.Messages;
+	}
+
+	MessageStack::Group& MessageStack::m_getGroup(const std::string& name)
+	{
+		auto it = m_groups.find(name);
+		if (it != m_groups.end())
+			return it->second;
+
+		m_order.push_back(name);
+		Group& grp = m_groups[name];
+		grp.Count[0] = grp.Count[1] = grp.Count[2] = 0;
+		return grp;
+	}
+	void MessageStack::m_add(const Message& msg)
+	{
+		Group& grp = m_getGroup(msg.Group);
+		grp.Messages.push_back(msg);
+		grp.Count[(int)msg.MType]++;
+		m_count[(int)msg.MType]++;
 	}
-}
\ No newline at end of file
+}
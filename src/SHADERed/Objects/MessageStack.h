@@ -1,9 +1,12 @@
 #pragma once
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include <SHADERed/Objects/ShaderStage.h>
 
 namespace ed {
+	/* Messages are stored per group (pipeline item) together with per type counters, so
+	   the UI can query a group every frame without scanning all messages. */
 	class MessageStack {
 	public:
 		MessageStack();
@@ -46,7 +49,7 @@ namespace ed {
 		void Add(const std::vector<Message>& msgs);
 		void Add(Type type, const std::string& group, const std::string& message, int ln = -1, ShaderStage sh = ShaderStage::Count);
 		void ClearGroup(const std::string& group, int type = -1);
-		inline void Clear() { m_msgs.clear(); }
+		void Clear();
 		int GetGroupWarningMsgCount(const std::string& group);
 		int GetErrorAndWarningMsgCount();
 		int GetGroupErrorAndWarningMsgCount(const std::string& group);
@@ -54,9 +57,28 @@ namespace ed {
 
 		bool CanRenderPreview();
 
-		inline std::vector<Message>& GetMessages() { return m_msgs; }
+		// all messages, grouped - rebuilt only after something changed
+		const std::vector<Message>& GetMessages();
+		const std::vector<Message>& GetGroupMessages(const std::string& group);
+
+		// incremented on every change, views can skip rebuilding their data while it stays the same
+		inline unsigned int GetGeneration() { return m_generation; }
 
 	private:
-		std::vector<Message> m_msgs;
+		struct Group {
+			std::vector<Message> Messages;
+			int Count[3]; // per Type
+		};
+		Group& m_getGroup(const std::string& name);
+		void m_add(const Message& msg);
+
+		std::unordered_map<std::string, Group> m_groups;
+		std::vector<std::string> m_order; // groups in the order in which they got their first message
+		int m_count[3];
+		unsigned int m_generation;
+
+		std::vector<Message> m_all;
+		unsigned int m_allGeneration;
+		std::vector<Message> m_empty;
 	};
 }
\ No newline at end of file
@@ -54,6 +54,8 @@ const char* SYSTEM_VARIABLE_NAMES[] = {
 	"KeysWASD",
 	"Mouse",
 	"MouseButton",
+	"ViewportOffset",
+	"IterationIndex",
 	"PluginVariable"
 };
 const char* VARIABLE_TYPE_NAMES[] = {
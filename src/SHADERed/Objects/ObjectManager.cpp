@@ -3,11 +3,14 @@
 #include <SHADERed/Objects/ObjectManager.h>
 #include <SHADERed/Objects/RenderEngine.h>
 #include <SHADERed/Objects/Settings.h>
+#include <SHADERed/Objects/Tracer.h>
 #include <SHADERed/Engine/Model.h>
 
 #include <SFML/Audio/Sound.hpp>
 #include <SFML/Audio/SoundBuffer.hpp>
 
+#include <algorithm>
+#include <filesystem>
 #include <unordered_map>
 #include <fstream>
 
@@ -21,6 +24,8 @@ namespace ed {
 			, m_renderer(rnd)
 	{
 		m_binds.clear();
+		m_unloaded = 0;
+		m_bindsChanged = false;
 		memset(m_kbTexture, 0, sizeof(unsigned char) * 256 * 3);
 	}
 	ObjectManager::~ObjectManager()
@@ -30,6 +35,8 @@ namespace ed {
 
 	void loadCubemapFace(GLuint face, const std::string& path, int& w, int& h)
 	{
+		TraceScope trace("Objects", "Load cubemap face", path);
+
 		stbi_set_flip_vertically_on_load(0);
 
 		int nrChannels = 0;
@@ -66,7 +73,7 @@ namespace ed {
 
 	void ObjectManager::Clear()
 	{
-		Logger::Get().Log("Clearing ObjectManager contents...");
+		Logger::Get().Log(Logger::Category::Objects, Logger::Level::Info, "Clearing ObjectManager contents...");
 
 		for (int i = 0; i < m_itemData.size(); i++) {
 			if (m_itemData[i]->Plugin != nullptr) {
@@ -81,13 +88,16 @@ namespace ed {
 		m_uniformBinds.clear();
 		m_items.clear();
 		m_itemData.clear();
+		m_pingPong.clear();
+		m_unloaded = 0;
+		m_bindsChanged = false;
 	}
 	bool ObjectManager::CreateRenderTexture(const std::string& name)
 	{
-		Logger::Get().Log("Creating a render texture " + name + " ...");
+		Logger::Get().Log(Logger::Category::Objects, Logger::Level::Info, "Creating a render texture " + name + " ...");
 
 		if (name.size() == 0 || Exists(name)) {
-			Logger::Get().Log("Cannot create a render texture " + name + " because a rt with such name already exists", true);
+			Logger::Get().Log(Logger::Category::Objects, Logger::Level::Error, "Cannot create a render texture " + name + " because a rt with such name already exists");
 			return false;
 		}
 
@@ -136,23 +146,33 @@ namespace ed {
 
 		return true;
 	}
-	bool ObjectManager::CreateTexture(const std::string& file)
+	bool ObjectManager::CreateTexture(const std::string& file, bool lazy)
 	{
-		Logger::Get().Log("Creating a texture " + file + " ...");
+		Logger::Get().Log(Logger::Category::Objects, Logger::Level::Info, "Creating a texture " + file + " ...");
 
 		if (Exists(file)) {
-			Logger::Get().Log("Cannot create a texture " + file + " because that texture is already added to the project", true);
+			Logger::Get().Log(Logger::Category::Objects, Logger::Level::Error, "Cannot create a texture " + file + " because that texture is already added to the project");
 			return false;
 		}
 
+		TraceScope trace("Objects", "Load texture", file);
+
 		stbi_set_flip_vertically_on_load(1);
 
 		std::string path = m_parser->GetProjectPath(file);
 		int width, height, nrChannels;
-		unsigned char* data = stbi_load(path.c_str(), &width, &height, &nrChannels, STBI_rgb_alpha);
+		unsigned char* data = nullptr;
+		bool valid = false;
+		if (lazy)
+			valid = stbi_info(path.c_str(), &width, &height, &nrChannels); // only reads the header
+		else {
+			TraceScope traceDecode("Objects", "Decode image", path);
+			data = stbi_load(path.c_str(), &width, &height, &nrChannels, STBI_rgb_alpha);
+			valid = data != nullptr;
+		}
 		
-		if (data == nullptr) {
-			Logger::Get().Log("Failed to load a texture " + file + " from file", true);
+		if (!valid) {
+			Logger::Get().Log(Logger::Category::Objects, Logger::Level::Error, "Failed to load a texture " + file + " from file");
 			return false;
 		}
 
@@ -163,56 +183,34 @@ namespace ed {
 		m_items.push_back(file);
 
 		item->IsTexture = true;
+		item->ImageSize = glm::ivec2(width, height);
 
-		// normal texture
 		glGenTextures(1, &item->Texture);
-		glBindTexture(GL_TEXTURE_2D, item->Texture);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, item->Texture_MinFilter);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, item->Texture_MagFilter);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, item->Texture_WrapS);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, item->Texture_WrapT);
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-		glGenerateMipmap(GL_TEXTURE_2D);
-		glBindTexture(GL_TEXTURE_2D, 0);
-
-		// flipped texture
-		unsigned char* flippedData = (unsigned char*)malloc(width * height * 4);
-
-		for (int x = 0; x < width; x++) {
-			for (int y = 0; y < height; y++) {
-				flippedData[(y * width + x) * 4 + 0] = data[((height - y - 1) * width + x) * 4 + 0];
-				flippedData[(y * width + x) * 4 + 1] = data[((height - y - 1) * width + x) * 4 + 1];
-				flippedData[(y * width + x) * 4 + 2] = data[((height - y - 1) * width + x) * 4 + 2];
-				flippedData[(y * width + x) * 4 + 3] = data[((height - y - 1) * width + x) * 4 + 3];
-			}
-		}
-
 		glGenTextures(1, &item->FlippedTexture);
-		glBindTexture(GL_TEXTURE_2D, item->FlippedTexture);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, item->Texture_MinFilter);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, item->Texture_MagFilter);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, item->Texture_WrapS);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, item->Texture_WrapT);
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, flippedData);
-		glGenerateMipmap(GL_TEXTURE_2D);
-		glBindTexture(GL_TEXTURE_2D, 0);
 
-		item->ImageSize = glm::ivec2(width, height);
+		if (lazy) {
+			item->IsLoaded = false;
+			m_unloaded++;
+			m_bindsChanged = true;
+			return true;
+		}
 
-		free(flippedData);
+		m_uploadTexture(item, data, width, height);
 		stbi_image_free(data);
 
 		return true;
 	}
-	bool ObjectManager::CreateCubemap(const std::string& name, const std::string& left, const std::string& top, const std::string& front, const std::string& bottom, const std::string& right, const std::string& back)
+	bool ObjectManager::CreateCubemap(const std::string& name, const std::string& left, const std::string& top, const std::string& front, const std::string& bottom, const std::string& right, const std::string& back, bool lazy)
 	{
-		Logger::Get().Log("Creating a cubemap " + name + " ...");
+		Logger::Get().Log(Logger::Category::Objects, Logger::Level::Info, "Creating a cubemap " + name + " ...");
 
 		if (Exists(name)) {
-			Logger::Get().Log("Cannot create a cubemap " + name + " because cubemap with such name already exists in the project", true);
+			Logger::Get().Log(Logger::Category::Objects, Logger::Level::Error, "Cannot create a cubemap " + name + " because cubemap with such name already exists in the project");
 			return false;
 		}
 
+		TraceScope trace("Objects", "Load cubemap", name);
+
 		m_parser->ModifyProject();
 
 		ObjectManagerItem* item = new ObjectManagerItem();
@@ -220,65 +218,56 @@ namespace ed {
 		m_items.push_back(name);
 
 		item->IsCube = true;
+		item->CubemapPaths = { left, top, front, bottom, right, back };
 
 		glGenTextures(1, &item->Texture);
-		glBindTexture(GL_TEXTURE_CUBE_MAP, item->Texture);
-		int width, height;
-
-		// properties
-		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
-
-		// left face
-		loadCubemapFace(GL_TEXTURE_CUBE_MAP_NEGATIVE_X, m_parser->GetProjectPath(left), width, height);
-		item->CubemapPaths.push_back(left);
 
-		// top
-		loadCubemapFace(GL_TEXTURE_CUBE_MAP_POSITIVE_Y, m_parser->GetProjectPath(top), width, height);
-		item->CubemapPaths.push_back(top);
+		if (lazy) {
+			int width = 0, height = 0, nrChannels = 0;
+			stbi_info(m_parser->GetProjectPath(left).c_str(), &width, &height, &nrChannels);
+			item->ImageSize = glm::ivec2(width, height);
 
-		// front
-		loadCubemapFace(GL_TEXTURE_CUBE_MAP_NEGATIVE_Z, m_parser->GetProjectPath(front), width, height);
-		item->CubemapPaths.push_back(front);
-
-		// bottom
-		loadCubemapFace(GL_TEXTURE_CUBE_MAP_NEGATIVE_Y, m_parser->GetProjectPath(bottom), width, height);
-		item->CubemapPaths.push_back(bottom);
-
-		// right
-		loadCubemapFace(GL_TEXTURE_CUBE_MAP_POSITIVE_X, m_parser->GetProjectPath(right), width, height);
-		item->CubemapPaths.push_back(right);
-
-		// back
-		loadCubemapFace(GL_TEXTURE_CUBE_MAP_POSITIVE_Z, m_parser->GetProjectPath(back), width, height);
-		item->CubemapPaths.push_back(back);
+			item->IsLoaded = false;
+			m_unloaded++;
+			m_bindsChanged = true;
+			return true;
+		}
 
-		// clean up
-		glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
-		item->ImageSize = glm::ivec2(width, height);
+		m_loadCubemap(item);
 
 		return true;
 	}
-	bool ObjectManager::CreateAudio(const std::string& file)
+	bool ObjectManager::CreateAudio(const std::string& file, bool lazy)
 	{
-		Logger::Get().Log("Creating audio object from file " + file + " ...");
+		Logger::Get().Log(Logger::Category::Objects, Logger::Level::Info, "Creating audio object from file " + file + " ...");
 
 		if (Exists(file)) {
-			Logger::Get().Log("Audio object " + file + " already exists in the project", true);
+			Logger::Get().Log(Logger::Category::Objects, Logger::Level::Error, "Audio object " + file + " already exists in the project");
 			return false;
 		}
 
+		TraceScope trace("Objects", "Load audio", file);
+
 		ObjectManagerItem* item = new ObjectManagerItem();
 
 		item->SoundBuffer = new sf::SoundBuffer();
-		bool loaded = item->SoundBuffer->loadFromFile(m_parser->GetProjectPath(file));
-		if (!loaded) {
-			delete item;
-			ed::Logger::Get().Log("Failed to load an audio file " + file, true);
-			return false;
+		if (lazy) {
+			if (!std::filesystem::exists(m_parser->GetProjectPath(file))) {
+				delete item;
+				ed::Logger::Get().Log(Logger::Category::Objects, Logger::Level::Error, "Failed to load an audio file " + file);
+				return false;
+			}
+
+			item->IsLoaded = false;
+			m_unloaded++;
+			m_bindsChanged = true;
+		} else {
+			bool loaded = item->SoundBuffer->loadFromFile(m_parser->GetProjectPath(file));
+			if (!loaded) {
+				delete item;
+				ed::Logger::Get().Log(Logger::Category::Objects, Logger::Level::Error, "Failed to load an audio file " + file);
+				return false;
+			}
 		}
 
 		m_itemData.push_back(item);
@@ -295,19 +284,21 @@ namespace ed {
 		glBindTexture(GL_TEXTURE_2D, 0);
 
 		item->Sound = new sf::Sound();
-		item->Sound->setBuffer(*(item->SoundBuffer));
 		item->Sound->setLoop(true);
-		item->Sound->play();
 		item->SoundMuted = false;
+		if (item->IsLoaded) {
+			item->Sound->setBuffer(*(item->SoundBuffer));
+			item->Sound->play();
+		}
 
 		return true;
 	}
 	bool ObjectManager::CreateBuffer(const std::string& name)
 	{
-		Logger::Get().Log("Creating a buffer " + name + " ...");
+		Logger::Get().Log(Logger::Category::Objects, Logger::Level::Info, "Creating a buffer " + name + " ...");
 
 		if (name.size() == 0 || Exists(name)) {
-			Logger::Get().Log("Cannot create the buffer " + name + " because an item with such name already exists", true);
+			Logger::Get().Log(Logger::Category::Objects, Logger::Level::Error, "Cannot create the buffer " + name + " because an item with such name already exists");
 			return false;
 		}
 
@@ -334,10 +325,10 @@ namespace ed {
 	}
 	bool ObjectManager::CreateImage(const std::string& name, glm::ivec2 size)
 	{
-		Logger::Get().Log("Creating an image " + name + " ...");
+		Logger::Get().Log(Logger::Category::Objects, Logger::Level::Info, "Creating an image " + name + " ...");
 
 		if (name.size() == 0 || Exists(name)) {
-			Logger::Get().Log("Cannot create the image " + name + " because an item with exact name already exists", true);
+			Logger::Get().Log(Logger::Category::Objects, Logger::Level::Error, "Cannot create the image " + name + " because an item with exact name already exists");
 			return false;
 		}
 
@@ -364,10 +355,10 @@ namespace ed {
 	}
 	bool ObjectManager::CreateImage3D(const std::string& name, glm::ivec3 size)
 	{
-		Logger::Get().Log("Creating an image " + name + " ...");
+		Logger::Get().Log(Logger::Category::Objects, Logger::Level::Info, "Creating an image " + name + " ...");
 
 		if (name.size() == 0 || Exists(name)) {
-			Logger::Get().Log("Cannot create the image " + name + " because an item with exact name already exists", true);
+			Logger::Get().Log(Logger::Category::Objects, Logger::Level::Error, "Cannot create the image " + name + " because an item with exact name already exists");
 			return false;
 		}
 
@@ -392,10 +383,10 @@ namespace ed {
 	}
 	bool ObjectManager::CreatePluginItem(const std::string& name, const std::string& objtype, void* data, GLuint id, IPlugin1* owner)
 	{
-		Logger::Get().Log("Creating a plugin object " + name + " of type " + objtype + "...");
+		Logger::Get().Log(Logger::Category::Objects, Logger::Level::Info, "Creating a plugin object " + name + " of type " + objtype + "...");
 
 		if (name.size() == 0 || Exists(name)) {
-			Logger::Get().Log("Cannot create the plugin object " + name + " because an item with that name already exists", true);
+			Logger::Get().Log(Logger::Category::Objects, Logger::Level::Error, "Cannot create the plugin object " + name + " because an item with that name already exists");
 			return false;
 		}
 
@@ -415,10 +406,10 @@ namespace ed {
 	}
 	bool ObjectManager::CreateKeyboardTexture(const std::string& name)
 	{
-		Logger::Get().Log("Creating a keyboard texture " + name + " ...");
+		Logger::Get().Log(Logger::Category::Objects, Logger::Level::Info, "Creating a keyboard texture " + name + " ...");
 
 		if (name.size() == 0 || Exists(name)) {
-			Logger::Get().Log("Cannot create a keyboard texture " + name + " because an object with that name already exists", true);
+			Logger::Get().Log(Logger::Category::Objects, Logger::Level::Error, "Cannot create a keyboard texture " + name + " because an object with that name already exists");
 			return false;
 		}
 
@@ -543,10 +534,7 @@ namespace ed {
 
 			stbi_image_free(data);
 
-			
-			glBindBuffer(GL_UNIFORM_BUFFER, buf->ID);
-			glBufferData(GL_UNIFORM_BUFFER, buf->Size, buf->Data, GL_STATIC_DRAW); // upload data
-			glBindBuffer(GL_UNIFORM_BUFFER, 0);
+			UploadBufferData(buf);
 		}
 
 		return data != nullptr;
@@ -576,9 +564,7 @@ namespace ed {
 					index += 4;
 				}
 
-			glBindBuffer(GL_UNIFORM_BUFFER, buf->ID);
-			glBufferData(GL_UNIFORM_BUFFER, buf->Size, buf->Data, GL_STATIC_DRAW); // upload data
-			glBindBuffer(GL_UNIFORM_BUFFER, 0);
+			UploadBufferData(buf);
 		}
 
 		return ret;
@@ -599,16 +585,195 @@ namespace ed {
 			memcpy(buf->Data, data, bufSize);
 			free(data);
 
-			glBindBuffer(GL_UNIFORM_BUFFER, buf->ID);
-			glBufferData(GL_UNIFORM_BUFFER, buf->Size, buf->Data, GL_STATIC_DRAW); // upload data
-			glBindBuffer(GL_UNIFORM_BUFFER, 0);
+			UploadBufferData(buf);
 		}
 
 		bufRead.close();
 
 		return ret;
 	}
+	void ObjectManager::UploadBufferData(BufferObject* buf)
+	{
+		glBindBuffer(GL_UNIFORM_BUFFER, buf->ID);
+		glBufferData(GL_UNIFORM_BUFFER, buf->Size, buf->Data, GL_STATIC_DRAW); // upload data
+		if (buf->PingPong) {
+			glBindBuffer(GL_UNIFORM_BUFFER, buf->PreviousID);
+			glBufferData(GL_UNIFORM_BUFFER, buf->Size, buf->Data, GL_STATIC_DRAW);
+		}
+		glBindBuffer(GL_UNIFORM_BUFFER, 0);
+	}
+	void ObjectManager::SetPingPong(const std::string& name, bool pingPong)
+	{
+		ObjectManagerItem* item = GetObjectManagerItem(name);
+		if (item == nullptr || (item->RT == nullptr && item->Image == nullptr && item->Buffer == nullptr) || IsPingPong(name) == pingPong)
+			return;
+
+		m_parser->ModifyProject();
+		item->PingPongWritten = false;
+		item->PingPongPending = false;
+
+		if (!pingPong) {
+			m_pingPong.erase(std::remove(m_pingPong.begin(), m_pingPong.end(), item), m_pingPong.end());
+
+			if (item->RT) {
+				glDeleteTextures(1, &item->RT->PreviousBuffer);
+				item->RT->PreviousBuffer = 0;
+				item->RT->PingPong = false;
+			} else if (item->Image) {
+				glDeleteTextures(1, &item->Image->PreviousTexture);
+				item->Image->PreviousTexture = 0;
+				item->Image->PingPong = false;
+			} else {
+				glDeleteBuffers(1, &item->Buffer->PreviousID);
+				item->Buffer->PreviousID = 0;
+				item->Buffer->PingPong = false;
+			}
+			return;
+		}
+
+		m_pingPong.push_back(item);
+
+		// the second copy starts with the same contents
+		if (item->RT) {
+			RenderTextureObject* rtObj = item->RT;
+			glm::ivec2 size = GetRenderTextureSize(name);
+
+			glGenTextures(1, &rtObj->PreviousBuffer);
+			glBindTexture(GL_TEXTURE_2D, rtObj->PreviousBuffer);
+			glTexImage2D(GL_TEXTURE_2D, 0, rtObj->Format, size.x, size.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+			glBindTexture(GL_TEXTURE_2D, 0);
+
+			if (GLEW_VERSION_4_3 || GLEW_ARB_copy_image)
+				glCopyImageSubData(item->Texture, GL_TEXTURE_2D, 0, 0, 0, 0, rtObj->PreviousBuffer, GL_TEXTURE_2D, 0, 0, 0, 0, size.x, size.y, 1);
+
+			rtObj->PingPong = true;
+		} else if (item->Image) {
+			ImageObject* iObj = item->Image;
+
+			glGenTextures(1, &iObj->PreviousTexture);
+			glBindTexture(GL_TEXTURE_2D, iObj->PreviousTexture);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+			glTexImage2D(GL_TEXTURE_2D, 0, iObj->Format, iObj->Size.x, iObj->Size.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+			glBindTexture(GL_TEXTURE_2D, 0);
+
+			if (GLEW_VERSION_4_3 || GLEW_ARB_copy_image)
+				glCopyImageSubData(iObj->Texture, GL_TEXTURE_2D, 0, 0, 0, 0, iObj->PreviousTexture, GL_TEXTURE_2D, 0, 0, 0, 0, iObj->Size.x, iObj->Size.y, 1);
+
+			iObj->PingPong = true;
+		} else {
+			BufferObject* bObj = item->Buffer;
+
+			glGenBuffers(1, &bObj->PreviousID);
+			bObj->PingPong = true;
+
+			UploadBufferData(bObj);
+		}
+	}
+	bool ObjectManager::IsPingPong(const std::string& name)
+	{
+		ObjectManagerItem* item = GetObjectManagerItem(name);
+		return item != nullptr && std::count(m_pingPong.begin(), m_pingPong.end(), item) > 0;
+	}
+	ObjectManagerItem* ObjectManager::GetPingPong(GLuint id, bool isBuffer)
+	{
+		for (ObjectManagerItem* item : m_pingPong)
+			if ((item->Buffer != nullptr) == isBuffer && item->GetHandle() == id)
+				return item;
+		return nullptr;
+	}
+	GLuint ObjectManager::GetPingPongRead(GLuint id, bool isBuffer)
+	{
+		if (m_pingPong.empty())
+			return id;
+
+		ObjectManagerItem* item = GetPingPong(id, isBuffer);
+		if (item == nullptr || item->PingPongWritten)
+			return id;
+
+		return item->GetPreviousHandle();
+	}
+	void ObjectManager::SwapPingPong(ObjectManagerItem* item)
+	{
+		GLuint oldID = item->GetHandle();
+
+		if (item->RT)
+			std::swap(item->Texture, item->RT->PreviousBuffer);
+		else if (item->Image)
+			std::swap(item->Image->Texture, item->Image->PreviousTexture);
+		else if (item->Buffer)
+			std::swap(item->Buffer->ID, item->Buffer->PreviousID);
+
+		item->PingPongWritten = false;
+
+		// bind lists store the written handle
+		GLuint newID = item->GetHandle();
+		std::unordered_map<PipelineItem*, std::vector<GLuint>>* lists[2] = { &m_binds, &m_uniformBinds };
+		for (auto list : lists)
+			for (auto& pair : *list)
+				for (GLuint& id : pair.second)
+					if (id == oldID && (item->Buffer == nullptr || list == &m_uniformBinds))
+						id = newID;
+	}
+
+	bool ObjectManager::Load(ObjectManagerItem* item)
+	{
+		if (item == nullptr || item->IsLoaded)
+			return true;
+
+		// failed files aren't retried every frame
+		item->IsLoaded = true;
+		m_unloaded--;
+
+		std::string name = GetObjectManagerItemName(item);
+		Logger::Get().Log(Logger::Category::Objects, Logger::Level::Info, "Loading " + name + " on demand");
+
+		if (item->IsCube) {
+			TraceScope trace("Objects", "Load cubemap", name);
+			m_loadCubemap(item);
+		} else if (item->SoundBuffer != nullptr) {
+			TraceScope trace("Objects", "Load audio", name);
+			if (!item->SoundBuffer->loadFromFile(m_parser->GetProjectPath(name))) {
+				Logger::Get().Log(Logger::Category::Objects, Logger::Level::Error, "Failed to load an audio file " + name);
+				return false;
+			}
+
+			item->Sound->setBuffer(*(item->SoundBuffer));
+			if (!m_renderer->IsPaused())
+				item->Sound->play();
+		} else if (item->IsTexture) {
+			TraceScope trace("Objects", "Load texture", name);
+
+			stbi_set_flip_vertically_on_load(1);
+
+			std::string path = m_parser->GetProjectPath(name);
+			int width, height, nrChannels;
+			unsigned char* data = stbi_load(path.c_str(), &width, &height, &nrChannels, STBI_rgb_alpha);
+			if (data == nullptr) {
+				Logger::Get().Log(Logger::Category::Objects, Logger::Level::Error, "Failed to load a texture " + name + " from file");
+				return false;
+			}
+
+			m_uploadTexture(item, data, width, height);
+			stbi_image_free(data);
+		}
+
+		return true;
+	}
+	void ObjectManager::LoadBound(PipelineItem* pass)
+	{
+		if (m_unloaded == 0)
+			return;
 
+		std::vector<GLuint>* lists[2] = { &GetBindList(pass), &GetUniformBindList(pass) };
+		for (auto list : lists)
+			for (GLuint id : *list)
+				for (ObjectManagerItem* item : m_itemData)
+					if (!item->IsLoaded && (item->Texture == id || item->FlippedTexture == id))
+						Load(item);
+	}
 	bool ObjectManager::ReloadTexture(ObjectManagerItem* item, const std::string& newPath)
 	{
 		stbi_set_flip_vertically_on_load(1);
@@ -622,6 +787,11 @@ namespace ed {
 				if (data == nullptr)
 					return false;
 
+				if (!item->IsLoaded) {
+					item->IsLoaded = true;
+					m_unloaded--;
+				}
+
 				if (m_items[i] != newPath) {
 					m_items[i] = newPath;
 					m_parser->ModifyProject();
@@ -665,7 +835,7 @@ namespace ed {
 	void ObjectManager::Pause(bool pause)
 	{
 		for (auto& it : m_itemData) {
-			if (it->SoundBuffer == nullptr)
+			if (it->SoundBuffer == nullptr || it->SoundBuffer->getSampleCount() == 0) // not loaded (yet)
 				continue;
 
 			// get samples and fft data
@@ -864,6 +1034,9 @@ namespace ed {
 		for (auto& it : m_itemData) {
 			// update audio items
 			if (it->SoundBuffer != nullptr) {
+				if (it->SoundBuffer->getSampleCount() == 0) // not loaded (yet)
+					continue;
+
 				// get samples and fft data
 				sf::Sound* player = it->Sound;
 				int channels = it->SoundBuffer->getChannelCount();
@@ -930,6 +1103,10 @@ namespace ed {
 			pobj->Owner->Object_Remove(file.c_str(), pobj->Type, pobj->Data, pobj->ID);
 		}
 
+		m_pingPong.erase(std::remove(m_pingPong.begin(), m_pingPong.end(), m_itemData[index]), m_pingPong.end());
+		if (!m_itemData[index]->IsLoaded)
+			m_unloaded--;
+
 		delete m_itemData[index];
 		m_itemData.erase(m_itemData.begin() + index);
 		m_items.erase(m_items.begin() + index);
@@ -939,6 +1116,7 @@ namespace ed {
 	{
 		if (IsBound(file, pass) == -1) {
 			m_parser->ModifyProject();
+			m_bindsChanged = true;
 
 			if (IsImage(file))
 				m_binds[pass].push_back(GetImage(file)->Texture);
@@ -1009,6 +1187,7 @@ namespace ed {
 				m_uniformBinds[pass].push_back(GetImage(file)->Texture);
 
 			m_parser->ModifyProject();
+			m_bindsChanged = true;
 		}
 	}
 	void ObjectManager::UnbindUniform(const std::string& file, PipelineItem* pass)
@@ -1179,6 +1358,10 @@ namespace ed {
 
 			glBindTexture(GL_TEXTURE_2D, img->Texture);
 			glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, resPixels);
+			if (img->PingPong) {
+				glBindTexture(GL_TEXTURE_2D, img->PreviousTexture);
+				glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, resPixels);
+			}
 			glBindTexture(GL_TEXTURE_2D, 0);
 
 			if (needsResize)
@@ -1190,6 +1373,10 @@ namespace ed {
 
 			glBindTexture(GL_TEXTURE_2D, img->Texture);
 			glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, img->Size.x, img->Size.y, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+			if (img->PingPong) {
+				glBindTexture(GL_TEXTURE_2D, img->PreviousTexture);
+				glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, img->Size.x, img->Size.y, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+			}
 			glBindTexture(GL_TEXTURE_2D, 0);
 
 			free(pixels);
@@ -1452,6 +1639,11 @@ namespace ed {
 		glBindTexture(GL_TEXTURE_2D, GetTexture(name));
 		glTexImage2D(GL_TEXTURE_2D, 0, rtObj->Format, size.x, size.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
 
+		if (rtObj->PingPong) {
+			glBindTexture(GL_TEXTURE_2D, rtObj->PreviousBuffer);
+			glTexImage2D(GL_TEXTURE_2D, 0, rtObj->Format, size.x, size.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+		}
+
 		glBindTexture(GL_TEXTURE_2D, rtObj->DepthStencilBuffer);
 		glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH24_STENCIL8, size.x, size.y, 0, GL_DEPTH_STENCIL, GL_UNSIGNED_INT_24_8, NULL);
 		glBindTexture(GL_TEXTURE_2D, 0);
@@ -1473,6 +1665,10 @@ namespace ed {
 
 		glBindTexture(GL_TEXTURE_2D, iobj->Texture);
 		glTexImage2D(GL_TEXTURE_2D, 0, iobj->Format, iobj->Size.x, iobj->Size.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+		if (iobj->PingPong) {
+			glBindTexture(GL_TEXTURE_2D, iobj->PreviousTexture);
+			glTexImage2D(GL_TEXTURE_2D, 0, iobj->Format, iobj->Size.x, iobj->Size.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+		}
 		glBindTexture(GL_TEXTURE_2D, 0);
 	}
 	void ObjectManager::ResizeImage3D(const std::string& name, glm::ivec3 size)
@@ -1487,4 +1683,71 @@ namespace ed {
 		glTexImage3D(GL_TEXTURE_3D, 0, iobj->Format, iobj->Size.x, iobj->Size.y, iobj->Size.z, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
 		glBindTexture(GL_TEXTURE_3D, 0);
 	}
-}
\ No newline at end of file
+
+	void ObjectManager::m_uploadTexture(ObjectManagerItem* item, unsigned char* data, int width, int height)
+	{
+		// FlipTexture() swaps the two handles
+		GLuint normalTex = item->Texture_VFlipped ? item->FlippedTexture : item->Texture;
+		GLuint flippedTex = item->Texture_VFlipped ? item->Texture : item->FlippedTexture;
+
+		// normal texture
+		glBindTexture(GL_TEXTURE_2D, normalTex);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, item->Texture_MinFilter);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, item->Texture_MagFilter);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, item->Texture_WrapS);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, item->Texture_WrapT);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
+		glGenerateMipmap(GL_TEXTURE_2D);
+		glBindTexture(GL_TEXTURE_2D, 0);
+
+		// flipped texture
+		unsigned char* flippedData = (unsigned char*)malloc(width * height * 4);
+
+		for (int x = 0; x < width; x++) {
+			for (int y = 0; y < height; y++) {
+				flippedData[(y * width + x) * 4 + 0] = data[((height - y - 1) * width + x) * 4 + 0];
+				flippedData[(y * width + x) * 4 + 1] = data[((height - y - 1) * width + x) * 4 + 1];
+				flippedData[(y * width + x) * 4 + 2] = data[((height - y - 1) * width + x) * 4 + 2];
+				flippedData[(y * width + x) * 4 + 3] = data[((height - y - 1) * width + x) * 4 + 3];
+			}
+		}
+
+		glBindTexture(GL_TEXTURE_2D, flippedTex);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, item->Texture_MinFilter);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, item->Texture_MagFilter);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, item->Texture_WrapS);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, item->Texture_WrapT);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, flippedData);
+		glGenerateMipmap(GL_TEXTURE_2D);
+		glBindTexture(GL_TEXTURE_2D, 0);
+
+		item->ImageSize = glm::ivec2(width, height);
+
+		free(flippedData);
+	}
+	void ObjectManager::m_loadCubemap(ObjectManagerItem* item)
+	{
+		// same order as CubemapPaths: left, top, front, bottom, right, back
+		static const GLenum faces[] = {
+			GL_TEXTURE_CUBE_MAP_NEGATIVE_X, GL_TEXTURE_CUBE_MAP_POSITIVE_Y, GL_TEXTURE_CUBE_MAP_NEGATIVE_Z,
+			GL_TEXTURE_CUBE_MAP_NEGATIVE_Y, GL_TEXTURE_CUBE_MAP_POSITIVE_X, GL_TEXTURE_CUBE_MAP_POSITIVE_Z
+		};
+
+		glBindTexture(GL_TEXTURE_CUBE_MAP, item->Texture);
+		int width = 0, height = 0;
+
+		// properties
+		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+
+		for (int i = 0; i < 6 && i < item->CubemapPaths.size(); i++)
+			loadCubemapFace(faces[i], m_parser->GetProjectPath(item->CubemapPaths[i]), width, height);
+
+		// clean up
+		glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+		item->ImageSize = glm::ivec2(width, height);
+	}
+}
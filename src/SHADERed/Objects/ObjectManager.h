@@ -16,17 +16,21 @@ namespace ed {
 
 	struct RenderTextureObject {
 		GLuint DepthStencilBuffer, DepthStencilBufferMS, BufferMS; // ColorBuffer is stored in ObjectManager
+		GLuint PreviousBuffer;									  // second color buffer when PingPong is set
 		glm::ivec2 FixedSize;
 		glm::vec2 RatioSize;
 		glm::vec4 ClearColor;
 		std::string Name;
 		bool Clear;
+		bool PingPong;
 		GLuint Format;
 
 		RenderTextureObject()
 				: FixedSize(-1, -1)
 				, RatioSize(1, 1)
 				, Clear(true)
+				, PingPong(false)
+				, PreviousBuffer(0)
 				, ClearColor(0, 0, 0, 1)
 				, Format(GL_RGBA)
 		{
@@ -50,6 +54,8 @@ namespace ed {
 		char ViewFormat[256]; // vec3;vec3;vec2
 		GLuint ID;
 		bool PreviewPaused;
+		bool PingPong;
+		GLuint PreviousID;
 	};
 
 	struct ImageObject {
@@ -57,6 +63,8 @@ namespace ed {
 		GLuint Format;
 		GLuint Texture;
 		char DataPath[SHADERED_MAX_PATH];
+		bool PingPong;
+		GLuint PreviousTexture;
 	};
 
 	struct Image3DObject {
@@ -98,16 +106,21 @@ namespace ed {
 			Image = nullptr;
 			Image3D = nullptr;
 			Plugin = nullptr;
+			PingPongWritten = false;
+			PingPongPending = false;
+			IsLoaded = true;
 		}
 		~ObjectManagerItem()
 		{
 			if (Buffer != nullptr) {
 				glDeleteBuffers(1, &Buffer->ID);
+				glDeleteBuffers(1, &Buffer->PreviousID);
 				free(Buffer->Data);
 				delete Buffer;
 			}
 			if (Image != nullptr) {
 				glDeleteTextures(1, &Image->Texture);
+				glDeleteTextures(1, &Image->PreviousTexture);
 				delete Image;
 			}
 			if (Image3D != nullptr) {
@@ -117,6 +130,7 @@ namespace ed {
 
 			if (RT != nullptr) {
 				glDeleteTextures(1, &RT->DepthStencilBuffer);
+				glDeleteTextures(1, &RT->PreviousBuffer);
 				delete RT;
 			}
 			if (Sound != nullptr) {
@@ -154,6 +168,15 @@ namespace ed {
 		Image3DObject* Image3D;
 
 		PluginObject* Plugin;
+
+		// ping-pong objects: the handle stored above is written, the previous one holds the last complete version
+		bool PingPongWritten; // the current handle was written since the last swap
+		bool PingPongPending; // written while paused - swapped once the frame clock is stepped
+		inline GLuint GetHandle() { return Buffer ? Buffer->ID : (Image ? Image->Texture : Texture); }
+		inline GLuint GetPreviousHandle() { return Buffer ? Buffer->PreviousID : (Image ? Image->PreviousTexture : (RT ? RT->PreviousBuffer : 0)); }
+
+		// lazily created textures, cubemaps & audio only have their GL names & size until ObjectManager::Load()
+		bool IsLoaded;
 	};
 
 	class ObjectManager {
@@ -162,9 +185,9 @@ namespace ed {
 		~ObjectManager();
 
 		bool CreateRenderTexture(const std::string& name);
-		bool CreateTexture(const std::string& file);
-		bool CreateAudio(const std::string& file);
-		bool CreateCubemap(const std::string& name, const std::string& left, const std::string& top, const std::string& front, const std::string& bottom, const std::string& right, const std::string& back);
+		bool CreateTexture(const std::string& file, bool lazy = false);
+		bool CreateAudio(const std::string& file, bool lazy = false);
+		bool CreateCubemap(const std::string& name, const std::string& left, const std::string& top, const std::string& front, const std::string& bottom, const std::string& right, const std::string& back, bool lazy = false);
 		bool CreateBuffer(const std::string& file);
 		bool CreateImage(const std::string& name, glm::ivec2 size = glm::ivec2(1, 1));
 		bool CreateImage3D(const std::string& name, glm::ivec3 size = glm::ivec3(1, 1, 1));
@@ -207,6 +230,24 @@ namespace ed {
 
 		bool ReloadTexture(ObjectManagerItem* item, const std::string& newPath);
 
+		// upload buf->Data to the GPU (both copies of a ping-pong buffer)
+		void UploadBufferData(BufferObject* buf);
+
+		// double buffered render textures, images & buffers - see RenderEngine for when they are swapped
+		void SetPingPong(const std::string& name, bool pingPong);
+		bool IsPingPong(const std::string& name);
+		ObjectManagerItem* GetPingPong(GLuint id, bool isBuffer); // nullptr if the handle doesn't belong to a ping-pong object
+		GLuint GetPingPongRead(GLuint id, bool isBuffer);		   // handle that holds the newest complete data
+		void SwapPingPong(ObjectManagerItem* item);				   // also updates the bind lists
+		inline const std::vector<ObjectManagerItem*>& GetPingPongList() { return m_pingPong; }
+
+		// lazy loading - decode & upload the data of objects created with lazy = true
+		bool Load(ObjectManagerItem* item);
+		void LoadBound(PipelineItem* pass); // everything bound to the pass as a texture or UAV
+		inline bool NeedsLoadBound() { return m_unloaded > 0 && m_bindsChanged; }
+		inline void InvalidateBinds() { m_bindsChanged = true; } // call after enabling a pass
+		inline void ValidateBinds() { m_bindsChanged = false; }
+
 		void Clear();
 
 		const std::vector<std::string>& GetObjects() { return m_items; }
@@ -272,6 +313,12 @@ namespace ed {
 
 		std::vector<std::string> m_items; // TODO: move item name to item data
 		std::vector<ObjectManagerItem*> m_itemData;
+		std::vector<ObjectManagerItem*> m_pingPong;
+		int m_unloaded;
+		bool m_bindsChanged; // bind lists changed since the last LoadBound() scan
+
+		void m_uploadTexture(ObjectManagerItem* item, unsigned char* data, int width, int height);
+		void m_loadCubemap(ObjectManagerItem* item);
 
 		std::vector<GLuint> m_emptyResVec;
 		std::vector<char> m_emptyResVecChar;
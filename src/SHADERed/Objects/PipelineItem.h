@@ -67,6 +67,10 @@ namespace ed {
 
 				WorkX = WorkY = WorkZ = 1;
 				Active = true;
+				Optimize = false;
+				IndirectBuffer = nullptr;
+				IndirectOffset = 0;
+				Iterations = 1;
 			}
 
 			char Path[SHADERED_MAX_PATH];
@@ -74,8 +78,12 @@ namespace ed {
 			std::vector<unsigned int> SPV; // SPIR-V
 
 			bool Active;
+			bool Optimize; // run spirv-opt on the SPIR-V used for rendering (SPV stays unoptimized for the debugger)
 
 			GLuint WorkX, WorkY, WorkZ;
+			void* IndirectBuffer;  // BufferObject* with the group counts (3x uint) - WorkX/Y/Z are ignored when set
+			GLuint IndirectOffset; // in bytes, multiple of 4
+			int Iterations;		   // dispatches per frame, IterationIndex system variable holds the current one
 			ShaderVariableContainer Variables;
 			std::vector<ShaderMacro> Macros;
 		};
@@ -102,6 +110,8 @@ namespace ed {
 				RTCount = 0;
 				GSUsed = false;
 				Active = true;
+				Optimize = false;
+				Batch = false;
 				Macros.clear();
 				memset(VSPath, 0, sizeof(char) * SHADERED_MAX_PATH);
 				memset(PSPath, 0, sizeof(char) * SHADERED_MAX_PATH);
@@ -131,6 +141,9 @@ namespace ed {
 			std::vector<unsigned int> GSSPV; // GS SPIR-V
 			bool GSUsed;
 
+			bool Optimize; // run spirv-opt on the SPIR-V used for rendering (*SPV stay unoptimized for the debugger)
+			bool Batch;	   // merge the items into multi-draw calls, shaders read the transforms from DrawBatcher::TransformBinding
+
 			ShaderVariableContainer Variables;
 			std::vector<ShaderMacro> Macros;
 
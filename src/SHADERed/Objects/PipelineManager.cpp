@@ -1,3 +1,4 @@
+#include <SHADERed/Engine/GeometryFactory.h>
 #include <SHADERed/Objects/Logger.h>
 #include <SHADERed/Objects/PipelineManager.h>
 #include <SHADERed/Objects/ProjectParser.h>
@@ -29,7 +30,7 @@ namespace ed {
 	}
 	void PipelineManager::Clear()
 	{
-		Logger::Get().Log("Clearing PipelineManager contents");
+		Logger::Get().Log(Logger::Category::Project, Logger::Level::Info, "Clearing PipelineManager contents");
 
 		while (m_items.size() > 0)
 			Remove(m_items[0]->Name);
@@ -48,15 +49,15 @@ namespace ed {
 		}
 
 		if (Has(name)) {
-			Logger::Get().Log("Item " + std::string(name) + " not added - name already taken", true);
+			Logger::Get().Log(Logger::Category::Project, Logger::Level::Error, "Item " + std::string(name) + " not added - name already taken");
 			return false;
 		}
 
-		Logger::Get().Log("Adding a pipeline item " + std::string(name) + " to the project");
+		Logger::Get().Log(Logger::Category::Project, Logger::Level::Info, "Adding a pipeline item " + std::string(name) + " to the project");
 
 		for (const auto& item : m_items)
 			if (strcmpcase(item->Name, name) == 0) {
-				Logger::Get().Log("Item " + std::string(name) + " not added - name already taken", true);
+				Logger::Get().Log(Logger::Category::Project, Logger::Level::Error, "Item " + std::string(name) + " not added - name already taken");
 				return false;
 			}
 
@@ -82,14 +83,14 @@ namespace ed {
 
 				for (auto& i : pass->Items)
 					if (strcmpcase(i->Name, name) == 0) {
-						Logger::Get().Log("Item " + std::string(name) + " not added - name already taken", true);
+						Logger::Get().Log(Logger::Category::Project, Logger::Level::Error, "Item " + std::string(name) + " not added - name already taken");
 						return false;
 					}
 
 				pass->Items.push_back(new PipelineItem("\0", type, data));
 				strcpy(pass->Items.at(pass->Items.size() - 1)->Name, name);
 
-				Logger::Get().Log("Item " + std::string(name) + " added to the project");
+				Logger::Get().Log(Logger::Category::Project, Logger::Level::Info, "Item " + std::string(name) + " added to the project");
 
 				m_plugins->HandleApplicationEvent(plugin::ApplicationEvent::PipelineItemAdded, (void*)name, nullptr);
 
@@ -101,10 +102,10 @@ namespace ed {
 	}
 	bool PipelineManager::AddPluginItem(char* owner, const char* name, const char* type, void* data, IPlugin1* plugin)
 	{
-		Logger::Get().Log("Adding a plugin pipeline item " + std::string(name) + " to the project");
+		Logger::Get().Log(Logger::Category::Project, Logger::Level::Info, "Adding a plugin pipeline item " + std::string(name) + " to the project");
 
 		if (Has(name)) {
-			Logger::Get().Log("Item " + std::string(name) + " not added - name already taken", true);
+			Logger::Get().Log(Logger::Category::Project, Logger::Level::Error, "Item " + std::string(name) + " not added - name already taken");
 			return false;
 		}
 
@@ -132,7 +133,7 @@ namespace ed {
 					plPass->Owner->PipelineItem_AddChild(owner, pitem->Name, plugin::PipelineItemType::PluginItem, data);
 				}
 
-				Logger::Get().Log("Item " + std::string(name) + " added to the project");
+				Logger::Get().Log(Logger::Category::Project, Logger::Level::Info, "Item " + std::string(name) + " added to the project");
 				
 				m_plugins->HandleApplicationEvent(plugin::ApplicationEvent::PipelineItemAdded, (void*)name, nullptr);
 
@@ -158,13 +159,13 @@ namespace ed {
 	bool PipelineManager::AddShaderPass(const char* name, pipe::ShaderPass* data)
 	{
 		if (Has(name)) {
-			Logger::Get().Log("Shader pass " + std::string(name) + " not added - name already taken", true);
+			Logger::Get().Log(Logger::Category::Project, Logger::Level::Error, "Shader pass " + std::string(name) + " not added - name already taken");
 			return false;
 		}
 
 		m_project->ModifyProject();
 
-		Logger::Get().Log("Added a shader pass " + std::string(name) + " to the project");
+		Logger::Get().Log(Logger::Category::Project, Logger::Level::Info, "Added a shader pass " + std::string(name) + " to the project");
 
 		m_items.push_back(new PipelineItem("\0", PipelineItem::ItemType::ShaderPass, data));
 		strcpy(m_items.at(m_items.size() - 1)->Name, name);
@@ -176,13 +177,13 @@ namespace ed {
 	bool PipelineManager::AddComputePass(const char* name, pipe::ComputePass* data)
 	{
 		if (Has(name)) {
-			Logger::Get().Log("Compute pass " + std::string(name) + " not added - name already taken", true);
+			Logger::Get().Log(Logger::Category::Project, Logger::Level::Error, "Compute pass " + std::string(name) + " not added - name already taken");
 			return false;
 		}
 
 		m_project->ModifyProject();
 
-		Logger::Get().Log("Added a compute pass " + std::string(name) + " to the project");
+		Logger::Get().Log(Logger::Category::Project, Logger::Level::Info, "Added a compute pass " + std::string(name) + " to the project");
 
 		m_items.push_back(new PipelineItem("\0", PipelineItem::ItemType::ComputePass, data));
 		strcpy(m_items.at(m_items.size() - 1)->Name, name);
@@ -194,13 +195,13 @@ namespace ed {
 	bool PipelineManager::AddAudioPass(const char* name, pipe::AudioPass* data)
 	{
 		if (Has(name)) {
-			Logger::Get().Log("Compute pass " + std::string(name) + " not added - name already taken", true);
+			Logger::Get().Log(Logger::Category::Project, Logger::Level::Error, "Compute pass " + std::string(name) + " not added - name already taken");
 			return false;
 		}
 
 		m_project->ModifyProject();
 
-		Logger::Get().Log("Added a audio pass " + std::string(name) + " to the project");
+		Logger::Get().Log(Logger::Category::Project, Logger::Level::Info, "Added a audio pass " + std::string(name) + " to the project");
 
 		m_items.push_back(new PipelineItem("\0", PipelineItem::ItemType::AudioPass, data));
 		strcpy(m_items.at(m_items.size() - 1)->Name, name);
@@ -211,7 +212,7 @@ namespace ed {
 	}
 	void PipelineManager::Remove(const char* name)
 	{
-		Logger::Get().Log("Deleting item " + std::string(name));
+		Logger::Get().Log(Logger::Category::Project, Logger::Level::Info, "Deleting item " + std::string(name));
 
 		m_plugins->HandleApplicationEvent(plugin::ApplicationEvent::PipelineItemDeleted, (void*)name, nullptr);
 
@@ -226,7 +227,7 @@ namespace ed {
 						if (passItem->Type == PipelineItem::ItemType::Geometry) {
 							pipe::GeometryItem* geo = (pipe::GeometryItem*)passItem->Data;
 							glDeleteVertexArrays(1, &geo->VAO);
-							glDeleteVertexArrays(1, &geo->VBO);
+							eng::GeometryFactory::Release(geo->VBO);
 						} else if (passItem->Type == PipelineItem::ItemType::PluginItem) {
 							pipe::PluginItemData* pdata = (pipe::PluginItemData*)passItem->Data;
 							pdata->Owner->PipelineItem_Remove(passItem->Name, pdata->Type, pdata->PluginData);
@@ -250,7 +251,7 @@ namespace ed {
 						if (passItem->Type == PipelineItem::ItemType::Geometry) {
 							pipe::GeometryItem* geo = (pipe::GeometryItem*)passItem->Data;
 							glDeleteVertexArrays(1, &geo->VAO);
-							glDeleteVertexArrays(1, &geo->VBO);
+							eng::GeometryFactory::Release(geo->VBO);
 						} else if (passItem->Type == PipelineItem::ItemType::PluginItem) {
 							pipe::PluginItemData* pldata = (pipe::PluginItemData*)passItem->Data;
 							pdata->Owner->PipelineItem_Remove(passItem->Name, pldata->Type, pldata->PluginData);
@@ -280,7 +281,7 @@ namespace ed {
 							if (child->Type == PipelineItem::ItemType::Geometry) {
 								pipe::GeometryItem* geo = (pipe::GeometryItem*)child->Data;
 								glDeleteVertexArrays(1, &geo->VAO);
-								glDeleteVertexArrays(1, &geo->VBO);
+								eng::GeometryFactory::Release(geo->VBO);
 							} else if (child->Type == PipelineItem::ItemType::PluginItem) {
 								pipe::PluginItemData* pdata = (pipe::PluginItemData*)child->Data;
 								pdata->Owner->PipelineItem_Remove(child->Name, pdata->Type, pdata->PluginData);
@@ -307,7 +308,7 @@ namespace ed {
 							if (child->Type == PipelineItem::ItemType::Geometry) {
 								pipe::GeometryItem* geo = (pipe::GeometryItem*)child->Data;
 								glDeleteVertexArrays(1, &geo->VAO);
-								glDeleteVertexArrays(1, &geo->VBO);
+								eng::GeometryFactory::Release(geo->VBO);
 							} else if (child->Type == PipelineItem::ItemType::PluginItem) {
 								pipe::PluginItemData* pdata = (pipe::PluginItemData*)child->Data;
 								pdata->Owner->PipelineItem_Remove(child->Name, pdata->Type, pdata->PluginData);
@@ -380,7 +381,7 @@ namespace ed {
 	}
 	void PipelineManager::New(bool openTemplate)
 	{
-		Logger::Get().Log("Creating a new project from template");
+		Logger::Get().Log(Logger::Category::Project, Logger::Level::Info, "Creating a new project from template");
 
 		Clear();
 
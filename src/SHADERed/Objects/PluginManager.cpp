@@ -1,6 +1,7 @@
 #include <SHADERed/GUIManager.h>
 #include <SHADERed/InterfaceManager.h>
 #include <SHADERed/Objects/DefaultState.h>
+#include <SHADERed/Objects/GLState.h>
 #include <SHADERed/Objects/Logger.h>
 #include <SHADERed/Objects/PluginManager.h>
 #include <SHADERed/Objects/Settings.h>
@@ -56,7 +57,7 @@ namespace ed {
 			pluginsDirLoc = ed::Settings::Instance().LinuxHomeDirectory + "plugins/";
 
 		if (!std::filesystem::exists(pluginsDirLoc)) {
-			ed::Logger::Get().Log("Directory for plugins doesn't exist");
+			ed::Logger::Get().Log(Logger::Category::Plugin, Logger::Level::Info, "Directory for plugins doesn't exist");
 			return;
 		}
 
@@ -87,7 +88,7 @@ namespace ed {
 				void* procDLL = dlopen((pluginsDirLoc + pdir + "/plugin.so").c_str(), RTLD_NOW);
 
 				if (!procDLL) {
-					ed::Logger::Get().Log("dlopen(\"" + pdir + "/plugin.so\") has failed.");
+					ed::Logger::Get().Log(Logger::Category::Plugin, Logger::Level::Info, "dlopen(\"" + pdir + "/plugin.so\") has failed.");
 					continue;
 				}
 
@@ -101,7 +102,7 @@ namespace ed {
 
 				if (!procDLL) {
 					DWORD test = GetLastError();
-					ed::Logger::Get().Log("LoadLibraryA(\"" + pdir + "/plugin.dll\") has failed.");
+					ed::Logger::Get().Log(Logger::Category::Plugin, Logger::Level::Info, "LoadLibraryA(\"" + pdir + "/plugin.dll\") has failed.");
 					continue;
 				}
 
@@ -114,7 +115,7 @@ namespace ed {
 
 				// GetPluginName() function
 				if (!fnGetPluginName) {
-					ed::Logger::Get().Log(pdir + "/plugin." + pluginExt + " doesn't contain GetPluginName.", true);
+					ed::Logger::Get().Log(Logger::Category::Plugin, Logger::Level::Error, pdir + "/plugin." + pluginExt + " doesn't contain GetPluginName.");
 					(*ptrFreeLibrary)(procDLL);
 					continue;
 				}
@@ -129,14 +130,14 @@ namespace ed {
 
 				// GetPluginAPIVersion()
 				if (!fnGetPluginAPIVersion) {
-					ed::Logger::Get().Log(pdir + "/plugin." + pluginExt + " doesn't contain GetPluginAPIVersion.", true);
+					ed::Logger::Get().Log(Logger::Category::Plugin, Logger::Level::Error, pdir + "/plugin." + pluginExt + " doesn't contain GetPluginAPIVersion.");
 					(*ptrFreeLibrary)(procDLL);
 					continue;
 				}
 
 				int apiVer = (*fnGetPluginAPIVersion)();
 				if (apiVer != CURRENT_PLUGINAPI_VERSION) {
-					ed::Logger::Get().Log(pdir + "/plugin." + pluginExt + " uses newer/older plugin API version. Please update the plugin or update SHADERed.", true);
+					ed::Logger::Get().Log(Logger::Category::Plugin, Logger::Level::Error, pdir + "/plugin." + pluginExt + " uses newer/older plugin API version. Please update the plugin or update SHADERed.");
 					(*ptrFreeLibrary)(procDLL);
 					if (std::count(notLoaded.begin(), notLoaded.end(), pname) == 0)
 						m_incompatible.push_back(pname);
@@ -147,7 +148,7 @@ namespace ed {
 
 				// GetPluginVersion() function
 				if (!fnGetPluginVersion) {
-					ed::Logger::Get().Log(pdir + "/plugin." + pluginExt + " doesn't contain GetPluginVersion.", true);
+					ed::Logger::Get().Log(Logger::Category::Plugin, Logger::Level::Error, pdir + "/plugin." + pluginExt + " doesn't contain GetPluginVersion.");
 					(*ptrFreeLibrary)(procDLL);
 					continue;
 				}
@@ -156,7 +157,7 @@ namespace ed {
 
 				// CreatePlugin() function
 				if (!fnCreatePlugin) {
-					ed::Logger::Get().Log(pdir + "/plugin." + pluginExt + " doesn't contain CreatePlugin.", true);
+					ed::Logger::Get().Log(Logger::Category::Plugin, Logger::Level::Error, pdir + "/plugin." + pluginExt + " doesn't contain CreatePlugin.");
 					(*ptrFreeLibrary)(procDLL);
 					continue;
 				}
@@ -164,7 +165,7 @@ namespace ed {
 				// create the actual plugin
 				IPlugin1* plugin = (*fnCreatePlugin)();
 				if (plugin == nullptr) {
-					ed::Logger::Get().Log(pdir + "/plugin." + pluginExt + " CreatePlugin returned nullptr.", true);
+					ed::Logger::Get().Log(Logger::Category::Plugin, Logger::Level::Error, pdir + "/plugin." + pluginExt + " CreatePlugin returned nullptr.");
 					(*ptrFreeLibrary)(procDLL);
 					continue;
 				}
@@ -397,6 +398,7 @@ namespace ed {
 					h = tsize.y;
 				};
 				plugin->BindDefaultState = []() {
+					GLState::Instance().Invalidate(); // the plugin could have changed anything
 					DefaultState::Bind();
 				};
 				plugin->OpenInCodeEditor = [](void* ui, void* item, const char* filename, int id) {
@@ -479,6 +481,7 @@ namespace ed {
 					if (lwr == "autouniformspin") return seti.General.AutoUniformsPin;
 					if (lwr == "autouniformsfunction") return seti.General.AutoUniformsFunction;
 					if (lwr == "autouniformsdelete") return seti.General.AutoUniformsDelete;
+					if (lwr == "lazyloading") return seti.General.LazyLoading;
 					if (lwr == "reopenshaders") return seti.General.ReopenShaders;
 					if (lwr == "useexternaleditor") return seti.General.UseExternalEditor;
 					if (lwr == "openshadersondblclk") return seti.General.OpenShadersOnDblClk;
@@ -522,6 +525,8 @@ namespace ed {
 					if (lwr == "statusbar") return seti.Preview.StatusBar;
 					if (lwr == "applyfpslimittoapp") return seti.Preview.ApplyFPSLimitToApp;
 					if (lwr == "lostfocuslimitfps") return seti.Preview.LostFocusLimitFPS;
+					if (lwr == "idlewhenstatic") return seti.Preview.IdleWhenStatic;
+					if (lwr == "frustumculling") return seti.Preview.FrustumCulling;
 
 					/* PROJECT */
 					if (lwr == "fpcamera") return seti.Project.FPCamera;
@@ -944,9 +949,9 @@ namespace ed {
 				plugin->InitUI(ImGui::GetCurrentContext());
 				
 				if (initResult)
-					ed::Logger::Get().Log("Plugin \"" + pname + "\" successfully initialized.");
+					ed::Logger::Get().Log(Logger::Category::Plugin, Logger::Level::Info, "Plugin \"" + pname + "\" successfully initialized.");
 				else
-					ed::Logger::Get().Log("Failed to initialize plugin \"" + pname + "\".");
+					ed::Logger::Get().Log(Logger::Category::Plugin, Logger::Level::Info, "Failed to initialize plugin \"" + pname + "\".");
 
 				m_plugins.push_back(plugin);
 				m_proc.push_back(procDLL);
@@ -0,0 +1,234 @@
+#include <SHADERed/Objects/Logger.h>
+#include <SHADERed/Objects/ProgramCache.h>
+#include <SHADERed/Objects/Settings.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <stdio.h>
+
+namespace ed {
+	static const unsigned int ProgramCacheMagic = 0x42505345; // "ESPB"
+
+	// FNV-1a
+	static unsigned long long hashBytes(const char* data, size_t len, unsigned long long hash = 14695981039346656037ULL)
+	{
+		for (size_t i = 0; i < len; i++) {
+			hash ^= (unsigned char)data[i];
+			hash *= 1099511628211ULL;
+		}
+		return hash;
+	}
+
+	ProgramCache::ProgramCache()
+	{
+		m_initialized = false;
+		m_supported = false;
+		m_driverHash = 0;
+		m_size = 0;
+		m_sizeKnown = false;
+	}
+
+	GLuint ProgramCache::Load(const std::vector<std::string>& sources)
+	{
+		m_init();
+		if (!m_supported)
+			return 0;
+
+		unsigned long long key = 0;
+		std::string path = m_getPath(sources, key);
+		std::ifstream file(path, std::ios::binary);
+		if (!file.is_open())
+			return 0;
+
+		unsigned int magic = 0;
+		unsigned long long storedKey = 0;
+		GLenum format = 0;
+		GLint length = 0;
+		file.read((char*)&magic, sizeof(magic));
+		file.read((char*)&storedKey, sizeof(storedKey));
+		file.read((char*)&format, sizeof(format));
+		file.read((char*)&length, sizeof(length));
+
+		if (!file || magic != ProgramCacheMagic || storedKey != key || length <= 0)
+			return 0;
+
+		std::vector<char> binary(length);
+		file.read(binary.data(), length);
+		if (!file)
+			return 0;
+
+		GLuint program = glCreateProgram();
+		glProgramBinary(program, format, binary.data(), length);
+
+		// drivers reject binaries after an update even when the version string didn't change
+		GLint linked = 0;
+		glGetProgramiv(program, GL_LINK_STATUS, &linked);
+		if (!linked) {
+			glDeleteProgram(program);
+			return 0;
+		}
+
+		// the modification time serves as the last access time for the eviction (atime is often disabled)
+		std::error_code errCode;
+		std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), errCode);
+
+		return program;
+	}
+	void ProgramCache::PrepareLink(GLuint program)
+	{
+		m_init();
+		if (m_supported)
+			glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+	}
+	void ProgramCache::Save(GLuint program, const std::vector<std::string>& sources)
+	{
+		m_init();
+		if (!m_supported || program == 0)
+			return;
+
+		GLint linked = 0, length = 0;
+		glGetProgramiv(program, GL_LINK_STATUS, &linked);
+		glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+		if (!linked || length <= 0)
+			return;
+
+		std::vector<char> binary(length);
+		GLenum format = 0;
+		glGetProgramBinary(program, length, &length, &format, binary.data());
+		if (length <= 0)
+			return;
+
+		std::error_code errCode;
+		std::filesystem::create_directories(m_dir, errCode);
+
+		unsigned long long key = 0;
+		std::string path = m_getPath(sources, key);
+		std::string tempPath = path + ".tmp";
+
+		std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+		if (!file.is_open())
+			return;
+
+		file.write((const char*)&ProgramCacheMagic, sizeof(ProgramCacheMagic));
+		file.write((const char*)&key, sizeof(key));
+		file.write((const char*)&format, sizeof(format));
+		file.write((const char*)&length, sizeof(length));
+		file.write(binary.data(), length);
+		file.close();
+
+		// another instance might be reading the same entry
+		std::filesystem::rename(tempPath, path, errCode);
+		if (errCode) {
+			std::filesystem::remove(tempPath, errCode);
+			return;
+		}
+
+		if (!m_sizeKnown)
+			m_evict(); // counts the entries
+		else
+			m_size += sizeof(ProgramCacheMagic) + sizeof(key) + sizeof(format) + sizeof(length) + length;
+
+		if (m_size > MaxSize)
+			m_evict();
+	}
+	void ProgramCache::Clear()
+	{
+		m_init();
+
+		std::error_code errCode;
+		std::filesystem::remove_all(m_dir, errCode);
+		m_size = 0;
+	}
+
+	void ProgramCache::m_init()
+	{
+		if (m_initialized)
+			return;
+		m_initialized = true;
+
+		m_dir = "data/program_cache/";
+		if (!Settings::Instance().LinuxHomeDirectory.empty())
+			m_dir = Settings::Instance().LinuxHomeDirectory + m_dir;
+
+		GLint formatCount = 0;
+		if (GLEW_VERSION_4_1 || GLEW_ARB_get_program_binary)
+			glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+		m_supported = formatCount > 0;
+
+		if (!m_supported) {
+			Logger::Get().Log(Logger::Category::Shader, Logger::Level::Info, "Program binaries are not supported - shader cache is disabled");
+			return;
+		}
+
+		// binaries are only valid for the driver that created them
+		const char* vendor = (const char*)glGetString(GL_VENDOR);
+		const char* renderer = (const char*)glGetString(GL_RENDERER);
+		const char* version = (const char*)glGetString(GL_VERSION);
+		std::string driver = std::string(vendor ? vendor : "") + "\n" + (renderer ? renderer : "") + "\n" + (version ? version : "");
+
+		m_driverHash = hashBytes(driver.c_str(), driver.size());
+	}
+	std::string ProgramCache::m_getPath(const std::vector<std::string>& sources, unsigned long long& key)
+	{
+		// file name and the stored key use different seeds to detect collisions
+		unsigned long long nameHash = m_driverHash;
+		key = ~m_driverHash;
+		for (const auto& src : sources) {
+			unsigned long long len = src.size();
+			nameHash = hashBytes((const char*)&len, sizeof(len), hashBytes(src.c_str(), src.size(), nameHash));
+			key = hashBytes((const char*)&len, sizeof(len), hashBytes(src.c_str(), src.size(), key));
+		}
+
+		char name[32];
+		snprintf(name, sizeof(name), "%016llx.bin", nameHash);
+
+		return m_dir + name;
+	}
+	void ProgramCache::m_evict()
+	{
+		struct Entry {
+			std::filesystem::path Path;
+			std::filesystem::file_time_type Time;
+			unsigned long long Size;
+		};
+
+		// other instances share the directory - always start from what is actually there
+		std::vector<Entry> entries;
+		std::error_code errCode;
+		m_size = 0;
+		for (const auto& file : std::filesystem::directory_iterator(m_dir, errCode)) {
+			if (file.path().extension() != ".bin")
+				continue;
+
+			Entry entry;
+			entry.Path = file.path();
+			entry.Time = file.last_write_time(errCode);
+			entry.Size = file.file_size(errCode);
+			if (errCode)
+				continue;
+
+			m_size += entry.Size;
+			entries.push_back(entry);
+		}
+		m_sizeKnown = true;
+
+		if (m_size <= MaxSize)
+			return;
+
+		std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.Time < b.Time; });
+
+		int removed = 0;
+		for (const auto& entry : entries) {
+			if (m_size <= MaxSize / 4 * 3)
+				break;
+
+			if (std::filesystem::remove(entry.Path, errCode)) {
+				m_size -= entry.Size;
+				removed++;
+			}
+		}
+
+		Logger::Get().Log(Logger::Category::Shader, Logger::Level::Info, "Removed " + std::to_string(removed) + " old entries from the program cache");
+	}
+}
@@ -0,0 +1,61 @@
+#pragma once
+#ifdef _WIN32
+#include <windows.h>
+#endif
+#include <GL/glew.h>
+#if defined(__APPLE__)
+#include <OpenGL/gl.h>
+#else
+#include <GL/gl.h>
+#endif
+#include <string>
+#include <vector>
+
+namespace ed {
+	/* Stores linked programs (glGetProgramBinary) on disk so that unchanged
+	   shaders don't have to be compiled & linked again when a project is reopened.
+	   Entries are keyed by the final GLSL sources and the GL vendor/renderer/version.
+	   Every edit creates a new entry, so the least recently used ones are removed
+	   once the cache grows over MaxSize. */
+	class ProgramCache {
+	public:
+		ProgramCache();
+
+		static const unsigned long long MaxSize = 128ull * 1024 * 1024;
+
+		static ProgramCache& Instance()
+		{
+			static ProgramCache ret;
+			return ret;
+		}
+
+		// returns a linked program or 0 if there is no entry / the driver rejected the binary
+		GLuint Load(const std::vector<std::string>& sources);
+
+		// call before glLinkProgram()
+		void PrepareLink(GLuint program);
+
+		// stores the binary if the program was linked successfully
+		void Save(GLuint program, const std::vector<std::string>& sources);
+
+		void Clear();
+
+		inline bool IsSupported()
+		{
+			m_init();
+			return m_supported;
+		}
+
+	private:
+		void m_init();
+		std::string m_getPath(const std::vector<std::string>& sources, unsigned long long& key);
+		void m_evict(); // removes the least recently used entries until the cache fits in MaxSize * 3/4
+
+		bool m_initialized;
+		bool m_supported;
+		unsigned long long m_driverHash;
+		unsigned long long m_size; // size of all entries, counted on the first Save()
+		bool m_sizeKnown;
+		std::string m_dir;
+	};
+}
@@ -1,3 +1,4 @@
+#include <SHADERed/Objects/BinaryProject.h>
 #include <SHADERed/Objects/CameraSnapshots.h>
 #include <SHADERed/Objects/DebugInformation.h>
 #include <SHADERed/Objects/DefaultState.h>
@@ -13,6 +14,7 @@
 #include <SHADERed/Objects/RenderEngine.h>
 #include <SHADERed/Objects/ShaderCompiler.h>
 #include <SHADERed/Objects/SystemVariableManager.h>
+#include <SHADERed/Objects/Tracer.h>
 
 #include <SHADERed/Engine/GLUtils.h>
 #include <SHADERed/Engine/GeometryFactory.h>
@@ -24,6 +26,7 @@
 #include <filesystem>
 #include <algorithm>
 #include <fstream>
+#include <string_view>
 
 #define HARRAYSIZE(a) (sizeof(a) / sizeof(*a))
 
@@ -48,6 +51,11 @@ namespace ed {
 		return pxmlStream.str();
 	}
 
+	size_t hashBuffer(BufferObject* buf)
+	{
+		return std::hash<std::string_view>()(std::string_view((const char*)buf->Data, buf->Size));
+	}
+
 	std::string toGenericPath(const std::string& p)
 	{
 		std::string ret = p;
@@ -70,18 +78,31 @@ namespace ed {
 	{
 		ResetProjectDirectory();
 		m_ui = gui;
+		m_binaryExport = false;
+		m_openingRecovery = false;
+		m_recoveryOutdated = false;
+		m_snapshot = nullptr;
 	}
 	ProjectParser::~ProjectParser()
 	{
 	}
 	void ProjectParser::Open(const std::string& file)
 	{
-		Logger::Get().Log("Openning a project file " + file);
+		Logger::Get().Log(Logger::Category::Project, Logger::Level::Info, "Openning a project file " + file);
+		TraceScope trace("Project", "ProjectParser::Open", file);
 
+		// binary projects are detected by their signature, whatever the extension is
 		pugi::xml_document doc;
-		pugi::xml_parse_result result = doc.load_file(file.c_str());
+		bool result = false;
+		if (BinaryProject::IsBinary(file)) {
+			TraceScope traceBinary("Project", "Decode binary project", file);
+			result = BinaryProject::Load(file, doc);
+		} else {
+			TraceScope traceXML("Project", "Parse XML", file);
+			result = (bool)doc.load_file(file.c_str());
+		}
 		if (!result) {
-			Logger::Get().Log("Failed to parse a project file", true);
+			Logger::Get().Log(Logger::Category::Project, Logger::Level::Error, "Failed to parse a project file");
 			return;
 		}
 
@@ -160,7 +181,7 @@ namespace ed {
 		}
 
 		if (!pluginTest) {
-			Logger::Get().Log("Missing plugin - project not loaded", true);
+			Logger::Get().Log(Logger::Category::Project, Logger::Level::Error, "Missing plugin - project not loaded");
 			return;
 		}
 
@@ -179,6 +200,10 @@ namespace ed {
 			mdl.second = nullptr;
 		}
 		m_models.clear();
+		m_pendingModels.clear();
+		m_savedBuffers.clear();
+		m_recoveryBuffers.clear();
+		m_recoveryOutdated = false;
 
 		m_pipe->Clear();
 		m_objects->Clear();
@@ -193,15 +218,20 @@ namespace ed {
 			projectVersion = projectNode.attribute("version").as_int();
 
 		// notify plugins that we've finished with loading
-		for (const auto& pname : m_pluginList)
+		for (const auto& pname : m_pluginList) {
+			TraceScope tracePlugin("Plugin", "Project_BeginLoad", pname);
 			m_plugins->GetPlugin(pname)->Project_BeginLoad();
+		}
 
-		switch (projectVersion) {
-		case 1: m_parseV1(projectNode); break;
-		case 2: m_parseV2(projectNode); break;
-		default:
-			Logger::Get().Log("Tried to open a project that is newer version", true);
-			break;
+		{
+			TraceScope traceParse("Project", "Parse project", "version " + std::to_string(projectVersion));
+			switch (projectVersion) {
+			case 1: m_parseV1(projectNode); break;
+			case 2: m_parseV2(projectNode); break;
+			default:
+				Logger::Get().Log(Logger::Category::Project, Logger::Level::Error, "Tried to open a project that is newer version");
+				break;
+			}
 		}
 
 		m_modified = false;
@@ -210,10 +240,12 @@ namespace ed {
 		SystemVariableManager::Instance().Reset();
 
 		// notify plugins that we've finished with loading
-		for (const auto& pname : m_pluginList)
+		for (const auto& pname : m_pluginList) {
+			TraceScope tracePlugin("Plugin", "Project_EndLoad", pname);
 			m_plugins->GetPlugin(pname)->Project_EndLoad();
+		}
 
-		Logger::Get().Log("Finished with parsing a project file");
+		Logger::Get().Log(Logger::Category::Project, Logger::Level::Info, "Finished with parsing a project file");
 	}
 	void ProjectParser::OpenTemplate()
 	{
@@ -226,16 +258,18 @@ namespace ed {
 	}
 	void ProjectParser::SaveAs(const std::string& file, bool copyFiles)
 	{
-		Logger::Get().Log("Saving project file...");
+		Logger::Get().Log(Logger::Category::Project, Logger::Level::Info, "Saving project file...");
 
 		m_pluginList.clear();
 		m_modified = false;
+		m_recoveryOutdated = false;
+		std::string oldFile = m_file;
 		m_file = file;
+		m_binaryExport = BinaryProject::HasBinaryExtension(file);
 		std::string oldProjectPath = m_projectPath;
 		SetProjectDirectory(file.substr(0, file.find_last_of("/\\")));
 
 		std::vector<PipelineItem*> passItems = m_pipe->GetList();
-		std::vector<pipe::ShaderPass*> collapsedSP = ((PipelineUI*)m_ui->Get(ViewID::Pipeline))->GetCollapsedItems();
 
 		std::string projectStem = "proj";
 		if (std::filesystem::path(file).has_stem())
@@ -244,7 +278,7 @@ namespace ed {
 		// copy shader files to a directory
 		std::string shadersDir = m_projectPath + "/shaders";
 		if (copyFiles) {
-			Logger::Get().Log("Copying shader files...");
+			Logger::Get().Log(Logger::Category::Project, Logger::Level::Info, "Copying shader files...");
 
 			std::filesystem::create_directories(shadersDir);
 			std::error_code errc;
@@ -272,7 +306,7 @@ namespace ed {
 					}
 
 					if (errc)
-						ed::Logger::Get().Log("Failed to copy a file (source == destination)", true);
+						ed::Logger::Get().Log(Logger::Category::Project, Logger::Level::Error, "Failed to copy a file (source == destination)");
 				} else if (passItem->Type == PipelineItem::ItemType::ComputePass) {
 					pipe::ComputePass* passData = (pipe::ComputePass*)passItem->Data;
 
@@ -281,7 +315,7 @@ namespace ed {
 
 					std::filesystem::copy_file(cs, shadersDir + "/" + newShaderFilename(projectStem, passItem->Name, "CS", csExt), std::filesystem::copy_options::overwrite_existing, errc);
 					if (errc)
-						ed::Logger::Get().Log("Failed to copy a file (source == destination)", true);
+						ed::Logger::Get().Log(Logger::Category::Project, Logger::Level::Error, "Failed to copy a file (source == destination)");
 				} else if (passItem->Type == PipelineItem::ItemType::AudioPass) {
 					pipe::AudioPass* passData = (pipe::AudioPass*)passItem->Data;
 
@@ -290,7 +324,7 @@ namespace ed {
 
 					std::filesystem::copy_file(ss, shadersDir + "/" + newShaderFilename(projectStem, passItem->Name, "SS", ssExt), std::filesystem::copy_options::overwrite_existing, errc);
 					if (errc)
-						ed::Logger::Get().Log("Failed to copy a file (source == destination)", true);
+						ed::Logger::Get().Log(Logger::Category::Project, Logger::Level::Error, "Failed to copy a file (source == destination)");
 				} else if (passItem->Type == PipelineItem::ItemType::PluginItem) {
 					pipe::PluginItemData* pdata = (pipe::PluginItemData*)passItem->Data;
 					m_addPlugin(m_plugins->GetPluginName(pdata->Owner));
@@ -302,6 +336,51 @@ namespace ed {
 		}
 
 		pugi::xml_document doc;
+		std::vector<std::string> buffers;
+		m_exportProject(doc, oldProjectPath, copyFiles, projectStem, buffers);
+
+		// only write buffers that changed since they were last saved
+		bool projectMoved = oldProjectPath != m_projectPath;
+		for (const auto& name : buffers) {
+			BufferObject* bobj = m_objects->GetBuffer(name);
+			size_t hash = hashBuffer(bobj);
+
+			std::string bPath = GetProjectPath("buffers/" + name + ".buf");
+			auto savedHash = m_savedBuffers.find(name);
+			if (!projectMoved && savedHash != m_savedBuffers.end() && savedHash->second == hash && std::filesystem::exists(bPath))
+				continue;
+
+			if (!std::filesystem::exists(GetProjectPath("buffers")))
+				std::filesystem::create_directories(GetProjectPath("buffers"));
+
+			std::ofstream bufWrite(bPath, std::ios::binary);
+			bufWrite.write((char*)bobj->Data, bobj->Size);
+			bufWrite.close();
+
+			m_savedBuffers[name] = hash;
+		}
+
+		bool saved = false;
+		if (m_binaryExport)
+			saved = BinaryProject::Save(file, doc);
+		else
+			saved = doc.save_file(file.c_str());
+
+		if (!saved) {
+			Logger::Get().Log(Logger::Category::Project, Logger::Level::Error, "Failed to write the project file " + file);
+			return;
+		}
+
+		// the project file is up to date - recovery files aren't needed anymore
+		if (oldFile != file)
+			DiscardRecovery(oldFile);
+		DiscardRecovery(file);
+	}
+	void ProjectParser::m_exportProject(pugi::xml_document& doc, const std::string& oldProjectPath, bool copyFiles, const std::string& projectStem, std::vector<std::string>& buffers)
+	{
+		std::vector<PipelineItem*> passItems = m_pipe->GetList();
+		std::vector<pipe::ShaderPass*> collapsedSP = ((PipelineUI*)m_ui->Get(ViewID::Pipeline))->GetCollapsedItems();
+
 		pugi::xml_node projectNode = doc.append_child("project");
 		projectNode.append_attribute("version").set_value(2);
 		pugi::xml_node pipelineNode = projectNode.append_child("pipeline");
@@ -320,6 +399,10 @@ namespace ed {
 
 				passNode.append_attribute("type").set_value("shader");
 				passNode.append_attribute("active").set_value(passData->Active);
+				if (passData->Optimize)
+					passNode.append_attribute("optimize").set_value(true);
+				if (passData->Batch)
+					passNode.append_attribute("batch").set_value(true);
 
 				/* collapsed="true" attribute */
 				for (int i = 0; i < collapsedSP.size(); i++)
@@ -431,6 +514,8 @@ namespace ed {
 
 				passNode.append_attribute("type").set_value("compute");
 				passNode.append_attribute("active").set_value(passData->Active);
+				if (passData->Optimize)
+					passNode.append_attribute("optimize").set_value(true);
 
 				// compute shader
 				pugi::xml_node csNode = passNode.append_child("shader");
@@ -450,6 +535,16 @@ namespace ed {
 				workNode.append_attribute("y").set_value(passData->WorkY);
 				workNode.append_attribute("z").set_value(passData->WorkZ);
 
+				if (passData->Iterations > 1)
+					passNode.append_attribute("iterations").set_value(passData->Iterations);
+
+				// group counts read from a buffer
+				if (passData->IndirectBuffer != nullptr) {
+					pugi::xml_node indirectNode = passNode.append_child("indirect");
+					indirectNode.append_attribute("buffer").set_value(m_objects->GetBufferNameByID(((BufferObject*)passData->IndirectBuffer)->ID).c_str());
+					indirectNode.append_attribute("offset").set_value(passData->IndirectOffset);
+				}
+
 				// variables -> now global in pass element [V2]
 				m_exportShaderVariables(passNode, passData->Variables.GetVariables());
 
@@ -514,8 +609,13 @@ namespace ed {
 				pugi::xml_node camsnapNode = camsnapsNode.append_child("camera");
 				camsnapNode.append_attribute("name").set_value(name.c_str());
 
-				pugi::xml_node valueRowNode = camsnapNode.append_child("row");
 				glm::mat4 cammat = CameraSnapshots::Get(name);
+				if (m_binaryExport) {
+					camsnapNode.append_child("packed").text().set(BinaryProject::ToHex(&cammat[0][0], sizeof(cammat)).c_str());
+					continue;
+				}
+
+				pugi::xml_node valueRowNode = camsnapNode.append_child("row");
 				int rowID = 0;
 				for (int i = 0; i < 16; i++) {
 					valueRowNode.append_child("value").text().set(cammat[i % 4][rowID]);
@@ -565,6 +665,7 @@ namespace ed {
 					if (rtObj->ClearColor.g != 0) textureNode.append_attribute("g").set_value(rtObj->ClearColor.g);
 					if (rtObj->ClearColor.b != 0) textureNode.append_attribute("b").set_value(rtObj->ClearColor.b);
 					if (rtObj->ClearColor.a != 0) textureNode.append_attribute("a").set_value(rtObj->ClearColor.a);
+					if (rtObj->PingPong) textureNode.append_attribute("pingpong").set_value(true);
 				}
 
 				if (isCube) {
@@ -602,6 +703,8 @@ namespace ed {
 					textureNode.append_attribute("width").set_value(iobj->Size.x);
 					textureNode.append_attribute("height").set_value(iobj->Size.y);
 					textureNode.append_attribute("format").set_value(gl::String::Format(iobj->Format));
+					if (iobj->PingPong)
+						textureNode.append_attribute("pingpong").set_value(true);
 				}
 				if (isImage3D) {
 					Image3DObject* iobj = m_objects->GetImage3D(texs[i]);
@@ -633,14 +736,10 @@ namespace ed {
 					textureNode.append_attribute("size").set_value(bobj->Size);
 					textureNode.append_attribute("format").set_value(bobj->ViewFormat);
 					textureNode.append_attribute("pausedpreview").set_value(bobj->PreviewPaused);
+					if (bobj->PingPong)
+						textureNode.append_attribute("pingpong").set_value(true);
 
-					std::string bPath = GetProjectPath("buffers/" + texs[i] + ".buf");
-					if (!std::filesystem::exists(GetProjectPath("buffers")))
-						std::filesystem::create_directories(GetProjectPath("buffers"));
-
-					std::ofstream bufWrite(bPath, std::ios::binary);
-					bufWrite.write((char*)bobj->Data, bobj->Size);
-					bufWrite.close();
+					buffers.push_back(texs[i]); // contents are written by the caller
 
 					for (int j = 0; j < passItems.size(); j++) {
 						const std::vector<GLuint>& bound = m_objects->GetUniformBindList(passItems[j]);
@@ -870,8 +969,111 @@ namespace ed {
 				pnode.append_attribute("required").set_value(m_plugins->GetPlugin(pname)->IsRequired());
 			}
 		}
+	}
+	void ProjectParser::SaveRecovery()
+	{
+		if (m_file.empty() || !m_recoveryOutdated)
+			return;
+
+		TraceScope trace("Project", "Recovery snapshot", m_file);
+
+		ProjectSnapshot* snapshot = new ProjectSnapshot();
+		snapshot->File = m_file + ".recovery";
+		snapshot->Binary = BinaryProject::HasBinaryExtension(m_file);
+
+		m_pluginList.clear();
+		m_binaryExport = snapshot->Binary;
+
+		// only the structure is built here, the values are formatted by the AutoSaver thread
+		std::vector<std::string> buffers;
+		m_snapshot = snapshot;
+		m_exportProject(snapshot->Document, m_projectPath, false, "", buffers);
+		m_snapshot = nullptr;
+
+		// raw copies - hashed & compared with the files on the disk by the AutoSaver thread
+		for (const auto& name : buffers) {
+			BufferObject* bobj = m_objects->GetBuffer(name);
+			const char* data = (const char*)bobj->Data;
+			auto savedHash = m_savedBuffers.find(name);
+
+			ProjectSnapshot::Buffer buffer;
+			buffer.Path = GetProjectPath("buffers/" + name + ".buf.recovery");
+			buffer.Data.assign(data, data + bobj->Size);
+			buffer.HasSavedHash = savedHash != m_savedBuffers.end();
+			buffer.SavedHash = buffer.HasSavedHash ? savedHash->second : 0;
+			snapshot->Buffers.push_back(std::move(buffer));
+
+			m_recoveryBuffers.insert(name);
+		}
+
+		m_autoSaver.Submit(snapshot);
+		m_recoveryOutdated = false;
+	}
+	void ProjectParser::ModifyProject()
+	{
+		m_modified = m_recoveryOutdated = true;
+		m_renderer->InvalidateTimeDependency(); // variables, objects or items might have changed
+	}
+	bool ProjectParser::HasRecovery(const std::string& file)
+	{
+		std::error_code errc;
+		std::string recoveryFile = file + ".recovery";
+		if (!std::filesystem::exists(recoveryFile, errc))
+			return false;
+
+		// ignore recovery files that are older than the project
+		if (std::filesystem::exists(file, errc))
+			return std::filesystem::last_write_time(recoveryFile, errc) >= std::filesystem::last_write_time(file, errc);
+
+		return true;
+	}
+	void ProjectParser::OpenRecovery(const std::string& file)
+	{
+		Logger::Get().Log(Logger::Category::Project, Logger::Level::Info, "Restoring unsaved changes to " + file);
+
+		m_openingRecovery = true;
+		Open(file + ".recovery");
+		m_openingRecovery = false;
+
+		if (m_file != file + ".recovery") { // couldn't be parsed
+			Open(file);
+			return;
+		}
+
+		// continue working on the original project
+		m_file = file;
+		m_modified = true;
+		m_recoveryOutdated = false;
+	}
+	void ProjectParser::DiscardRecovery(const std::string& file)
+	{
+		if (file.empty())
+			return;
+
+		m_autoSaver.Discard();
+
+		// other projects can share the buffers directory - only remove the buffers of this one
+		std::vector<std::string> buffers;
+		if (file == m_file)
+			for (const auto& buffer : m_recoveryBuffers)
+				buffers.push_back(buffer);
+		m_recoveryBuffers.clear();
+
+		std::string recoveryFile = file + ".recovery";
+		pugi::xml_document doc;
+		bool parsed = BinaryProject::IsBinary(recoveryFile) ? BinaryProject::Load(recoveryFile, doc) : (bool)doc.load_file(recoveryFile.c_str());
+		if (parsed) {
+			for (pugi::xml_node objectNode : doc.child("project").child("objects").children("object"))
+				if (strcmp(objectNode.attribute("type").as_string(), "buffer") == 0)
+					buffers.push_back(objectNode.attribute("name").as_string());
+		}
+
+		std::error_code errc;
+		std::filesystem::remove(recoveryFile, errc);
 
-		doc.save_file(file.c_str());
+		std::string buffersDir = file.substr(0, file.find_last_of("/\\")) + "/buffers/";
+		for (const auto& name : buffers)
+			std::filesystem::remove(buffersDir + name + ".buf.recovery", errc);
 	}
 	std::string ProjectParser::LoadFile(const std::string& file)
 	{
@@ -914,17 +1116,29 @@ namespace ed {
 
 		return string;
 	}
-	eng::Model* ProjectParser::LoadModel(const std::string& file)
+	eng::Model* ProjectParser::LoadModel(const std::string& file, bool lazy)
 	{
 		// return already loaded model
 		for (auto& mdl : m_models)
 			if (mdl.first == file)
 				return mdl.second;
 
+		std::string path = GetProjectPath(file);
+
+		// only register it - assimp runs once a pass that uses it renders
+		if (lazy) {
+			if (!std::filesystem::exists(path))
+				return nullptr;
+
+			m_models.push_back(std::make_pair(file, new eng::Model()));
+			m_pendingModels[m_models.back().second] = path;
+			return m_models.back().second;
+		}
+
 		m_models.push_back(std::make_pair(file, new eng::Model()));
 
 		// load the model
-		std::string path = GetProjectPath(file);
+		TraceScope trace("Objects", "Load model", path);
 		bool loaded = m_models[m_models.size() - 1].second->LoadFromFile(path);
 		if (!loaded) {
 			m_models.erase(m_models.begin() + (m_models.size() - 1));
@@ -933,6 +1147,48 @@ namespace ed {
 
 		return m_models[m_models.size() - 1].second;
 	}
+	bool ProjectParser::LoadPendingModels(PipelineItem* pass)
+	{
+		if (pass->Type != PipelineItem::ItemType::ShaderPass)
+			return false;
+
+		pipe::ShaderPass* data = (pipe::ShaderPass*)pass->Data;
+		bool loaded = false;
+
+		for (PipelineItem* item : data->Items) {
+			if (item->Type != PipelineItem::ItemType::Model)
+				continue;
+
+			pipe::Model* mdl = (pipe::Model*)item->Data;
+			auto it = m_pendingModels.find(mdl->Data);
+			if (it == m_pendingModels.end())
+				continue;
+
+			std::string path = it->second;
+			m_pendingModels.erase(it);
+
+			{
+				TraceScope trace("Objects", "Load model", path);
+				if (!mdl->Data->LoadFromFile(path)) {
+					m_msgs->Add(ed::MessageStack::Type::Error, pass->Name, "Failed to load .obj model " + std::string(item->Name));
+					continue;
+				}
+			}
+
+			// same VAOs m_parseV2 builds for models that are loaded right away
+			BufferObject* bobj = (BufferObject*)mdl->InstanceBuffer;
+			for (auto& mesh : mdl->Data->Meshes) {
+				if (bobj)
+					gl::CreateVAO(mesh.VAO, mesh.VBO, data->InputLayout, mesh.EBO, bobj->ID, m_objects->ParseBufferFormat(bobj->ViewFormat));
+				else
+					gl::CreateVAO(mesh.VAO, mesh.VBO, data->InputLayout, mesh.EBO);
+			}
+
+			loaded = true;
+		}
+
+		return loaded;
+	}
 	void ProjectParser::SaveProjectFile(const std::string& file, const std::string& data)
 	{
 		std::ofstream out(GetProjectPath(file));
@@ -974,6 +1230,14 @@ namespace ed {
 
 	void ProjectParser::m_parseVariableValue(pugi::xml_node& node, ShaderVariable* var)
 	{
+		// binary projects store plain values as one hex string of the raw data
+		pugi::xml_node packedNode = node.child("packed");
+		if (packedNode && var->Function == FunctionShaderVariable::None) {
+			if (!BinaryProject::FromHex(packedNode.text().as_string(), var->Data, ShaderVariable::GetSize(var->GetType())))
+				Logger::Get().Log(Logger::Category::Project, Logger::Level::Warning, std::string("Invalid packed value for variable ") + var->Name);
+			return;
+		}
+
 		int rowID = 0;
 		for (pugi::xml_node row : node.children("row")) {
 			int colID = 0;
@@ -1009,42 +1273,36 @@ namespace ed {
 	}
 	void ProjectParser::m_exportVariableValue(pugi::xml_node& node, ShaderVariable* var)
 	{
-		pugi::xml_node valueRowNode = node.append_child("row");
-
 		if (var->Function == FunctionShaderVariable::None) {
-			int rowID = 0;
-			int limit = ShaderVariable::GetSize(var->GetType()) / 4;
-			for (int i = 0; i < limit; i++) {
-				if (var->GetType() >= ShaderVariable::ValueType::Boolean1 && var->GetType() <= ShaderVariable::ValueType::Boolean4)
-					valueRowNode.append_child("value").text().set(var->AsBoolean(i));
-				else if (var->GetType() >= ShaderVariable::ValueType::Integer1 && var->GetType() <= ShaderVariable::ValueType::Integer4)
-					valueRowNode.append_child("value").text().set(var->AsInteger(i));
-				else
-					valueRowNode.append_child("value").text().set(var->AsFloat(i % var->GetColumnCount(), rowID));
+			if (m_snapshot != nullptr) {
+				ProjectSnapshot::Value value;
+				value.Node = node;
+				value.Type = var->GetType();
+				value.Data.assign(var->Data, var->Data + ShaderVariable::GetSize(var->GetType()));
+				m_snapshot->Values.push_back(std::move(value));
+			} else
+				ProjectSnapshot::ExportValue(node, var, m_binaryExport);
+			return;
+		}
 
-				if ((i + 1) % var->GetColumnCount() == 0 && i != 0 && i != limit - 1) {
-					valueRowNode = node.append_child("row");
-					rowID++;
-				}
-			}
+		pugi::xml_node valueRowNode = node.append_child("row");
+
+		if (var->Function == FunctionShaderVariable::Pointer) {
+			valueRowNode.append_child("value").text().set(var->Arguments);
+		} else if (var->Function == FunctionShaderVariable::CameraSnapshot) {
+			valueRowNode.append_child("value").text().set(var->Arguments);
+		} else if (var->Function == FunctionShaderVariable::ObjectProperty) {
+			valueRowNode.append_child("value").text().set(var->Arguments);
+			valueRowNode.append_child("value").text().set(var->Arguments + PIPELINE_ITEM_NAME_LENGTH);
+		} else if (var->Function == FunctionShaderVariable::PluginFunction) {
+			m_addPlugin(m_plugins->GetPluginName(var->PluginFuncData.Owner));
+
+			const char* valNode = var->PluginFuncData.Owner->VariableFunctions_ExportArguments(var->PluginFuncData.Name, (plugin::VariableType)var->GetType(), var->Arguments);
+			valueRowNode.append_child("value").append_buffer(valNode, strlen(valNode));
 		} else {
-			if (var->Function == FunctionShaderVariable::Pointer) {
-				valueRowNode.append_child("value").text().set(var->Arguments);
-			} else if (var->Function == FunctionShaderVariable::CameraSnapshot) {
-				valueRowNode.append_child("value").text().set(var->Arguments);
-			} else if (var->Function == FunctionShaderVariable::ObjectProperty) {
-				valueRowNode.append_child("value").text().set(var->Arguments);
-				valueRowNode.append_child("value").text().set(var->Arguments + PIPELINE_ITEM_NAME_LENGTH);
-			} else if (var->Function == FunctionShaderVariable::PluginFunction) {
-				m_addPlugin(m_plugins->GetPluginName(var->PluginFuncData.Owner));
-
-				const char* valNode = var->PluginFuncData.Owner->VariableFunctions_ExportArguments(var->PluginFuncData.Name, (plugin::VariableType)var->GetType(), var->Arguments);
-				valueRowNode.append_child("value").append_buffer(valNode, strlen(valNode));
-			} else {
-				// save arguments
-				for (int i = 0; i < FunctionVariableManager::GetArgumentCount(var->Function); i++)
-					valueRowNode.append_child("value").text().set(*FunctionVariableManager::LoadFloat(var->Arguments, i));
-			}
+			// save arguments
+			for (int i = 0; i < FunctionVariableManager::GetArgumentCount(var->Function); i++)
+				valueRowNode.append_child("value").text().set(*FunctionVariableManager::LoadFloat(var->Arguments, i));
 		}
 	}
 	void ProjectParser::m_exportShaderVariables(pugi::xml_node& node, std::vector<ShaderVariable*>& vars)
@@ -1572,8 +1830,8 @@ namespace ed {
 			} else if (itemType == ed::PipelineItem::ItemType::Model) {
 				pipe::Model* tData = reinterpret_cast<pipe::Model*>(itemData);
 
-				//std::string objMem = LoadProjectFile(tData->Filename);
-				eng::Model* ptrObject = LoadModel(tData->Filename);
+				// models drawn by plugins are always loaded right away
+				eng::Model* ptrObject = LoadModel(tData->Filename, data != nullptr && Settings::Instance().General.LazyLoading);
 				bool loaded = ptrObject != nullptr;
 
 				if (loaded)
@@ -1595,7 +1853,7 @@ namespace ed {
 	// parser versions
 	void ProjectParser::m_parseV1(pugi::xml_node& projectNode)
 	{
-		Logger::Get().Log("Parsing a V1 project file...");
+		Logger::Get().Log(Logger::Category::Project, Logger::Level::Info, "Parsing a V1 project file...");
 
 		std::map<pipe::ShaderPass*, std::vector<std::string>> fbos;
 
@@ -2194,7 +2452,7 @@ namespace ed {
 	}
 	void ProjectParser::m_parseV2(pugi::xml_node& projectNode)
 	{
-		Logger::Get().Log("Parsing a V2 project file...");
+		Logger::Get().Log(Logger::Category::Project, Logger::Level::Info, "Parsing a V2 project file...");
 
 		Settings::Instance().Project.IncludePaths.clear();
 
@@ -2202,6 +2460,7 @@ namespace ed {
 		std::map<pipe::GeometryItem*, std::pair<std::string, pipe::ShaderPass*>> geoUBOs; // buffers that are bound to pipeline items
 		std::map<pipe::Model*, std::pair<std::string, pipe::ShaderPass*>> modelUBOs;
 		std::map<pipe::VertexBuffer*, std::pair<std::string, pipe::ShaderPass*>> vbUBOs;
+		std::map<pipe::ComputePass*, std::pair<std::string, std::string>> computeIndirect; // buffers with the group counts & pass names
 
 		// shader passes
 		for (pugi::xml_node passNode : projectNode.child("pipeline").children("pass")) {
@@ -2211,6 +2470,8 @@ namespace ed {
 			if (!passNode.attribute("name").empty())
 				strcpy(name, passNode.attribute("name").as_string());
 
+			TraceScope tracePass("Project", "Parse pass", passNode.attribute("name").as_string());
+
 			ed::PipelineItem::ItemType type = ed::PipelineItem::ItemType::ShaderPass;
 			if (!passNode.attribute("type").empty()) {
 				if (strcmp(passNode.attribute("type").as_string(), "compute") == 0)
@@ -2232,6 +2493,9 @@ namespace ed {
 				if (!passNode.attribute("active").empty())
 					data->Active = passNode.attribute("active").as_bool();
 
+				data->Optimize = passNode.attribute("optimize").as_bool(false);
+				data->Batch = passNode.attribute("batch").as_bool(false);
+
 				// check if it should be collapsed
 				if (!passNode.attribute("collapsed").empty()) {
 					bool cs = passNode.attribute("collapsed").as_bool();
@@ -2432,6 +2696,8 @@ namespace ed {
 				if (!passNode.attribute("active").empty())
 					data->Active = passNode.attribute("active").as_bool();
 
+				data->Optimize = passNode.attribute("optimize").as_bool(false);
+
 				// get shader properties (NOTE: a shader must have TYPE, PATH and ENTRY)
 				for (pugi::xml_node shaderNode : passNode.children("shader")) {
 					// parse path and type
@@ -2532,6 +2798,14 @@ namespace ed {
 				else
 					data->WorkZ = 1;
 
+				data->Iterations = std::max<int>(passNode.attribute("iterations").as_int(1), 1);
+
+				pugi::xml_node indirectNode = passNode.child("indirect");
+				if (!indirectNode.empty()) {
+					computeIndirect[data] = std::make_pair(indirectNode.attribute("buffer").as_string(), std::string(name));
+					data->IndirectOffset = indirectNode.attribute("offset").as_uint() & ~3u;
+				}
+
 				// add the item
 				m_pipe->AddComputePass(name, data);
 			} else if (type == PipelineItem::ItemType::AudioPass) {
@@ -2643,6 +2917,10 @@ namespace ed {
 			if (!camNode.attribute("name").empty())
 				camName = camNode.attribute("name").as_string();
 
+			pugi::xml_node packedNode = camNode.child("packed");
+			if (packedNode && !BinaryProject::FromHex(packedNode.text().as_string(), &camMat[0][0], sizeof(camMat)))
+				Logger::Get().Log(Logger::Category::Project, Logger::Level::Warning, "Invalid packed matrix for camera snapshot " + camName);
+
 			int rowID = 0;
 			for (pugi::xml_node row : camNode.children("row")) {
 				int colID = 0;
@@ -2659,8 +2937,11 @@ namespace ed {
 		// objects
 		std::vector<PipelineItem*> passes = m_pipe->GetList();
 		std::map<PipelineItem*, std::vector<std::string>> boundTextures, boundUBOs;
+		bool lazyLoad = Settings::Instance().General.LazyLoading; // files are decoded once a pass that binds them renders
 		for (pugi::xml_node objectNode : projectNode.child("objects").children("object")) {
 			const pugi::char_t* objType = objectNode.attribute("type").as_string();
+			const pugi::char_t* objLabel = objectNode.attribute("name").empty() ? objectNode.attribute("path").as_string() : objectNode.attribute("name").as_string();
+			TraceScope traceObject("Project", std::string("Parse ") + objType, objLabel);
 
 			if (strcmp(objType, "texture") == 0) {
 				pugi::char_t name[SHADERED_MAX_PATH];
@@ -2689,11 +2970,11 @@ namespace ed {
 				}
 
 				if (isCube)
-					m_objects->CreateCubemap(name, cubeLeft, cubeTop, cubeFront, cubeBottom, cubeRight, cubeBack);
+					m_objects->CreateCubemap(name, cubeLeft, cubeTop, cubeFront, cubeBottom, cubeRight, cubeBack, lazyLoad);
 				else if (isKeyboardTexture)
 					m_objects->CreateKeyboardTexture(name);
 				else
-					m_objects->CreateTexture(name);
+					m_objects->CreateTexture(name, lazyLoad);
 
 				for (pugi::xml_node bindNode : objectNode.children("bind")) {
 					const pugi::char_t* passBindName = bindNode.attribute("name").as_string();
@@ -2824,6 +3105,10 @@ namespace ed {
 				else
 					rt->ClearColor.a = 0;
 
+				// load ping-pong flag
+				if (objectNode.attribute("pingpong").as_bool())
+					m_objects->SetPingPong(objName, true);
+
 				// load binds
 				for (pugi::xml_node bindNode : objectNode.children("bind")) {
 					const pugi::char_t* passBindName = bindNode.attribute("name").as_string();
@@ -2866,6 +3151,10 @@ namespace ed {
 					iobj->Size.y = objectNode.attribute("height").as_int();
 				m_objects->ResizeImage(objName, iobj->Size);
 
+				// load ping-pong flag
+				if (objectNode.attribute("pingpong").as_bool())
+					m_objects->SetPingPong(objName, true);
+
 				// load binds
 				for (pugi::xml_node bindNode : objectNode.children("bind")) {
 					const pugi::char_t* passBindName = bindNode.attribute("name").as_string();
@@ -2955,7 +3244,7 @@ namespace ed {
 				pugi::char_t objPath[SHADERED_MAX_PATH];
 				strcpy(objPath, toGenericPath(objectNode.attribute("path").as_string()).c_str());
 
-				m_objects->CreateAudio(std::string(objPath));
+				m_objects->CreateAudio(std::string(objPath), lazyLoad);
 
 				for (pugi::xml_node bindNode : objectNode.children("bind")) {
 					const pugi::char_t* passBindName = bindNode.attribute("name").as_string();
@@ -2987,15 +3276,28 @@ namespace ed {
 				if (!objectNode.attribute("pausedpreview").empty())
 					buf->PreviewPaused = objectNode.attribute("pausedpreview").as_bool();
 
+				// prefer the data saved by the autosave when restoring unsaved changes
 				std::string bPath = GetProjectPath("buffers/" + std::string(objName) + ".buf");
+				bool fromRecovery = m_openingRecovery && std::filesystem::exists(bPath + ".recovery");
+				if (fromRecovery)
+					bPath += ".recovery";
+
 				std::ifstream bufRead(bPath, std::ios::binary);
-				if (bufRead.is_open())
+				if (bufRead.is_open()) {
 					bufRead.read((char*)buf->Data, buf->Size);
+					if (fromRecovery) {
+						m_recoveryBuffers.insert(objName);
+						m_autoSaver.SetBufferHash(bPath, hashBuffer(buf));
+					} else
+						m_savedBuffers[objName] = hashBuffer(buf);
+				}
 				bufRead.close();
 
-				glBindBuffer(GL_UNIFORM_BUFFER, buf->ID);
-				glBufferData(GL_UNIFORM_BUFFER, buf->Size, buf->Data, GL_STATIC_DRAW); // allocate 0 bytes of memory
-				glBindBuffer(GL_UNIFORM_BUFFER, 0);
+				m_objects->UploadBufferData(buf);
+
+				// load ping-pong flag
+				if (objectNode.attribute("pingpong").as_bool())
+					m_objects->SetPingPong(objName, true);
 
 				for (pugi::xml_node bindNode : objectNode.children("bind")) {
 					const pugi::char_t* passBindName = bindNode.attribute("name").as_string();
@@ -3079,6 +3381,13 @@ namespace ed {
 			if (bobj)
 				gl::CreateBufferVAO(vb.first->VAO, bobj->ID, m_objects->ParseBufferFormat(bobj->ViewFormat));
 		}
+		for (auto& cp : computeIndirect) {
+			BufferObject* bobj = m_objects->GetBuffer(cp.second.first);
+			cp.first->IndirectBuffer = bobj;
+
+			if (bobj == nullptr)
+				m_msgs->Add(ed::MessageStack::Type::Error, cp.second.second, "Indirect dispatch buffer " + cp.second.first + " does not exist.");
+		}
 
 		// bind objects
 		for (const auto& b : boundTextures)
@@ -3236,6 +3545,7 @@ namespace ed {
 					m_pluginList.push_back(plName);
 
 				std::string innerXML = getInnerXML(pluginDataEntry);
+				TraceScope tracePlugin("Plugin", "Project_ImportAdditionalData", plName);
 				pl->Project_ImportAdditionalData(innerXML.c_str());
 			}
 		}
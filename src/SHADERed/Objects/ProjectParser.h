@@ -1,11 +1,14 @@
 #pragma once
 #include <SHADERed/Engine/Model.h>
 #include <SHADERed/GUIManager.h>
+#include <SHADERed/Objects/AutoSaver.h>
 #include <SHADERed/Objects/MessageStack.h>
 #include <SHADERed/Objects/ShaderVariable.h>
 
 #include <pugixml/src/pugixml.hpp>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #ifdef _WIN32
 #include <windows.h>
 #endif
@@ -43,10 +46,20 @@ namespace ed {
 		void Save();
 		void SaveAs(const std::string& file, bool copyFiles = false);
 
+		// crash recovery: <project>.recovery + buffers/<name>.buf.recovery, written on a background thread
+		void SaveRecovery(); // takes a snapshot if the project changed since the last one
+		bool HasRecovery(const std::string& file);
+		void OpenRecovery(const std::string& file);
+		void DiscardRecovery(const std::string& file);
+
 		std::string LoadProjectFile(const std::string& file);
 		std::string LoadFile(const std::string& file);
 		char* LoadProjectFile(const std::string& file, size_t& len);
-		eng::Model* LoadModel(const std::string& file);
+		eng::Model* LoadModel(const std::string& file, bool lazy = false);
+
+		// lazily loaded models are empty until the pass that draws them renders
+		bool LoadPendingModels(PipelineItem* pass); // true if anything was loaded
+		inline bool HasPendingModels() { return !m_pendingModels.empty(); }
 
 		void SaveProjectFile(const std::string& file, const std::string& data);
 
@@ -61,7 +74,7 @@ namespace ed {
 		inline const std::string& GetOpenedFile() { return m_file; }
 		inline const std::string& GetTemplate() { return m_template; }
 
-		inline void ModifyProject() { m_modified = true; }
+		void ModifyProject();
 		inline bool IsProjectModified() { return m_modified; }
 
 	private:
@@ -77,6 +90,7 @@ namespace ed {
 		GLenum m_toStencilOp(const char* str);
 		GLenum m_toCullMode(const char* str);
 
+		void m_exportProject(pugi::xml_document& doc, const std::string& oldProjectPath, bool copyFiles, const std::string& projectStem, std::vector<std::string>& buffers);
 		void m_exportItems(pugi::xml_node& node, std::vector<PipelineItem*>& items, const std::string& oldProjectPath);
 		void m_importItems(const char* owner, pipe::ShaderPass* data, const pugi::xml_node& node, const std::vector<InputLayoutItem>& inpLayout,
 			std::map<pipe::GeometryItem*, std::pair<std::string, pipe::ShaderPass*>>& geoUBOs,
@@ -84,6 +98,13 @@ namespace ed {
 			std::map<pipe::VertexBuffer*, std::pair<std::string, pipe::ShaderPass*>>& vbUBOs); // TODO: why not just use PipelineItem
 
 		bool m_modified;
+		bool m_binaryExport; // SaveAs() is writing a .sprjb file
+
+		AutoSaver m_autoSaver;
+		bool m_openingRecovery, m_recoveryOutdated;
+		ProjectSnapshot* m_snapshot; // recovery snapshot that m_exportProject is filling - values are only copied
+		std::unordered_map<std::string, size_t> m_savedBuffers; // buffer name -> hash of the data in .buf
+		std::unordered_set<std::string> m_recoveryBuffers;		 // buffers that might have a .buf.recovery
 
 		GUIManager* m_ui;
 		PipelineManager* m_pipe;
@@ -100,5 +121,6 @@ namespace ed {
 		void m_addPlugin(const std::string& name);
 
 		std::vector<std::pair<std::string, eng::Model*>> m_models;
+		std::unordered_map<eng::Model*, std::string> m_pendingModels; // model -> path
 	};
 }
\ No newline at end of file
@@ -1,16 +1,23 @@
+#include <SHADERed/Engine/Frustum.h>
 #include <SHADERed/Engine/GLUtils.h>
 #include <SHADERed/Engine/GeometryFactory.h>
 #include <SHADERed/Engine/Ray.h>
 #include <SHADERed/Objects/DefaultState.h>
+#include <SHADERed/Objects/DependencyGraph.h>
+#include <SHADERed/Objects/GLState.h>
 #include <SHADERed/Objects/Logger.h>
 #include <SHADERed/Objects/Names.h>
 #include <SHADERed/Objects/ObjectManager.h>
 #include <SHADERed/Objects/PipelineManager.h>
+#include <SHADERed/Objects/ProgramCache.h>
 #include <SHADERed/Objects/RenderEngine.h>
 #include <SHADERed/Objects/Settings.h>
 #include <SHADERed/Objects/ShaderCompiler.h>
 #include <SHADERed/Objects/SystemVariableManager.h>
+#include <SHADERed/Objects/Tracer.h>
 
+#include <SFML/Audio/InputSoundFile.hpp>
+#include <SFML/Audio/OutputSoundFile.hpp>
 #include <algorithm>
 #include <glm/gtx/intersect.hpp>
 
@@ -86,6 +93,72 @@ namespace ed {
 		uint8_t* pxData = GetRawPixel(rt, data, x, y, width);
 		return ((uint32_t)pxData[0] << 0) | ((uint32_t)pxData[1] << 8) | ((uint32_t)pxData[2] << 16) | ((uint32_t)pxData[3] << 24);
 	}
+	bool GetGeometryBounds(pipe::GeometryItem* geo, glm::vec3& minb, glm::vec3& maxb)
+	{
+		// local space, Scale is part of the GeometryTransform
+		glm::vec3 size = geo->Size;
+		if (geo->Type == pipe::GeometryItem::Cube)
+			size = size / 2.0f;
+		else if (geo->Type == pipe::GeometryItem::Sphere)
+			size = glm::vec3(size.x);
+		else if (geo->Type == pipe::GeometryItem::Circle)
+			size.z = 0.0f;
+		else if (geo->Type == pipe::GeometryItem::Triangle)
+			size = glm::vec3(size.x / tan(glm::radians(30.0f)), size.x, 0.0f);
+		else if (geo->Type == pipe::GeometryItem::Plane)
+			size = glm::vec3(size.x / 2.0f, size.y / 2.0f, 0.0f);
+		else
+			return false; // screen quads are always visible
+
+		minb = -size;
+		maxb = size;
+		return true;
+	}
+	bool CanCullPass(pipe::ShaderPass* pass)
+	{
+		// the bounds can only be tested if the vertex shader most likely uses the built-in camera
+		bool hasTransform = false, hasView = false, hasProj = false, hasViewProj = false;
+		for (ShaderVariable* var : pass->Variables.GetVariables()) {
+			if (var->Flags & (char)ShaderVariable::Flag::LastFrame)
+				continue;
+
+			if (var->System == SystemShaderVariable::GeometryTransform)
+				hasTransform = true;
+			else if (var->System == SystemShaderVariable::View)
+				hasView = true;
+			else if (var->System == SystemShaderVariable::Projection)
+				hasProj = true;
+			else if (var->System == SystemShaderVariable::ViewProjection)
+				hasViewProj = true;
+			else if (var->System == SystemShaderVariable::Orthographic || var->System == SystemShaderVariable::ViewOrthographic)
+				return false;
+		}
+
+		return hasTransform && (hasViewProj || (hasView && hasProj));
+	}
+	void ReadItemBuffers(BarrierTracker& barriers, ObjectManager* objects, PipelineItem* item)
+	{
+		// buffers that a shader pass item feeds to the vertex shader
+		void* bobj = nullptr;
+		void* instBuffer = nullptr;
+		if (item->Type == PipelineItem::ItemType::Geometry) {
+			pipe::GeometryItem* geo = (pipe::GeometryItem*)item->Data;
+			if (geo->Instanced)
+				instBuffer = geo->InstanceBuffer;
+		} else if (item->Type == PipelineItem::ItemType::Model) {
+			pipe::Model* model = (pipe::Model*)item->Data;
+			if (model->Instanced)
+				instBuffer = model->InstanceBuffer;
+		} else if (item->Type == PipelineItem::ItemType::VertexBuffer)
+			bobj = ((pipe::VertexBuffer*)item->Data)->Buffer;
+		else if (item->Type == PipelineItem::ItemType::PluginItem)
+			barriers.FlushAll(); // can read anything
+
+		if (bobj != nullptr)
+			barriers.Read(objects->GetPingPongRead(((BufferObject*)bobj)->ID, true), false, GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT);
+		if (instBuffer != nullptr)
+			barriers.Read(objects->GetPingPongRead(((BufferObject*)instBuffer)->ID, true), false, GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT);
+	}
 
 	RenderEngine::RenderEngine(PipelineManager* pipeline, ObjectManager* objects, ProjectParser* project, MessageStack* msgs, PluginManager* plugins, DebugInformation* debugger)
 			: m_pipeline(pipeline)
@@ -103,6 +176,10 @@ namespace ed {
 			, m_wasMultiPick(false)
 	{
 		m_paused = false;
+		m_dirtyFrames = 1;
+		m_timeDependent = false;
+		m_timeDependencyChanged = true;
+		m_spirvSupported = GLEW_VERSION_4_6 || GLEW_ARB_gl_spirv;
 
 		glGenTextures(1, &m_rtColor);
 		glGenTextures(1, &m_rtDepth);
@@ -113,7 +190,7 @@ namespace ed {
 		m_generalDebugShader = gl::CompileShader(GL_FRAGMENT_SHADER, GeneralDebugShaderCode);
 		bool isDebugShaderCompiled = gl::CheckShaderCompilationStatus(m_generalDebugShader, msg);
 		if (!isDebugShaderCompiled)
-			Logger::Get().Log("Failed to compile the debug pixel shader.", true);
+			Logger::Get().Log(Logger::Category::Render, Logger::Level::Error, "Failed to compile the debug pixel shader.");
 	}
 	RenderEngine::~RenderEngine()
 	{
@@ -168,6 +245,9 @@ namespace ed {
 		// cache elements
 		m_cache();
 
+		if (m_objects->NeedsLoadBound() || m_project->HasPendingModels())
+			m_loadResources();
+
 		auto& systemVM = SystemVariableManager::Instance();
 
 		auto& itemVarValues = GetItemVariableValues();
@@ -176,7 +256,11 @@ namespace ed {
 		bool clearedWindow = false;
 		int debugID = DEBUG_ID_START;
 
+		GLState& glState = GLState::Instance();
+		glState.Begin();
+
 		m_plugins->BeginRender();
+		glState.Invalidate();
 
 		for (int i = 0; i < m_items.size(); i++) {
 			PipelineItem* it = m_items[i];
@@ -197,13 +281,13 @@ namespace ed {
 					continue;
 
 				// bind fbo and buffers
-				glBindFramebuffer(GL_FRAMEBUFFER, isMSAA ? m_fboMS[data] : data->FBO);
-				glDrawBuffers(data->RTCount, fboBuffers);
+				glState.BindFramebuffer(isMSAA ? m_fboMS[data] : data->FBO);
+				glState.DrawBuffers(data->RTCount, fboBuffers);
 
 				// clear depth texture
 				if (data->DepthTexture != previousDepth) {
 					if ((data->DepthTexture == m_rtDepth && !clearedWindow) || data->DepthTexture != m_rtDepth) {
-						glStencilMask(0xFFFFFFFF);
+						glState.StencilMask(0xFFFFFFFF);
 						glClearBufferfi(GL_DEPTH_STENCIL, 0, 1.0f, 0);
 					}
 
@@ -251,23 +335,25 @@ namespace ed {
 
 				// bind shaders
 				if (isDebug) {
-					data->Variables.UpdateUniformInfo(m_debugShaders[i]);
-					glUseProgram(m_debugShaders[i]);
+					GLuint debugShader = m_getDebugShader(i);
+					data->Variables.UpdateUniformInfo(debugShader);
+					glState.UseProgram(debugShader);
 				} else
-					glUseProgram(m_shaders[i]);
+					glState.UseProgram(m_shaders[i]);
 
 				// bind shader resource views
 				for (int j = 0; j < srvs.size(); j++) {
-					glActiveTexture(GL_TEXTURE0 + j);
 					if (m_objects->IsCubeMap(srvs[j]))
-						glBindTexture(GL_TEXTURE_CUBE_MAP, srvs[j]);
+						glState.BindTexture(j, GL_TEXTURE_CUBE_MAP, srvs[j]);
 					else if (m_objects->IsImage3D(srvs[j]))
-						glBindTexture(GL_TEXTURE_3D, srvs[j]);
+						glState.BindTexture(j, GL_TEXTURE_3D, srvs[j]);
 					else if (m_objects->IsPluginObject(srvs[j])) {
 						PluginObject* pobj = m_objects->GetPluginObject(srvs[j]);
+						glActiveTexture(GL_TEXTURE0 + j);
 						pobj->Owner->Object_Bind(pobj->Type, pobj->Data, pobj->ID);
+						glState.Invalidate();
 					} else
-						glBindTexture(GL_TEXTURE_2D, srvs[j]);
+						glState.BindTexture(j, GL_TEXTURE_2D, m_objects->GetPingPongRead(srvs[j], false));
 
 					
 					if (ShaderCompiler::GetShaderLanguageFromExtension(data->PSPath) == ShaderLanguage::GLSL) // TODO: or should this be for vulkan glsl too?
@@ -276,6 +362,16 @@ namespace ed {
 
 				for (int j = 0; j < ubos.size(); j++)
 					glBindBufferBase(GL_SHADER_STORAGE_BUFFER, j, ubos[j]);
+				m_bindPreviousVersions(ubos);
+
+				// wait only for the compute writes that this pass reads
+				for (int j = 0; j < srvs.size(); j++)
+					m_barriers.Read(m_objects->GetPingPongRead(srvs[j], false), true, GL_TEXTURE_FETCH_BARRIER_BIT);
+				for (int j = 0; j < ubos.size(); j++)
+					m_barriers.Read(ubos[j], false, GL_SHADER_STORAGE_BARRIER_BIT);
+				for (PipelineItem* item : data->Items)
+					ReadItemBuffers(m_barriers, m_objects, item);
+				m_barriers.Flush();
 
 				// clear messages
 				//if (m_msgs->GetGroupWarningMsgCount(it->Name) > 0)
@@ -284,10 +380,45 @@ namespace ed {
 				// bind default states for each shader pass
 				DefaultState::Bind();
 
+				// items can share one draw call if the pass opted in & nothing that is bound for them differs
+				bool canBatch = !isDebug && DrawBatcher::CanBatch(data);
+				for (int k = 0; canBatch && k < itemVarValues.size(); k++)
+					if (std::count(data->Items.begin(), data->Items.end(), itemVarValues[k].Item))
+						canBatch = false;
+				int batchRun = 0;
+
+				bool frustumCull = Settings::Instance().Preview.FrustumCulling && CanCullPass(data);
+				eng::Frustum frustum;
+				if (frustumCull)
+					frustum.SetViewProjection(systemVM.GetViewProjectionMatrix());
+
 				// render pipeline items
 				for (int j = 0; j < data->Items.size(); j++) {
 					PipelineItem* item = data->Items[j];
 
+					if (canBatch && DrawBatcher::IsBatchable(item)) {
+						int runEnd = j + 1;
+						while (runEnd < data->Items.size() && DrawBatcher::IsBatchable(data->Items[runEnd]) && DrawBatcher::IsCompatible(item, data->Items[runEnd]))
+							runEnd++;
+
+						if (runEnd - j > 1) {
+							for (int k = j; k < runEnd; k++) {
+								if (m_pickAwaiting)
+									m_pickItem(data->Items[k], m_wasMultiPick);
+								m_setGeometryTransform(data->Items[k]);
+							}
+
+							systemVM.SetPicked(false);
+							data->Variables.Bind(item);
+
+							m_batcher.Draw(data, batchRun, &data->Items[j], runEnd - j);
+							batchRun++;
+
+							j = runEnd - 1;
+							continue;
+						}
+					}
+
 					systemVM.SetPicked(false);
 
 					// update the value for this element and check if we picked it
@@ -310,34 +441,46 @@ namespace ed {
 					if (item->Type == PipelineItem::ItemType::Geometry) {
 						pipe::GeometryItem* geoData = reinterpret_cast<pipe::GeometryItem*>(item->Data);
 
-						if (geoData->Type == pipe::GeometryItem::Rectangle) {
-							// TODO: don't multiply with m_renderer->GetLastRenderSize() but rather with actual RT size
-							glm::vec3 scaleRect(geoData->Scale.x * rtSize.x, geoData->Scale.y * rtSize.y, 1.0f);
-							glm::vec3 posRect((geoData->Position.x + 0.5f) * rtSize.x, (geoData->Position.y + 0.5f) * rtSize.y, -1000.0f);
-							systemVM.SetGeometryTransform(item, scaleRect, geoData->Rotation, posRect);
-						} else
-							systemVM.SetGeometryTransform(item, geoData->Scale, geoData->Rotation, geoData->Position);
-
+						m_setGeometryTransform(item);
 						systemVM.SetPicked(std::count(m_pick.begin(), m_pick.end(), item));
 
-						// bind variables
-						data->Variables.Bind(item);
+						// instances are placed by the shader, their bounds are unknown
+						glm::vec3 minb, maxb;
+						bool visible = !frustumCull || geoData->Instanced || !GetGeometryBounds(geoData, minb, maxb) || frustum.IsBoxVisible(systemVM.GetGeometryTransform(item), minb, maxb);
 
-						glBindVertexArray(geoData->VAO);
-						if (geoData->Instanced)
-							glDrawArraysInstanced(geoData->Topology, 0, eng::GeometryFactory::VertexCount[geoData->Type], geoData->InstanceCount);
-						else
-							glDrawArrays(geoData->Topology, 0, eng::GeometryFactory::VertexCount[geoData->Type]);
+						if (visible) {
+							// bind variables
+							data->Variables.Bind(item);
+
+							m_updateVertexInput(data, item);
+							glState.BindVertexArray(geoData->VAO);
+							if (geoData->Instanced)
+								glDrawArraysInstanced(geoData->Topology, 0, eng::GeometryFactory::VertexCount[geoData->Type], geoData->InstanceCount);
+							else
+								glDrawArrays(geoData->Topology, 0, eng::GeometryFactory::VertexCount[geoData->Type]);
+						}
 					} else if (item->Type == PipelineItem::ItemType::Model) {
 						pipe::Model* objData = reinterpret_cast<pipe::Model*>(item->Data);
 
 						systemVM.SetPicked(std::count(m_pick.begin(), m_pick.end(), item));
-						systemVM.SetGeometryTransform(item, objData->Scale, objData->Rotation, objData->Position);
+						m_setGeometryTransform(item);
+						m_updateVertexInput(data, item);
 
-						// bind variables
-						data->Variables.Bind(item);
+						if (frustumCull && !objData->Instanced) {
+							glm::mat4 world = systemVM.GetGeometryTransform(item);
+							if (frustum.IsBoxVisible(world, objData->Data->GetMinBound(), objData->Data->GetMaxBound())) {
+								data->Variables.Bind(item);
+
+								for (auto& mesh : objData->Data->Meshes)
+									if (frustum.IsBoxVisible(world, mesh.MinBound, mesh.MaxBound))
+										mesh.Draw();
+							}
+						} else {
+							// bind variables
+							data->Variables.Bind(item);
 
-						objData->Data->Draw(objData->Instanced, objData->InstanceCount);
+							objData->Data->Draw(objData->Instanced, objData->InstanceCount);
+						}
 					} else if (item->Type == PipelineItem::ItemType::VertexBuffer) {
 						pipe::VertexBuffer* vbData = reinterpret_cast<pipe::VertexBuffer*>(item->Data);
 						ed::BufferObject* bobj = (ed::BufferObject*)vbData->Buffer;
@@ -357,7 +500,8 @@ namespace ed {
 								// bind variables
 								data->Variables.Bind(item);
 
-								glBindVertexArray(vbData->VAO);
+								m_updateVertexInput(data, item);
+								glState.BindVertexArray(vbData->VAO);
 								glDrawArrays(vbData->Topology, 0, vertCount);
 							}
 						}
@@ -365,51 +509,42 @@ namespace ed {
 						pipe::RenderState* state = reinterpret_cast<pipe::RenderState*>(item->Data);
 
 						// depth clamp
-						if (state->DepthClamp)
-							glEnable(GL_DEPTH_CLAMP);
-						else
-							glDisable(GL_DEPTH_CLAMP);
+						glState.Enable(GL_DEPTH_CLAMP, state->DepthClamp);
 
 						// fill mode
-						glPolygonMode(GL_FRONT_AND_BACK, state->PolygonMode);
+						glState.PolygonMode(state->PolygonMode);
 
 						// culling and front face
-						if (state->CullFace)
-							glEnable(GL_CULL_FACE);
-						else
-							glDisable(GL_CULL_FACE);
-						glCullFace(state->CullFaceType);
-						glFrontFace(state->FrontFace);
+						glState.Enable(GL_CULL_FACE, state->CullFace);
+						glState.CullFace(state->CullFaceType);
+						glState.FrontFace(state->FrontFace);
 
 						// disable blending
 						if (state->Blend && !isDebug) {
-							glEnable(GL_BLEND);
-							glBlendEquationSeparate(state->BlendFunctionColor, state->BlendFunctionAlpha);
-							glBlendFuncSeparate(state->BlendSourceFactorRGB, state->BlendDestinationFactorRGB, state->BlendSourceFactorAlpha, state->BlendDestinationFactorAlpha);
-							glBlendColor(state->BlendFactor.r, state->BlendFactor.g, state->BlendFactor.a, state->BlendFactor.a);
-							glSampleCoverage(state->AlphaToCoverage, GL_FALSE);
+							glState.Enable(GL_BLEND, true);
+							glState.BlendEquation(state->BlendFunctionColor, state->BlendFunctionAlpha);
+							glState.BlendFunc(state->BlendSourceFactorRGB, state->BlendDestinationFactorRGB, state->BlendSourceFactorAlpha, state->BlendDestinationFactorAlpha);
+							glState.BlendColor(state->BlendFactor.r, state->BlendFactor.g, state->BlendFactor.a, state->BlendFactor.a);
+							glState.SampleCoverage(state->AlphaToCoverage, GL_FALSE);
 						} else
-							glDisable(GL_BLEND);
+							glState.Enable(GL_BLEND, false);
 
 						// depth state
-						if (state->DepthTest)
-							glEnable(GL_DEPTH_TEST);
-						else
-							glDisable(GL_DEPTH_TEST);
-						glDepthMask(state->DepthMask);
-						glDepthFunc(state->DepthFunction);
-						glPolygonOffset(0.0f, state->DepthBias);
+						glState.Enable(GL_DEPTH_TEST, state->DepthTest);
+						glState.DepthMask(state->DepthMask);
+						glState.DepthFunc(state->DepthFunction);
+						glState.PolygonOffset(0.0f, state->DepthBias);
 
 						// stencil
 						if (state->StencilTest) {
-							glEnable(GL_STENCIL_TEST);
-							glStencilFuncSeparate(GL_FRONT, state->StencilFrontFaceFunction, 1, state->StencilReference);
-							glStencilFuncSeparate(GL_BACK, state->StencilBackFaceFunction, 1, state->StencilReference);
-							glStencilMask(state->StencilMask);
-							glStencilOpSeparate(GL_FRONT, state->StencilFrontFaceOpStencilFail, state->StencilFrontFaceOpDepthFail, state->StencilFrontFaceOpPass);
-							glStencilOpSeparate(GL_BACK, state->StencilBackFaceOpStencilFail, state->StencilBackFaceOpDepthFail, state->StencilBackFaceOpPass);
+							glState.Enable(GL_STENCIL_TEST, true);
+							glState.StencilFunc(GL_FRONT, state->StencilFrontFaceFunction, 1, state->StencilReference);
+							glState.StencilFunc(GL_BACK, state->StencilBackFaceFunction, 1, state->StencilReference);
+							glState.StencilMask(state->StencilMask);
+							glState.StencilOp(GL_FRONT, state->StencilFrontFaceOpStencilFail, state->StencilFrontFaceOpDepthFail, state->StencilFrontFaceOpPass);
+							glState.StencilOp(GL_BACK, state->StencilBackFaceOpStencilFail, state->StencilBackFaceOpDepthFail, state->StencilBackFaceOpPass);
 						} else
-							glDisable(GL_STENCIL_TEST);
+							glState.Enable(GL_STENCIL_TEST, false);
 					} else if (item->Type == PipelineItem::ItemType::PluginItem) {
 						pipe::PluginItemData* pldata = reinterpret_cast<pipe::PluginItemData*>(item->Data);
 
@@ -422,6 +557,7 @@ namespace ed {
 							systemVM.SetPicked(false);
 
 						pldata->Owner->PipelineItem_Execute(data, plugin::PipelineItemType::ShaderPass, pldata->Type, pldata->PluginData);
+						glState.Invalidate();
 					}
 
 					// set the old value back
@@ -433,6 +569,19 @@ namespace ed {
 
 				if (isDebug)
 					data->Variables.UpdateUniformInfo(m_shaders[i]); // return old variable data
+				else {
+					// later passes now sample what this pass rendered
+					for (int j = 0; j < data->RTCount; j++) {
+						ObjectManagerItem* ppItem = m_objects->GetPingPong(data->RenderTextures[j], false);
+						if (ppItem != nullptr)
+							ppItem->PingPongWritten = true;
+					}
+					for (int j = 0; j < ubos.size(); j++) {
+						ObjectManagerItem* ppItem = m_objects->GetPingPong(ubos[j], true);
+						if (ppItem != nullptr)
+							ppItem->PingPongWritten = true;
+					}
+				}
 
 				if (isMSAA) {
 					glBindFramebuffer(GL_READ_FRAMEBUFFER, m_fboMS[data]);
@@ -443,6 +592,7 @@ namespace ed {
 						glDrawBuffer(GL_COLOR_ATTACHMENT0 + i);
 						glBlitFramebuffer(0, 0, width, height, 0, 0, width, height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
 					}
+					glState.InvalidateFramebuffer();
 				}
 			}
 			else if (it->Type == PipelineItem::ItemType::ComputePass && !isDebug && !m_paused && m_computeSupported) {
@@ -458,106 +608,161 @@ namespace ed {
 					continue;
 
 				// bind shaders
-				glUseProgram(m_shaders[i]);
-
-				// bind shader resource views
-				for (int j = 0; j < srvs.size(); j++) {
-					glActiveTexture(GL_TEXTURE0 + j);
-					if (m_objects->IsCubeMap(srvs[j]))
-						glBindTexture(GL_TEXTURE_CUBE_MAP, srvs[j]);
-					else if (m_objects->IsImage3D(srvs[j]))
-						glBindTexture(GL_TEXTURE_3D, srvs[j]);
-					else
-						glBindTexture(GL_TEXTURE_2D, srvs[j]);
-
-					if (ShaderCompiler::GetShaderLanguageFromExtension(data->Path) == ShaderLanguage::GLSL)
-						data->Variables.UpdateTexture(m_shaders[i], j);
-				}
+				glState.UseProgram(m_shaders[i]);
 
-				// bind buffers
-				int cMax = (m_uboMax[data] = std::max<int>(ubos.size(), m_uboMax[data]));
-				for (int j = ubos.size(); j < cMax; j++)
-					glBindBufferBase(GL_SHADER_STORAGE_BUFFER, j, 0);
+				// group counts can be written by an earlier dispatch - fall back to the group size if the buffer is too small
+				BufferObject* indirect = (BufferObject*)data->IndirectBuffer;
+				bool isIndirect = indirect != nullptr && (int)(data->IndirectOffset + 3 * sizeof(GLuint)) <= indirect->Size;
+				if (isIndirect)
+					glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, m_objects->GetPingPongRead(indirect->ID, true));
 
+				// ping-pong objects this pass writes to
+				std::vector<ObjectManagerItem*> ppWrites;
 				for (int j = 0; j < ubos.size(); j++) {
-					if (m_objects->IsImage(ubos[j])) {
-						ImageObject* iobj = m_objects->GetImage(m_objects->GetImageNameByID(ubos[j])); // TODO: GetImageByID
-						glBindImageTexture(j, ubos[j], 0, GL_FALSE, 0, GL_WRITE_ONLY | GL_READ_ONLY, iobj->Format);
-					} else if (m_objects->IsImage3D(ubos[j])) {
-						Image3DObject* iobj = m_objects->GetImage3D(m_objects->GetImage3DNameByID(ubos[j]));
-						glBindImageTexture(j, ubos[j], 0, GL_TRUE, 0, GL_WRITE_ONLY | GL_READ_ONLY, iobj->Format);
-					} else if (m_objects->IsPluginObject(ubos[j])) {
-						PluginObject* pobj = m_objects->GetPluginObject(ubos[j]);
-						pobj->Owner->Object_Bind(pobj->Type, pobj->Data, pobj->ID);
-					} else
-						glBindBufferBase(GL_SHADER_STORAGE_BUFFER, j, ubos[j]);
+					ObjectManagerItem* ppItem = m_objects->GetPingPong(ubos[j], !m_objects->IsImage(ubos[j]));
+					if (ppItem != nullptr && std::count(ppWrites.begin(), ppWrites.end(), ppItem) == 0)
+						ppWrites.push_back(ppItem);
 				}
 
-				// bind variables
-				data->Variables.Bind();
+				bool pluginObjects = false;
+				int iterations = std::max<int>(data->Iterations, 1);
+				for (int k = 0; k < iterations; k++) {
+					// resources are bound once, unless the last iteration swapped some of them
+					if (k == 0 || !ppWrites.empty()) {
+						// bind shader resource views
+						for (int j = 0; j < srvs.size(); j++) {
+							if (m_objects->IsCubeMap(srvs[j]))
+								glState.BindTexture(j, GL_TEXTURE_CUBE_MAP, srvs[j]);
+							else if (m_objects->IsImage3D(srvs[j]))
+								glState.BindTexture(j, GL_TEXTURE_3D, srvs[j]);
+							else
+								glState.BindTexture(j, GL_TEXTURE_2D, m_objects->GetPingPongRead(srvs[j], false));
+
+							if (k == 0 && ShaderCompiler::GetShaderLanguageFromExtension(data->Path) == ShaderLanguage::GLSL)
+								data->Variables.UpdateTexture(m_shaders[i], j);
+						}
 
-				// call compute shader
-				glDispatchCompute(data->WorkX, data->WorkY, data->WorkZ);
+						// bind buffers
+						for (int j = 0; j < ubos.size(); j++) {
+							if (m_objects->IsImage(ubos[j])) {
+								ImageObject* iobj = m_objects->GetImage(m_objects->GetImageNameByID(ubos[j])); // TODO: GetImageByID
+								glBindImageTexture(j, ubos[j], 0, GL_FALSE, 0, GL_WRITE_ONLY | GL_READ_ONLY, iobj->Format);
+							} else if (m_objects->IsImage3D(ubos[j])) {
+								Image3DObject* iobj = m_objects->GetImage3D(m_objects->GetImage3DNameByID(ubos[j]));
+								glBindImageTexture(j, ubos[j], 0, GL_TRUE, 0, GL_WRITE_ONLY | GL_READ_ONLY, iobj->Format);
+							} else if (m_objects->IsPluginObject(ubos[j])) {
+								PluginObject* pobj = m_objects->GetPluginObject(ubos[j]);
+								pobj->Owner->Object_Bind(pobj->Type, pobj->Data, pobj->ID);
+								glState.Invalidate();
+								pluginObjects = true;
+							} else
+								glBindBufferBase(GL_SHADER_STORAGE_BUFFER, j, ubos[j]);
+						}
+						int slotCount = m_bindPreviousVersions(ubos);
 
-				// wait until it finishes
-				glMemoryBarrier(GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT | GL_UNIFORM_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
-				// or maybe until i implement these as options glMemoryBarrier(GL_ALL_BARRIER_BITS);
-			}
-			else if (it->Type == PipelineItem::ItemType::AudioPass && !isDebug) {
-				pipe::AudioPass* data = (pipe::AudioPass*)it->Data;
+						int cMax = (m_uboMax[data] = std::max<int>(slotCount, m_uboMax[data]));
+						for (int j = slotCount; j < cMax; j++)
+							glBindBufferBase(GL_SHADER_STORAGE_BUFFER, j, 0);
+					}
 
-				const std::vector<GLuint>& srvs = m_objects->GetBindList(m_items[i]);
-				const std::vector<GLuint>& ubos = m_objects->GetUniformBindList(m_items[i]);
+					// bind variables
+					systemVM.SetIterationIndex(k);
+					data->Variables.Bind();
+
+					// wait for the previous dispatches only if this one reads what they wrote
+					if (pluginObjects)
+						m_barriers.FlushAll();
+					else {
+						for (int j = 0; j < srvs.size(); j++)
+							m_barriers.Read(m_objects->GetPingPongRead(srvs[j], false), true, GL_TEXTURE_FETCH_BARRIER_BIT);
+						for (int j = 0; j < ubos.size(); j++) {
+							if (m_objects->IsImage(ubos[j]) || m_objects->IsImage3D(ubos[j]))
+								m_barriers.Read(ubos[j], true, GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+							else
+								m_barriers.Read(ubos[j], false, GL_SHADER_STORAGE_BARRIER_BIT);
+						}
+						if (isIndirect)
+							m_barriers.Read(m_objects->GetPingPongRead(indirect->ID, true), false, GL_COMMAND_BARRIER_BIT);
+						m_barriers.Flush();
+					}
 
-				// bind shader resource views
-				for (int j = 0; j < srvs.size(); j++) {
-					glActiveTexture(GL_TEXTURE0 + j);
-					if (m_objects->IsCubeMap(srvs[j]))
-						glBindTexture(GL_TEXTURE_CUBE_MAP, srvs[j]);
-					else if (m_objects->IsImage3D(srvs[j]))
-						glBindTexture(GL_TEXTURE_3D, srvs[j]);
-					else if (m_objects->IsPluginObject(srvs[j])) {
-						PluginObject* pobj = m_objects->GetPluginObject(srvs[j]);
-						pobj->Owner->Object_Bind(pobj->Type, pobj->Data, pobj->ID);
-					} else
-						glBindTexture(GL_TEXTURE_2D, srvs[j]);
+					// call compute shader
+					if (isIndirect)
+						glDispatchComputeIndirect(data->IndirectOffset);
+					else
+						glDispatchCompute(data->WorkX, data->WorkY, data->WorkZ);
+
+					// the barrier is issued later by whichever pass (or iteration) reads these
+					if (pluginObjects)
+						glMemoryBarrier(GL_ALL_BARRIER_BITS); // we don't know what plugin objects are
+					else {
+						for (int j = 0; j < ubos.size(); j++)
+							m_barriers.Write(ubos[j], m_objects->IsImage(ubos[j]) || m_objects->IsImage3D(ubos[j]));
+					}
 
-					if (ShaderCompiler::GetShaderLanguageFromExtension(data->Path) == ShaderLanguage::GLSL) // TODO: or should this be for vulkan glsl too?
-						data->Variables.UpdateTexture(m_shaders[i], j);
+					// the next iteration reads what this one wrote through the previous version
+					for (ObjectManagerItem* ppItem : ppWrites) {
+						ppItem->PingPongWritten = true;
+						if (k < iterations - 1)
+							m_swapPingPong(ppItem);
+					}
 				}
+				systemVM.SetIterationIndex(0);
 
-				// bind buffers
-				for (int j = 0; j < ubos.size(); j++) {
-					if (m_objects->IsBuffer(m_objects->GetBufferNameByID(ubos[j])))
-						glBindBufferBase(GL_SHADER_STORAGE_BUFFER, j, ubos[j]);
-				}
+				if (isIndirect)
+					glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, 0);
+			}
+			else if (it->Type == PipelineItem::ItemType::AudioPass && !isDebug) {
+				pipe::AudioPass* data = (pipe::AudioPass*)it->Data;
 
-				// bind variables
-				data->Variables.Bind();
+				m_barriers.FlushAll();
+				m_bindAudioPass(i);
 
-				data->Stream.renderAudio();
+				// with fixed time step, audio follows the render clock instead of the sound device
+				data->Stream.renderAudio(systemVM.IsFixedTimeStep() ? systemVM.GetTime() : -1.0f);
+				glState.Invalidate();
 			}
 			else if (it->Type == PipelineItem::ItemType::PluginItem) {
 				pipe::PluginItemData* pldata = reinterpret_cast<pipe::PluginItemData*>(it->Data);
 
+				m_barriers.FlushAll();
 				if (!isDebug)
 					pldata->Owner->PipelineItem_Execute(pldata->Type, pldata->PluginData, pldata->Items.data(), pldata->Items.size());
 				else if (pldata->Owner->PipelineItem_IsDebuggable(pldata->Type, pldata->PluginData))
 					pldata->Owner->PipelineItem_DebugExecute(pldata->Type, pldata->PluginData, pldata->Items.data(), pldata->Items.size(), &debugID);
+				glState.Invalidate();
 			}
 
 			if (it == breakItem && breakItem != nullptr)
 				break;
 		}
 
-		m_plugins->EndRender();
+		// readbacks, the UI & the next frame can read anything
+		m_barriers.EndFrame();
 
-		// update frame index
-		if (!m_paused) {
-			systemVM.CopyState();
-			systemVM.SetFrameIndex(systemVM.GetFrameIndex() + 1);
+		// what was written this frame becomes the previous version for the next one
+		std::vector<ObjectManagerItem*> pingPong = m_objects->GetPingPongList();
+		for (ObjectManagerItem* ppItem : pingPong) {
+			// a paused frame is rendered again until someone steps the clock, see StepPingPong()
+			if (ppItem->PingPongWritten && !isDebug) {
+				if (m_paused)
+					ppItem->PingPongPending = true;
+				else
+					m_swapPingPong(ppItem);
+			}
+			ppItem->PingPongWritten = false;
 		}
 
+		m_plugins->EndRender();
+		glState.End();
+
+		// update frame index & time
+		if (!m_paused)
+			systemVM.Tick();
+
+		if (!isDebug && m_dirtyFrames > 0)
+			m_dirtyFrames--;
+
 		// restore real render target view
 		glBindFramebuffer(GL_FRAMEBUFFER, 0);
 
@@ -583,7 +788,7 @@ namespace ed {
 					vertexPassID = i;
 
 			// _sed_dbg_pixel_color
-			GLuint sedVarLoc = glGetUniformLocation(m_debugShaders[vertexPassID], "_sed_dbg_pixel_color");
+			GLuint sedVarLoc = glGetUniformLocation(m_getDebugShader(vertexPassID), "_sed_dbg_pixel_color");
 
 			// update info
 			vertexPass->Variables.UpdateUniformInfo(m_debugShaders[vertexPassID]);
@@ -822,7 +1027,7 @@ namespace ed {
 					vertexPassID = i;
 
 			// _sed_dbg_pixel_color
-			GLuint sedVarLoc = glGetUniformLocation(m_debugShaders[vertexPassID], "_sed_dbg_pixel_color");
+			GLuint sedVarLoc = glGetUniformLocation(m_getDebugShader(vertexPassID), "_sed_dbg_pixel_color");
 
 			// update info
 			vertexPass->Variables.UpdateUniformInfo(m_debugShaders[vertexPassID]);
@@ -998,6 +1203,158 @@ namespace ed {
 
 		return 0;
 	}
+	void RenderEngine::RenderTiled(int width, int height, int tileSize, int sampleCount, unsigned char* outPixels)
+	{
+		auto& systemVM = SystemVariableManager::Instance();
+
+		// tileSize has to be a multiple of sampleCount so that no output pixel is split between two tiles
+		tileSize = std::max(sampleCount, tileSize - tileSize % sampleCount);
+
+		int fullWidth = width * sampleCount, fullHeight = height * sampleCount;
+		int tilesX = (fullWidth + tileSize - 1) / tileSize;
+		int tilesY = (fullHeight + tileSize - 1) / tileSize;
+		int bandHeight = tileSize / sampleCount;
+		int weight = sampleCount * sampleCount;
+
+		std::vector<unsigned char> tile(tileSize * tileSize * 4);
+		std::vector<unsigned int> band(width * bandHeight * 4);
+
+		for (int ty = 0; ty < tilesY; ty++) {
+			std::fill(band.begin(), band.end(), 0);
+
+			int tileH = std::min(tileSize, fullHeight - ty * tileSize);
+
+			for (int tx = 0; tx < tilesX; tx++) {
+				systemVM.SetTile(glm::vec4(tx * tileSize / (float)fullWidth, ty * tileSize / (float)fullHeight, tileSize / (float)fullWidth, tileSize / (float)fullHeight));
+
+				Render(tileSize, tileSize);
+
+				glBindTexture(GL_TEXTURE_2D, m_rtColor);
+				glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, tile.data());
+
+				// box filter the supersampled tile into the current row of output pixels
+				int tileW = std::min(tileSize, fullWidth - tx * tileSize);
+				for (int y = 0; y < tileH; y++) {
+					const unsigned char* src = &tile[y * tileSize * 4];
+					unsigned int* dst = &band[(y / sampleCount) * width * 4];
+					for (int x = 0; x < tileW; x++) {
+						unsigned int* px = &dst[((tx * tileSize + x) / sampleCount) * 4];
+						px[0] += src[x * 4 + 0];
+						px[1] += src[x * 4 + 1];
+						px[2] += src[x * 4 + 2];
+						px[3] += src[x * 4 + 3];
+					}
+				}
+			}
+
+			int rows = tileH / sampleCount;
+			unsigned char* out = outPixels + ty * bandHeight * width * 4;
+			for (int i = 0; i < rows * width * 4; i++)
+				out[i] = band[i] / weight;
+		}
+
+		glBindTexture(GL_TEXTURE_2D, 0);
+		systemVM.SetTile(glm::vec4(0, 0, 1, 1));
+	}
+	bool RenderEngine::ExportAudio(const std::string& file, float duration)
+	{
+		m_cache();
+
+		std::vector<int> passes;
+		for (int i = 0; i < m_items.size(); i++)
+			if (m_items[i]->Type == PipelineItem::ItemType::AudioPass)
+				passes.push_back(i);
+
+		if (passes.empty()) {
+			Logger::Get().Log(Logger::Category::Render, Logger::Level::Error, "Project doesn't contain any audio pass - nothing to export");
+			return false;
+		}
+
+		// SFML picks the encoder (.wav, .flac or .ogg) from the extension
+		sf::OutputSoundFile* out = new sf::OutputSoundFile();
+		if (!out->openFromFile(file, AudioShaderStream::SampleRate, 2)) {
+			Logger::Get().Log(Logger::Category::Render, Logger::Level::Error, "Failed to open \"" + file + "\" for writing");
+			delete out;
+			return false;
+		}
+
+		Logger::Get().Log(Logger::Category::Render, Logger::Level::Info, "Rendering " + std::to_string(duration) + "s of audio to \"" + file + "\"");
+
+		sf::Uint64 sampleCount = (sf::Uint64)(std::max(duration, 0.0f) * AudioShaderStream::SampleRate);
+		std::vector<float> block(AudioShaderStream::OfflineBlockSize * 2);
+		std::vector<float> mix;
+		std::vector<sf::Int16> pcm;
+
+		// render big chunks of samples at once instead of 1024 samples per draw call
+		for (sf::Uint64 done = 0; done < sampleCount;) {
+			int count = (int)std::min<sf::Uint64>(sampleCount - done, AudioShaderStream::OfflineBlockSize);
+			float startTime = (float)((double)done / AudioShaderStream::SampleRate);
+
+			mix.assign(count * 2, 0.0f);
+			for (int i : passes) {
+				pipe::AudioPass* data = (pipe::AudioPass*)m_items[i]->Data;
+
+				m_bindAudioPass(i);
+				data->Stream.renderOffline(startTime, count, block.data());
+
+				for (int s = 0; s < count * 2; s++)
+					mix[s] += block[s];
+			}
+
+			pcm.resize(count * 2);
+			for (int s = 0; s < count * 2; s++)
+				pcm[s] = (sf::Int16)(std::max(-1.0f, std::min(1.0f, mix[s])) * INT16_MAX);
+			out->write(pcm.data(), pcm.size());
+
+			done += count;
+		}
+
+		delete out; // flushes & closes the file
+
+		// sf::OutputSoundFile doesn't report write errors - read the header back to catch a full disk
+		sf::InputSoundFile written;
+		if (!written.openFromFile(file) || written.getSampleCount() < sampleCount * 2) {
+			Logger::Get().Log(Logger::Category::Render, Logger::Level::Error, "Failed to write the audio to \"" + file + "\"");
+			return false;
+		}
+
+		return true;
+	}
+	void RenderEngine::m_bindAudioPass(int index)
+	{
+		pipe::AudioPass* data = (pipe::AudioPass*)m_items[index]->Data;
+
+		glUseProgram(data->Stream.getShader());
+
+		const std::vector<GLuint>& srvs = m_objects->GetBindList(m_items[index]);
+		const std::vector<GLuint>& ubos = m_objects->GetUniformBindList(m_items[index]);
+
+		// bind shader resource views
+		for (int j = 0; j < srvs.size(); j++) {
+			glActiveTexture(GL_TEXTURE0 + j);
+			if (m_objects->IsCubeMap(srvs[j]))
+				glBindTexture(GL_TEXTURE_CUBE_MAP, srvs[j]);
+			else if (m_objects->IsImage3D(srvs[j]))
+				glBindTexture(GL_TEXTURE_3D, srvs[j]);
+			else if (m_objects->IsPluginObject(srvs[j])) {
+				PluginObject* pobj = m_objects->GetPluginObject(srvs[j]);
+				pobj->Owner->Object_Bind(pobj->Type, pobj->Data, pobj->ID);
+			} else
+				glBindTexture(GL_TEXTURE_2D, srvs[j]);
+
+			if (ShaderCompiler::GetShaderLanguageFromExtension(data->Path) == ShaderLanguage::GLSL) // TODO: or should this be for vulkan glsl too?
+				data->Variables.UpdateTexture(data->Stream.getShader(), j);
+		}
+
+		// bind buffers
+		for (int j = 0; j < ubos.size(); j++) {
+			if (m_objects->IsBuffer(m_objects->GetBufferNameByID(ubos[j])))
+				glBindBufferBase(GL_SHADER_STORAGE_BUFFER, j, ubos[j]);
+		}
+
+		// bind variables
+		data->Variables.Bind();
+	}
 	void RenderEngine::Pause(bool pause)
 	{
 		m_paused = pause;
@@ -1019,11 +1376,57 @@ namespace ed {
 			}
 		}
 
+		for (ObjectManagerItem* ppItem : m_objects->GetPingPongList())
+			ppItem->PingPongPending = false;
+
 		m_debug->ClearPixelList();
 	}
+	void RenderEngine::StepPingPong()
+	{
+		for (ObjectManagerItem* ppItem : m_objects->GetPingPongList())
+			if (ppItem->PingPongPending) {
+				m_swapPingPong(ppItem);
+				ppItem->PingPongPending = false;
+			}
+	}
+	bool RenderEngine::IsTimeDependent()
+	{
+		if (m_paused)
+			return false;
+		if (!m_timeDependencyChanged)
+			return m_timeDependent;
+
+		m_timeDependencyChanged = false;
+		m_timeDependent = true;
+
+		for (PipelineItem* item : m_items) {
+			if (item->Type == PipelineItem::ItemType::ShaderPass) {
+				pipe::ShaderPass* data = (pipe::ShaderPass*)item->Data;
+				for (ShaderVariable* var : data->Variables.GetVariables())
+					if (SystemVariableManager::IsTimeDependent(var->System))
+						return true;
+			} else if (item->Type == PipelineItem::ItemType::ComputePass || item->Type == PipelineItem::ItemType::AudioPass || item->Type == PipelineItem::ItemType::PluginItem)
+				return true; // compute passes usually feed their output back (simulations, particles) & we can't tell what plugins do
+		}
+
+		for (ObjectManagerItem* obj : m_objects->GetItemDataList()) {
+			if (obj->Sound != nullptr || obj->IsKeyboardTexture)
+				return true;
+			if (obj->RT != nullptr && !obj->RT->Clear)
+				return true; // accumulates over frames
+		}
+
+		// ping-pong objects are swapped every frame
+		if (!m_objects->GetPingPongList().empty())
+			return true;
+
+		m_timeDependent = false;
+		return false;
+	}
 	void RenderEngine::Recompile(const char* name)
 	{
-		Logger::Get().Log("Recompiling " + std::string(name));
+		Logger::Get().Log(Logger::Category::Render, Logger::Level::Info, "Recompiling " + std::string(name));
+		TraceScope trace("Render", "Recompile", name);
 
 		m_msgs->BuildOccured = true;
 		m_msgs->CurrentItem = name;
@@ -1034,6 +1437,9 @@ namespace ed {
 		for (int i = 0; i < m_items.size(); i++) {
 			PipelineItem* item = m_items[i];
 			if (strcmp(item->Name, name) == 0) {
+				DependencyGraph::Instance().BeginItem(name);
+				m_addDependencies(item);
+
 				if (item->Type == PipelineItem::ItemType::ShaderPass) {
 					pipe::ShaderPass* shader = (pipe::ShaderPass*)item->Data;
 
@@ -1052,6 +1458,8 @@ namespace ed {
 					ShaderLanguage psLang = ShaderCompiler::GetShaderLanguageFromExtension(shader->PSPath);
 					ShaderLanguage vsLang = ShaderCompiler::GetShaderLanguageFromExtension(shader->VSPath);
 					ShaderLanguage gsLang = ShaderCompiler::GetShaderLanguageFromExtension(shader->GSPath);
+					bool gsUsed = shader->GSUsed && strlen(shader->GSPath) > 0 && strlen(shader->GSEntry) > 0;
+					bool useSPIRV = m_canUseSPIRV(vsLang) && m_canUseSPIRV(psLang) && (!gsUsed || m_canUseSPIRV(gsLang));
 
 					// pixel shader
 					bool psCompiled = false;
@@ -1065,8 +1473,8 @@ namespace ed {
 						psContent = m_project->LoadProjectFile(shader->PSPath);
 						m_includeCheck(psContent, std::vector<std::string>(), lineBias);
 						m_applyMacros(psContent, shader);
-					} else { // HLSL / VK
-						psContent = ShaderCompiler::ConvertToGLSL(shader->PSSPV, psLang, ShaderStage::Pixel, shader->GSUsed, m_msgs);
+					} else if (!useSPIRV) { // HLSL / VK
+						psContent = ShaderCompiler::ConvertToGLSL(m_renderSPIRV(shader->PSSPV, shader->Optimize), psLang, ShaderStage::Pixel, shader->GSUsed, m_msgs);
 						psEntry = "main";
 
 						if (psLang == ShaderLanguage::Plugin)
@@ -1074,8 +1482,6 @@ namespace ed {
 					}
 
 					shader->Variables.UpdateTextureList(psContent);
-					GLuint ps = gl::CompileShader(GL_FRAGMENT_SHADER, psContent.c_str());
-					psCompiled &= gl::CheckShaderCompilationStatus(ps);
 
 					// vertex shader
 					lineBias = 0;
@@ -1091,23 +1497,19 @@ namespace ed {
 						vsContent = m_project->LoadProjectFile(shader->VSPath);
 						m_includeCheck(vsContent, std::vector<std::string>(), lineBias);
 						m_applyMacros(vsContent, shader);
-					} else { // HLSL / VK
-						vsContent = ShaderCompiler::ConvertToGLSL(shader->VSSPV, vsLang, ShaderStage::Vertex, shader->GSUsed, m_msgs);
+					} else if (!useSPIRV) { // HLSL / VK
+						vsContent = ShaderCompiler::ConvertToGLSL(m_renderSPIRV(shader->VSSPV, shader->Optimize), vsLang, ShaderStage::Vertex, shader->GSUsed, m_msgs);
 						vsEntry = "main";
 
 						if (vsLang == ShaderLanguage::Plugin)
 							vsContent = m_pluginProcessGLSL(shader->VSPath, vsContent.c_str());
 					}
 
-					GLuint vs = gl::CompileShader(GL_VERTEX_SHADER, vsContent.c_str());
-					vsCompiled &= gl::CheckShaderCompilationStatus(vs);
-
 					// geometry shader
 					bool gsCompiled = true;
-					GLuint gs = 0;
-					if (shader->GSUsed && strlen(shader->GSPath) > 0 && strlen(shader->GSEntry) > 0) {
-						std::string gsContent = "",
-									gsEntry = shader->GSEntry;
+					std::string gsContent = "";
+					if (gsUsed) {
+						std::string gsEntry = shader->GSEntry;
 
 						lineBias = 0;
 						
@@ -1120,27 +1522,81 @@ namespace ed {
 							gsContent = m_project->LoadProjectFile(shader->GSPath);
 							m_includeCheck(gsContent, std::vector<std::string>(), lineBias);
 							m_applyMacros(gsContent, shader);
-						} else { // HLSL / VK
-							gsContent = ShaderCompiler::ConvertToGLSL(shader->GSSPV, gsLang, ShaderStage::Geometry, shader->GSUsed, m_msgs);
+						} else if (!useSPIRV) { // HLSL / VK
+							gsContent = ShaderCompiler::ConvertToGLSL(m_renderSPIRV(shader->GSSPV, shader->Optimize), gsLang, ShaderStage::Geometry, shader->GSUsed, m_msgs);
 							gsEntry = "main";
 
 							if (gsLang == ShaderLanguage::Plugin)
 								gsContent = m_pluginProcessGLSL(shader->GSPath, gsContent.c_str());
 						}
 
-						gs = gl::CompileShader(GL_GEOMETRY_SHADER, gsContent.c_str());
-						gsCompiled &= gl::CheckShaderCompilationStatus(gs);
-
-						if (gsContent.empty())
+						if (gsContent.empty() && !useSPIRV)
 							gsCompiled = false;
 					}
 
+					shader->Variables.ClearSPIRVReflection();
+
+					// ARB_gl_spirv - generate the GLSL only if the driver doesn't accept the SPIR-V
+					GLuint spirvProgram = 0;
+					if (useSPIRV && vsCompiled && psCompiled && gsCompiled) {
+						if (gsUsed)
+							spirvProgram = m_linkSPIRV(shader->Variables, { GL_FRAGMENT_SHADER, GL_VERTEX_SHADER, GL_GEOMETRY_SHADER }, { &shader->PSSPV, &shader->VSSPV, &shader->GSSPV }, { shader->PSEntry, shader->VSEntry, shader->GSEntry }, shader->Optimize);
+						else
+							spirvProgram = m_linkSPIRV(shader->Variables, { GL_FRAGMENT_SHADER, GL_VERTEX_SHADER }, { &shader->PSSPV, &shader->VSSPV }, { shader->PSEntry, shader->VSEntry }, shader->Optimize);
+					}
+					if (useSPIRV && spirvProgram == 0) {
+						vsContent = ShaderCompiler::ConvertToGLSL(m_renderSPIRV(shader->VSSPV, shader->Optimize), vsLang, ShaderStage::Vertex, shader->GSUsed, m_msgs);
+						psContent = ShaderCompiler::ConvertToGLSL(m_renderSPIRV(shader->PSSPV, shader->Optimize), psLang, ShaderStage::Pixel, shader->GSUsed, m_msgs);
+						if (gsUsed) {
+							gsContent = ShaderCompiler::ConvertToGLSL(m_renderSPIRV(shader->GSSPV, shader->Optimize), gsLang, ShaderStage::Geometry, shader->GSUsed, m_msgs);
+							gsCompiled &= !gsContent.empty();
+						}
+
+						shader->Variables.UpdateTextureList(psContent);
+					}
+
+					m_shaderSources[i].VSCode = vsContent;
+					m_shaderSources[i].PSCode = psContent;
+					m_shaderSources[i].GSCode = gsContent;
+					m_shaderSources[i].SPIRV = spirvProgram != 0;
+
+					GLuint cachedProgram = spirvProgram;
+					if (cachedProgram == 0 && vsCompiled && psCompiled && gsCompiled && !vsContent.empty() && !psContent.empty())
+						cachedProgram = ProgramCache::Instance().Load({ vsContent, psContent, gsContent });
+
+					GLuint vs = 0, ps = 0, gs = 0;
+					if (cachedProgram == 0) {
+						// the status query waits for the driver, so it belongs to the span
+						{
+							TraceScope traceCompile("Shader", "GL compile (vertex)", shader->VSPath);
+							vs = gl::CompileShader(GL_VERTEX_SHADER, vsContent.c_str());
+							vsCompiled &= gl::CheckShaderCompilationStatus(vs);
+						}
+
+						{
+							TraceScope traceCompile("Shader", "GL compile (pixel)", shader->PSPath);
+							ps = gl::CompileShader(GL_FRAGMENT_SHADER, psContent.c_str());
+							psCompiled &= gl::CheckShaderCompilationStatus(ps);
+						}
+
+						if (gsUsed) {
+							TraceScope traceCompile("Shader", "GL compile (geometry)", shader->GSPath);
+							gs = gl::CompileShader(GL_GEOMETRY_SHADER, gsContent.c_str());
+							gsCompiled &= gl::CheckShaderCompilationStatus(gs);
+						}
+					}
+
 					if (m_shaders[i] != 0)
 						glDeleteProgram(m_shaders[i]);
 
-					if (!vsCompiled || !psCompiled || !gsCompiled || vsContent.empty() || psContent.empty()) {
-						Logger::Get().Log("Shaders not compiled", true);
-						if (vsContent.empty() || psContent.empty())
+					if (m_debugShaders[i] != 0)
+						glDeleteProgram(m_debugShaders[i]);
+					m_debugShaders[i] = 0;
+
+					bool sourceEmpty = spirvProgram == 0 && (vsContent.empty() || psContent.empty());
+					if (!vsCompiled || !psCompiled || !gsCompiled || sourceEmpty) {
+						Logger::Get().Log(Logger::Category::Render, Logger::Level::Error, "Shaders not compiled");
+						if (sourceEmpty)
 							m_msgs->Add(MessageStack::Type::Error, name, "Shader source empty - try recompiling");
 						else
 							m_msgs->Add(MessageStack::Type::Error, name, "Failed to compile the shader(s)");
@@ -1149,11 +1605,18 @@ namespace ed {
 					} else {
 						m_msgs->Add(MessageStack::Type::Message, name, "Compiled the shaders.");
 
-						m_shaders[i] = glCreateProgram();
-						glAttachShader(m_shaders[i], vs);
-						glAttachShader(m_shaders[i], ps);
-						if (shader->GSUsed) glAttachShader(m_shaders[i], gs);
-						glLinkProgram(m_shaders[i]);
+						if (cachedProgram != 0)
+							m_shaders[i] = cachedProgram;
+						else {
+							TraceScope traceLink("Shader", "GL link", name);
+							m_shaders[i] = glCreateProgram();
+							glAttachShader(m_shaders[i], vs);
+							glAttachShader(m_shaders[i], ps);
+							if (shader->GSUsed) glAttachShader(m_shaders[i], gs);
+							ProgramCache::Instance().PrepareLink(m_shaders[i]);
+							glLinkProgram(m_shaders[i]);
+							ProgramCache::Instance().Save(m_shaders[i], { vsContent, psContent, gsContent });
+						}
 					}
 
 					if (m_shaders[i] != 0)
@@ -1172,6 +1635,7 @@ namespace ed {
 					std::string content = "", entry = shader->Entry;
 					int lineBias = 0;
 					ShaderLanguage lang = ShaderCompiler::GetShaderLanguageFromExtension(shader->Path);
+					bool useSPIRV = m_canUseSPIRV(lang);
 
 					// compute shader
 					bool compiled = false;
@@ -1185,8 +1649,8 @@ namespace ed {
 						content = m_project->LoadProjectFile(shader->Path);
 						m_includeCheck(content, std::vector<std::string>(), lineBias);
 						m_applyMacros(content, shader);
-					} else { // HLSL / VK
-						content = ShaderCompiler::ConvertToGLSL(shader->SPV, lang, ShaderStage::Compute, false, m_msgs);
+					} else if (!useSPIRV) { // HLSL / VK
+						content = ShaderCompiler::ConvertToGLSL(m_renderSPIRV(shader->SPV, shader->Optimize), lang, ShaderStage::Compute, false, m_msgs);
 						entry = "main";
 
 						if (lang == ShaderLanguage::Plugin)
@@ -1194,15 +1658,32 @@ namespace ed {
 					}
 
 					// compute shader supported == version 4.3 == not needed: shader->Variables.UpdateTextureList(content);
-					GLuint cs = gl::CompileShader(GL_COMPUTE_SHADER, content.c_str());
-					compiled &= gl::CheckShaderCompilationStatus(cs);
+					shader->Variables.ClearSPIRVReflection();
+
+					GLuint spirvProgram = 0;
+					if (useSPIRV && compiled)
+						spirvProgram = m_linkSPIRV(shader->Variables, { GL_COMPUTE_SHADER }, { &shader->SPV }, { shader->Entry }, shader->Optimize);
+					if (useSPIRV && spirvProgram == 0)
+						content = ShaderCompiler::ConvertToGLSL(m_renderSPIRV(shader->SPV, shader->Optimize), lang, ShaderStage::Compute, false, m_msgs);
+
+					GLuint cachedProgram = spirvProgram;
+					if (cachedProgram == 0 && compiled && !content.empty())
+						cachedProgram = ProgramCache::Instance().Load({ content });
+
+					GLuint cs = 0;
+					if (cachedProgram == 0) {
+						TraceScope traceCompile("Shader", "GL compile (compute)", shader->Path);
+						cs = gl::CompileShader(GL_COMPUTE_SHADER, content.c_str());
+						compiled &= gl::CheckShaderCompilationStatus(cs);
+					}
 
 					if (m_shaders[i] != 0)
 						glDeleteProgram(m_shaders[i]);
 
-					if (!compiled || content.empty()) {
-						Logger::Get().Log("Compute shader was not compiled", true);
-						if (content.empty())
+					bool sourceEmpty = spirvProgram == 0 && content.empty();
+					if (!compiled || sourceEmpty) {
+						Logger::Get().Log(Logger::Category::Render, Logger::Level::Error, "Compute shader was not compiled");
+						if (sourceEmpty)
 							m_msgs->Add(MessageStack::Type::Error, name, "Shader source empty - try recompiling");
 						else
 							m_msgs->Add(MessageStack::Type::Error, name, "Failed to compile the compute shader");
@@ -1210,9 +1691,16 @@ namespace ed {
 					} else {
 						m_msgs->Add(MessageStack::Type::Message, name, "Compiled the compute shader.");
 
-						m_shaders[i] = glCreateProgram();
-						glAttachShader(m_shaders[i], cs);
-						glLinkProgram(m_shaders[i]);
+						if (cachedProgram != 0)
+							m_shaders[i] = cachedProgram;
+						else {
+							TraceScope traceLink("Shader", "GL link", name);
+							m_shaders[i] = glCreateProgram();
+							glAttachShader(m_shaders[i], cs);
+							ProgramCache::Instance().PrepareLink(m_shaders[i]);
+							glLinkProgram(m_shaders[i]);
+							ProgramCache::Instance().Save(m_shaders[i], { content });
+						}
 					}
 
 					glDeleteShader(cs);
@@ -1236,6 +1724,8 @@ namespace ed {
 					pipe::PluginItemData* idata = (pipe::PluginItemData*)item->Data;
 					idata->Owner->HandleRecompile(name);
 				}
+
+				DependencyGraph::Instance().EndItem();
 			}
 		}
 
@@ -1272,6 +1762,9 @@ namespace ed {
 		for (int i = 0; i < m_items.size(); i++) {
 			PipelineItem* item = m_items[i];
 			if (strcmp(item->Name, name) == 0) {
+				DependencyGraph::Instance().BeginItem(name);
+				m_addDependencies(item);
+
 				if (item->Type == PipelineItem::ItemType::ShaderPass) {
 					pipe::ShaderPass* shader = (pipe::ShaderPass*)item->Data;
 					m_msgs->ClearGroup(name);
@@ -1294,7 +1787,7 @@ namespace ed {
 							m_includeCheck(psContent, std::vector<std::string>(), lineBias);
 							m_applyMacros(psContent, shader);
 						} else { // HLSL / VK
-							psContent = ShaderCompiler::ConvertToGLSL(shader->PSSPV, psLang, ShaderStage::Pixel, shader->GSUsed, m_msgs);
+							psContent = ShaderCompiler::ConvertToGLSL(m_renderSPIRV(shader->PSSPV, shader->Optimize), psLang, ShaderStage::Pixel, shader->GSUsed, m_msgs);
 							
 							if (psLang == ShaderLanguage::Plugin)
 								psContent = m_pluginProcessGLSL(shader->PSPath, psContent.c_str());
@@ -1308,6 +1801,7 @@ namespace ed {
 
 						glDeleteShader(m_shaderSources[i].PS);
 						m_shaderSources[i].PS = ps;
+						m_shaderSources[i].PSCode = psContent;
 					}
 
 					// vertex shader
@@ -1325,7 +1819,7 @@ namespace ed {
 							m_includeCheck(vsContent, std::vector<std::string>(), lineBias);
 							m_applyMacros(vsContent, shader);
 						} else { // HLSL / VK
-							vsContent = ShaderCompiler::ConvertToGLSL(shader->VSSPV, vsLang, ShaderStage::Vertex, shader->GSUsed, m_msgs);
+							vsContent = ShaderCompiler::ConvertToGLSL(m_renderSPIRV(shader->VSSPV, shader->Optimize), vsLang, ShaderStage::Vertex, shader->GSUsed, m_msgs);
 
 							if (vsLang == ShaderLanguage::Plugin)
 								vsContent = m_pluginProcessGLSL(shader->VSPath, vsContent.c_str());
@@ -1338,6 +1832,7 @@ namespace ed {
 
 						glDeleteShader(m_shaderSources[i].VS);
 						m_shaderSources[i].VS = vs;
+						m_shaderSources[i].VSCode = vsContent;
 					}
 
 					// geometry shader
@@ -1355,7 +1850,7 @@ namespace ed {
 							m_includeCheck(gsContent, std::vector<std::string>(), lineBias);
 							m_applyMacros(gsContent, shader);
 						} else { // HLSL / VK
-							gsContent = ShaderCompiler::ConvertToGLSL(shader->GSSPV, gsLang, ShaderStage::Geometry, shader->GSUsed, m_msgs);
+							gsContent = ShaderCompiler::ConvertToGLSL(m_renderSPIRV(shader->GSSPV, shader->Optimize), gsLang, ShaderStage::Geometry, shader->GSUsed, m_msgs);
 
 							if (gsLang == ShaderLanguage::Plugin)
 								gsContent = m_pluginProcessGLSL(shader->GSPath, gsContent.c_str());
@@ -1364,16 +1859,24 @@ namespace ed {
 
 						GLuint gs = 0;
 						glDeleteShader(m_shaderSources[i].GS);
+						m_shaderSources[i].GS = 0;
+						m_shaderSources[i].GSCode = "";
 						if (shader->GSUsed && strlen(shader->GSPath) > 0 && strlen(shader->GSEntry) > 0) {
 							gs = gl::CompileShader(GL_GEOMETRY_SHADER, gsContent.c_str());
 							gsCompiled &= gl::CheckShaderCompilationStatus(gs);
 
 							m_shaderSources[i].GS = gs;
+							m_shaderSources[i].GSCode = gsContent;
 						}
 					}
 
 					if (m_shaders[i] != 0)
 						glDeleteProgram(m_shaders[i]);
+					shader->Variables.ClearSPIRVReflection();
+
+					if (m_debugShaders[i] != 0)
+						glDeleteProgram(m_debugShaders[i]);
+					m_debugShaders[i] = 0;
 
 					if (!vsCompiled || !psCompiled || !gsCompiled) {
 						m_msgs->Add(MessageStack::Type::Error, name, "Failed to compile the shader(s)");
@@ -1381,6 +1884,8 @@ namespace ed {
 					} else {
 						m_msgs->Add(MessageStack::Type::Message, name, "Compiled the shaders.");
 
+						m_restoreShaderSources(i);
+
 						m_shaders[i] = glCreateProgram();
 						glAttachShader(m_shaders[i], m_shaderSources[i].VS);
 						glAttachShader(m_shaders[i], m_shaderSources[i].PS);
@@ -1414,7 +1919,7 @@ namespace ed {
 							m_includeCheck(content, std::vector<std::string>(), lineBias);
 							m_applyMacros(content, shader);
 						} else { // HLSL / VK
-							content = ShaderCompiler::ConvertToGLSL(shader->SPV, lang, ShaderStage::Compute, false, m_msgs);
+							content = ShaderCompiler::ConvertToGLSL(m_renderSPIRV(shader->SPV, shader->Optimize), lang, ShaderStage::Compute, false, m_msgs);
 
 							if (lang == ShaderLanguage::Plugin)
 								content = m_pluginProcessGLSL(shader->Path, content.c_str());
@@ -1427,6 +1932,7 @@ namespace ed {
 
 					if (m_shaders[i] != 0)
 						glDeleteProgram(m_shaders[i]);
+					shader->Variables.ClearSPIRVReflection();
 
 					if (!compiled) {
 						m_msgs->Add(MessageStack::Type::Error, name, "Failed to compile the compute shader");
@@ -1455,6 +1961,8 @@ namespace ed {
 						shader->Stream.compileFromShaderSource(m_project, m_msgs, vssrc, shader->Macros, true);
 					shader->Variables.UpdateUniformInfo(shader->Stream.getShader());
 				}
+
+				DependencyGraph::Instance().EndItem();
 			}
 		}
 
@@ -1707,13 +2215,23 @@ namespace ed {
 			glDeleteProgram(m_shaders[i]);
 		}
 
+		for (auto& fbo : m_fboPingPong) {
+			glDeleteFramebuffers(1, &fbo.second.FBO);
+			glDeleteFramebuffers(1, &fbo.second.FBOMS);
+		}
+		m_fboPingPong.clear();
 		m_fbos.clear();
 		m_fboCount.clear();
 		m_items.clear();
+		DependencyGraph::Instance().Clear();
 		m_shaders.clear();
 		m_shaderSources.clear();
 		m_uboMax.clear();
+		while (!m_vertexInput.empty())
+			m_deleteVertexInput(m_vertexInput.begin()->first);
+		m_batcher.Clear();
 		m_fbosNeedUpdate = true;
+		m_timeDependencyChanged = true;
 
 		// clear textures
 		glBindTexture(GL_TEXTURE_2D, m_rtColor);
@@ -1729,6 +2247,21 @@ namespace ed {
 		// check for any changes
 		std::vector<ed::PipelineItem*>& items = m_pipeline->GetList();
 
+		// plugins can change their shader paths at any time
+		for (PipelineItem* item : m_items) {
+			if (item->Type != PipelineItem::ItemType::PluginItem)
+				continue;
+
+			pipe::PluginItemData* data = (pipe::PluginItemData*)item->Data;
+			if (data->Owner->ShaderFilePath_HasChanged()) {
+				data->Owner->ShaderFilePath_Update();
+
+				DependencyGraph::Instance().BeginItem(item->Name);
+				m_addDependencies(item);
+				DependencyGraph::Instance().EndItem();
+			}
+		}
+
 		// check if no major changes were made, if so dont cache for another 0.25s
 		if (m_items.size() == items.size()) {
 			if (m_cacheTimer.GetElapsedTime() > 0.5f)
@@ -1747,7 +2280,12 @@ namespace ed {
 				}
 
 			if (!found) {
-				Logger::Get().Log("Caching a new shader pass " + std::string(items[i]->Name));
+				Logger::Get().Log(Logger::Category::Render, Logger::Level::Info, "Caching a new shader pass " + std::string(items[i]->Name));
+				TraceScope traceItem("Render", "Cache pipeline item", items[i]->Name);
+
+				DependencyGraph::Instance().BeginItem(items[i]->Name);
+				m_addDependencies(items[i]);
+				m_timeDependencyChanged = true;
 
 				if (items[i]->Type == PipelineItem::ItemType::ShaderPass) {
 					pipe::ShaderPass* data = reinterpret_cast<ed::pipe::ShaderPass*>(items[i]->Data);
@@ -1760,7 +2298,8 @@ namespace ed {
 					SPIRVQueue.push_back(items[i]);
 
 					if (strlen(data->VSPath) == 0 || strlen(data->PSPath) == 0) {
-						Logger::Get().Log("No shader paths are set", true);
+						Logger::Get().Log(Logger::Category::Render, Logger::Level::Error, "No shader paths are set");
+						DependencyGraph::Instance().EndItem();
 						continue;
 					}
 
@@ -1784,6 +2323,9 @@ namespace ed {
 								psEntry = data->PSEntry;
 					ShaderLanguage vsLang = ShaderCompiler::GetShaderLanguageFromExtension(data->VSPath);
 					ShaderLanguage psLang = ShaderCompiler::GetShaderLanguageFromExtension(data->PSPath);
+					ShaderLanguage gsLang = ShaderCompiler::GetShaderLanguageFromExtension(data->GSPath);
+					bool gsUsed = data->GSUsed && strlen(data->GSEntry) > 0 && strlen(data->GSPath) > 0;
+					bool useSPIRV = m_canUseSPIRV(vsLang) && m_canUseSPIRV(psLang) && (!gsUsed || m_canUseSPIRV(gsLang));
 
 					// vertex shader
 					bool vsCompiled = false;
@@ -1798,17 +2340,14 @@ namespace ed {
 						vsContent = m_project->LoadProjectFile(data->VSPath);
 						m_includeCheck(vsContent, std::vector<std::string>(), lineBias);
 						m_applyMacros(vsContent, data);
-					} else if (vsCompiled) {
-						vsContent = ShaderCompiler::ConvertToGLSL(data->VSSPV, vsLang, ShaderStage::Vertex, data->GSUsed, m_msgs);
+					} else if (vsCompiled && !useSPIRV) {
+						vsContent = ShaderCompiler::ConvertToGLSL(m_renderSPIRV(data->VSSPV, data->Optimize), vsLang, ShaderStage::Vertex, data->GSUsed, m_msgs);
 						vsEntry = "main";
 
 						if (vsLang == ShaderLanguage::Plugin)
 							vsContent = std::string(m_pluginProcessGLSL(data->VSPath, vsContent.c_str()));
 					}
 
-					vs = gl::CompileShader(GL_VERTEX_SHADER, vsContent.c_str());
-					vsCompiled &= gl::CheckShaderCompilationStatus(vs);
-					
 					// pixel shader
 					lineBias = 0;
 					bool psCompiled = false;
@@ -1822,8 +2361,8 @@ namespace ed {
 						psContent = m_project->LoadProjectFile(data->PSPath);
 						m_includeCheck(psContent, std::vector<std::string>(), lineBias);
 						m_applyMacros(psContent, data);
-					} else if (psCompiled) { // HLSL / VK
-						psContent = ShaderCompiler::ConvertToGLSL(data->PSSPV, psLang, ShaderStage::Pixel, data->GSUsed, m_msgs);
+					} else if (psCompiled && !useSPIRV) { // HLSL / VK
+						psContent = ShaderCompiler::ConvertToGLSL(m_renderSPIRV(data->PSSPV, data->Optimize), psLang, ShaderStage::Pixel, data->GSUsed, m_msgs);
 						psEntry = "main";
 
 						if (psLang == ShaderLanguage::Plugin)
@@ -1831,15 +2370,13 @@ namespace ed {
 					}
 
 					data->Variables.UpdateTextureList(psContent);
-					ps = gl::CompileShader(GL_FRAGMENT_SHADER, psContent.c_str());
-					psCompiled &= gl::CheckShaderCompilationStatus(ps);
 					
 					// geometry shader
 					lineBias = 0;
 					bool gsCompiled = true;
-					if (data->GSUsed && strlen(data->GSEntry) > 0 && strlen(data->GSPath) > 0) {
-						std::string gsContent = "", gsEntry = data->GSEntry;
-						ShaderLanguage gsLang = ShaderCompiler::GetShaderLanguageFromExtension(data->PSPath);
+					std::string gsContent = "";
+					if (gsUsed) {
+						std::string gsEntry = data->GSEntry;
 						
 						if (gsLang == ShaderLanguage::Plugin)
 							gsCompiled = m_pluginCompileToSpirv(data->GSSPV, data->GSPath, gsEntry, plugin::ShaderStage::Geometry, data->Macros.data(), data->Macros.size());
@@ -1850,23 +2387,73 @@ namespace ed {
 							gsContent = m_project->LoadProjectFile(data->GSPath);
 							m_includeCheck(gsContent, std::vector<std::string>(), lineBias);
 							m_applyMacros(gsContent, data);
-						} else if (gsCompiled) { // HLSL
-							gsContent = ShaderCompiler::ConvertToGLSL(data->GSSPV, gsLang, ShaderStage::Geometry, data->GSUsed, m_msgs);
+						} else if (gsCompiled && !useSPIRV) { // HLSL
+							gsContent = ShaderCompiler::ConvertToGLSL(m_renderSPIRV(data->GSSPV, data->Optimize), gsLang, ShaderStage::Geometry, data->GSUsed, m_msgs);
 							gsEntry = "main";
 
 							if (gsLang == ShaderLanguage::Plugin)
 								gsContent = m_pluginProcessGLSL(data->GSPath, gsContent.c_str());
 						}
+					}
+
+					data->Variables.ClearSPIRVReflection();
 
-						gs = gl::CompileShader(GL_GEOMETRY_SHADER, gsContent.c_str());
-						gsCompiled &= gl::CheckShaderCompilationStatus(gs);
+					// ARB_gl_spirv - generate the GLSL only if the driver doesn't accept the SPIR-V
+					GLuint spirvProgram = 0;
+					if (useSPIRV && vsCompiled && psCompiled && gsCompiled) {
+						if (gsUsed)
+							spirvProgram = m_linkSPIRV(data->Variables, { GL_FRAGMENT_SHADER, GL_VERTEX_SHADER, GL_GEOMETRY_SHADER }, { &data->PSSPV, &data->VSSPV, &data->GSSPV }, { data->PSEntry, data->VSEntry, data->GSEntry }, data->Optimize);
+						else
+							spirvProgram = m_linkSPIRV(data->Variables, { GL_FRAGMENT_SHADER, GL_VERTEX_SHADER }, { &data->PSSPV, &data->VSSPV }, { data->PSEntry, data->VSEntry }, data->Optimize);
+
+						if (spirvProgram == 0) {
+							vsContent = ShaderCompiler::ConvertToGLSL(m_renderSPIRV(data->VSSPV, data->Optimize), vsLang, ShaderStage::Vertex, data->GSUsed, m_msgs);
+							psContent = ShaderCompiler::ConvertToGLSL(m_renderSPIRV(data->PSSPV, data->Optimize), psLang, ShaderStage::Pixel, data->GSUsed, m_msgs);
+							if (gsUsed)
+								gsContent = ShaderCompiler::ConvertToGLSL(m_renderSPIRV(data->GSSPV, data->Optimize), gsLang, ShaderStage::Geometry, data->GSUsed, m_msgs);
+
+							data->Variables.UpdateTextureList(psContent);
+						}
+					}
+
+					m_shaderSources[i].VSCode = vsContent;
+					m_shaderSources[i].PSCode = psContent;
+					m_shaderSources[i].GSCode = gsContent;
+					m_shaderSources[i].SPIRV = spirvProgram != 0;
+
+					// skip compiling & linking if this program was already linked before
+					GLuint cachedProgram = spirvProgram;
+					if (cachedProgram == 0 && vsCompiled && psCompiled && gsCompiled)
+						cachedProgram = ProgramCache::Instance().Load({ vsContent, psContent, gsContent });
+
+					if (cachedProgram == 0) {
+						// the status query waits for the driver, so it belongs to the span
+						{
+							TraceScope traceCompile("Shader", "GL compile (vertex)", data->VSPath);
+							vs = gl::CompileShader(GL_VERTEX_SHADER, vsContent.c_str());
+							vsCompiled &= gl::CheckShaderCompilationStatus(vs);
+						}
+
+						{
+							TraceScope traceCompile("Shader", "GL compile (pixel)", data->PSPath);
+							ps = gl::CompileShader(GL_FRAGMENT_SHADER, psContent.c_str());
+							psCompiled &= gl::CheckShaderCompilationStatus(ps);
+						}
+
+						if (gsUsed) {
+							TraceScope traceCompile("Shader", "GL compile (geometry)", data->GSPath);
+							gs = gl::CompileShader(GL_GEOMETRY_SHADER, gsContent.c_str());
+							gsCompiled &= gl::CheckShaderCompilationStatus(gs);
+						}
 					}
 
 					if (m_shaders[i] != 0)
 						glDeleteProgram(m_shaders[i]);
 
+					// debug program is linked once it is needed
 					if (m_debugShaders[i] != 0)
 						glDeleteProgram(m_debugShaders[i]);
+					m_debugShaders[i] = 0;
 
 					if (!vsCompiled || !psCompiled || !gsCompiled) {
 						m_msgs->Add(MessageStack::Type::Error, items[i]->Name, "Failed to compile the shader");
@@ -1874,22 +2461,24 @@ namespace ed {
 					} else {
 						m_msgs->ClearGroup(items[i]->Name);
 
-						m_shaders[i] = glCreateProgram();
-						glAttachShader(m_shaders[i], vs);
-						glAttachShader(m_shaders[i], ps);
-						if (data->GSUsed) glAttachShader(m_shaders[i], gs);
-						glLinkProgram(m_shaders[i]);
-
-						m_debugShaders[i] = glCreateProgram();
-						glAttachShader(m_debugShaders[i], m_generalDebugShader);
-						glAttachShader(m_debugShaders[i], vs);
-						if (data->GSUsed) glAttachShader(m_debugShaders[i], gs);
-						glLinkProgram(m_debugShaders[i]);
+						if (cachedProgram != 0)
+							m_shaders[i] = cachedProgram;
+						else {
+							TraceScope traceLink("Shader", "GL link", items[i]->Name);
+							m_shaders[i] = glCreateProgram();
+							glAttachShader(m_shaders[i], vs);
+							glAttachShader(m_shaders[i], ps);
+							if (data->GSUsed) glAttachShader(m_shaders[i], gs);
+							ProgramCache::Instance().PrepareLink(m_shaders[i]);
+							glLinkProgram(m_shaders[i]);
+							ProgramCache::Instance().Save(m_shaders[i], { vsContent, psContent, gsContent });
+						}
 					}
 
 					if (m_shaders[i] != 0)
 						data->Variables.UpdateUniformInfo(m_shaders[i]);
 
+					// stays 0 when the program came from the cache - see m_restoreShaderSources()
 					m_shaderSources[i].VS = vs;
 					m_shaderSources[i].PS = ps;
 					m_shaderSources[i].GS = gs;
@@ -1905,7 +2494,8 @@ namespace ed {
 					SPIRVQueue.push_back(items[i]);
 
 					if (strlen(data->Path) == 0) {
-						Logger::Get().Log("No shader paths are set", true);
+						Logger::Get().Log(Logger::Category::Render, Logger::Level::Error, "No shader paths are set");
+						DependencyGraph::Instance().EndItem();
 						continue;
 					}
 
@@ -1920,6 +2510,7 @@ namespace ed {
 					std::string content = "", entry = data->Entry;
 					int lineBias = 0;
 					ShaderLanguage lang = ShaderCompiler::GetShaderLanguageFromExtension(data->Path);
+					bool useSPIRV = m_canUseSPIRV(lang);
 
 					// compute shader
 					bool compiled = false;
@@ -1933,16 +2524,32 @@ namespace ed {
 						content = m_project->LoadProjectFile(data->Path);
 						m_includeCheck(content, std::vector<std::string>(), lineBias);
 						m_applyMacros(content, data);
-					} else if (compiled) { // HLSL / VK
-						content = ShaderCompiler::ConvertToGLSL(data->SPV, lang, ShaderStage::Compute, false, m_msgs);
+					} else if (compiled && !useSPIRV) { // HLSL / VK
+						content = ShaderCompiler::ConvertToGLSL(m_renderSPIRV(data->SPV, data->Optimize), lang, ShaderStage::Compute, false, m_msgs);
 						entry = "main";
 
 						if (lang == ShaderLanguage::Plugin)
 							content = m_pluginProcessGLSL(data->Path, content.c_str());
 					}
 
-					cs = gl::CompileShader(GL_COMPUTE_SHADER, content.c_str());
-					compiled &= gl::CheckShaderCompilationStatus(cs);
+					data->Variables.ClearSPIRVReflection();
+
+					GLuint spirvProgram = 0;
+					if (useSPIRV && compiled) {
+						spirvProgram = m_linkSPIRV(data->Variables, { GL_COMPUTE_SHADER }, { &data->SPV }, { data->Entry }, data->Optimize);
+						if (spirvProgram == 0)
+							content = ShaderCompiler::ConvertToGLSL(m_renderSPIRV(data->SPV, data->Optimize), lang, ShaderStage::Compute, false, m_msgs);
+					}
+
+					GLuint cachedProgram = spirvProgram;
+					if (cachedProgram == 0 && compiled)
+						cachedProgram = ProgramCache::Instance().Load({ content });
+
+					if (cachedProgram == 0) {
+						TraceScope traceCompile("Shader", "GL compile (compute)", data->Path);
+						cs = gl::CompileShader(GL_COMPUTE_SHADER, content.c_str());
+						compiled &= gl::CheckShaderCompilationStatus(cs);
+					}
 
 					if (m_shaders[i] != 0)
 						glDeleteProgram(m_shaders[i]);
@@ -1953,11 +2560,20 @@ namespace ed {
 					} else {
 						m_msgs->ClearGroup(items[i]->Name);
 
-						m_shaders[i] = glCreateProgram();
-						glAttachShader(m_shaders[i], cs);
-						glLinkProgram(m_shaders[i]);
+						if (cachedProgram != 0)
+							m_shaders[i] = cachedProgram;
+						else {
+							TraceScope traceLink("Shader", "GL link", items[i]->Name);
+							m_shaders[i] = glCreateProgram();
+							glAttachShader(m_shaders[i], cs);
+							ProgramCache::Instance().PrepareLink(m_shaders[i]);
+							glLinkProgram(m_shaders[i]);
+							ProgramCache::Instance().Save(m_shaders[i], { content });
+						}
 					}
 
+					glDeleteShader(cs);
+
 					if (m_shaders[i] != 0)
 						data->Variables.UpdateUniformInfo(m_shaders[i]);
 
@@ -1995,6 +2611,8 @@ namespace ed {
 					m_debugShaders.insert(m_debugShaders.begin() + i, 0);
 					m_shaderSources.insert(m_shaderSources.begin() + i, ShaderPack());
 				}
+
+				DependencyGraph::Instance().EndItem();
 			}
 		}
 
@@ -2011,12 +2629,17 @@ namespace ed {
 				glDeleteProgram(m_shaders[i]);
 				glDeleteProgram(m_debugShaders[i]);
 
-				Logger::Get().Log("Removing an item from cache");
+				Logger::Get().Log(Logger::Category::Render, Logger::Level::Info, "Removing an item from cache");
+				DependencyGraph::Instance().RemoveItem(m_items[i]->Name);
 
-				if (m_items[i]->Type == PipelineItem::ItemType::ShaderPass)
+				if (m_items[i]->Type == PipelineItem::ItemType::ShaderPass) {
 					m_fbos.erase((pipe::ShaderPass*)m_items[i]->Data);
+					m_deletePingPongFBO((pipe::ShaderPass*)m_items[i]->Data);
+					m_batcher.Remove((pipe::ShaderPass*)m_items[i]->Data);
+				}
 
 				m_items.erase(m_items.begin() + i);
+				m_timeDependencyChanged = true;
 				m_shaders.erase(m_shaders.begin() + i);
 				m_debugShaders.erase(m_debugShaders.begin() + i);
 				m_shaderSources.erase(m_shaderSources.begin() + i);
@@ -2031,7 +2654,7 @@ namespace ed {
 				for (int j = 0; j < items.size(); j++) {
 					// we found the original position so move the item
 					if (items[j]->Data == m_items[i]->Data) {
-						Logger::Get().Log("Updating cached item " + std::string(items[j]->Name));
+						Logger::Get().Log(Logger::Category::Render, Logger::Level::Info, "Updating cached item " + std::string(items[j]->Name));
 
 						int dest = j > i ? (j - 1) : j;
 						m_items.erase(m_items.begin() + i, m_items.begin() + i + 1);
@@ -2150,6 +2773,8 @@ namespace ed {
 	}
 	bool RenderEngine::m_pluginCompileToSpirv(std::vector<GLuint>& spvvec, const std::string& path, const std::string& entry, plugin::ShaderStage stage, ed::ShaderMacro* macros, size_t macroCount, const std::string& actualSource)
 	{
+		TraceScope trace("Plugin", "CustomLanguage_CompileToSPIRV", path);
+
 		bool ret = false;
 
 		int plLang = 0;
@@ -2208,6 +2833,7 @@ namespace ed {
 
 				if (m_project->FileExists(ipath) && std::count(includeStack.begin(), includeStack.end(), ipath) == 0) {
 					includeStack.push_back(ipath);
+					DependencyGraph::Instance().AddFile(m_project->GetProjectPath(ipath));
 
 					std::string incFileSrc = m_project->LoadProjectFile(ipath);
 					lineBias = std::count(incFileSrc.begin(), incFileSrc.end(), '\n');
@@ -2223,24 +2849,176 @@ namespace ed {
 			incLoc = src.find("#include", incLoc + 1);
 		}
 	}
+	void RenderEngine::m_addDependencies(PipelineItem* item)
+	{
+		DependencyGraph& deps = DependencyGraph::Instance();
+
+		if (item->Type == PipelineItem::ItemType::ShaderPass) {
+			pipe::ShaderPass* data = (pipe::ShaderPass*)item->Data;
+
+			deps.AddFile(m_project->GetProjectPath(data->VSPath));
+			deps.AddFile(m_project->GetProjectPath(data->PSPath));
+			if (data->GSUsed)
+				deps.AddFile(m_project->GetProjectPath(data->GSPath));
+		} else if (item->Type == PipelineItem::ItemType::ComputePass) {
+			pipe::ComputePass* data = (pipe::ComputePass*)item->Data;
+			deps.AddFile(m_project->GetProjectPath(data->Path));
+		} else if (item->Type == PipelineItem::ItemType::AudioPass) {
+			pipe::AudioPass* data = (pipe::AudioPass*)item->Data;
+			deps.AddFile(m_project->GetProjectPath(data->Path));
+		} else if (item->Type == PipelineItem::ItemType::PluginItem) {
+			pipe::PluginItemData* data = (pipe::PluginItemData*)item->Data;
+
+			int count = data->Owner->ShaderFilePath_GetCount();
+			for (int i = 0; i < count; i++)
+				deps.AddFile(m_project->GetProjectPath(data->Owner->ShaderFilePath_Get(i)));
+		}
+	}
+	void RenderEngine::m_restoreShaderSources(int index)
+	{
+		ShaderPack& pack = m_shaderSources[index];
+
+		// the pass was linked from SPIR-V - the GLSL is needed now
+		if (pack.SPIRV && m_items[index]->Type == PipelineItem::ItemType::ShaderPass) {
+			pipe::ShaderPass* pass = (pipe::ShaderPass*)m_items[index]->Data;
+
+			if (pack.VSCode.empty())
+				pack.VSCode = ShaderCompiler::ConvertToGLSL(m_renderSPIRV(pass->VSSPV, pass->Optimize), ShaderCompiler::GetShaderLanguageFromExtension(pass->VSPath), ShaderStage::Vertex, pass->GSUsed, nullptr);
+			if (pack.PSCode.empty())
+				pack.PSCode = ShaderCompiler::ConvertToGLSL(m_renderSPIRV(pass->PSSPV, pass->Optimize), ShaderCompiler::GetShaderLanguageFromExtension(pass->PSPath), ShaderStage::Pixel, pass->GSUsed, nullptr);
+			if (pack.GSCode.empty() && !pass->GSSPV.empty() && pass->GSUsed)
+				pack.GSCode = ShaderCompiler::ConvertToGLSL(m_renderSPIRV(pass->GSSPV, pass->Optimize), ShaderCompiler::GetShaderLanguageFromExtension(pass->GSPath), ShaderStage::Geometry, pass->GSUsed, nullptr);
+
+			pack.SPIRV = false;
+		}
+
+		if (pack.VS == 0 && !pack.VSCode.empty())
+			pack.VS = gl::CompileShader(GL_VERTEX_SHADER, pack.VSCode.c_str());
+		if (pack.PS == 0 && !pack.PSCode.empty())
+			pack.PS = gl::CompileShader(GL_FRAGMENT_SHADER, pack.PSCode.c_str());
+		if (pack.GS == 0 && !pack.GSCode.empty())
+			pack.GS = gl::CompileShader(GL_GEOMETRY_SHADER, pack.GSCode.c_str());
+	}
+	GLuint RenderEngine::m_getDebugShader(int index)
+	{
+		if (m_debugShaders[index] != 0 || m_shaders[index] == 0 || m_items[index]->Type != PipelineItem::ItemType::ShaderPass)
+			return m_debugShaders[index];
+
+		if (m_shaderSources[index].SPIRV)
+			m_restoreShaderSources(index);
+
+		const ShaderPack& pack = m_shaderSources[index];
+		std::vector<std::string> sources = { pack.VSCode, GeneralDebugShaderCode, pack.GSCode };
+
+		m_debugShaders[index] = ProgramCache::Instance().Load(sources);
+		if (m_debugShaders[index] == 0) {
+			m_restoreShaderSources(index);
+
+			m_debugShaders[index] = glCreateProgram();
+			glAttachShader(m_debugShaders[index], m_generalDebugShader);
+			glAttachShader(m_debugShaders[index], pack.VS);
+			if (pack.GS != 0) glAttachShader(m_debugShaders[index], pack.GS);
+			ProgramCache::Instance().PrepareLink(m_debugShaders[index]);
+			glLinkProgram(m_debugShaders[index]);
+			ProgramCache::Instance().Save(m_debugShaders[index], sources);
+		}
+
+		return m_debugShaders[index];
+	}
+	std::vector<unsigned int> RenderEngine::m_renderSPIRV(const std::vector<unsigned int>& spv, bool optimize)
+	{
+		if (!optimize)
+			return spv;
+		return ShaderCompiler::OptimizeSPIRV(spv);
+	}
+	bool RenderEngine::m_canUseSPIRV(ShaderLanguage lang)
+	{
+		return m_spirvSupported && Settings::Instance().General.DirectSPIRV && (lang == ShaderLanguage::HLSL || lang == ShaderLanguage::VulkanGLSL);
+	}
+	GLuint RenderEngine::m_linkSPIRV(ShaderVariableContainer& vars, const std::vector<GLenum>& types, const std::vector<const std::vector<unsigned int>*>& modules, const std::vector<std::string>& entries, bool optimize)
+	{
+		TraceScope trace("Shader", "GL link (SPIR-V)");
+
+		std::map<std::string, int> locations;
+		std::vector<std::string> samplers;
+		std::vector<std::vector<unsigned int>> spv(modules.size());
+
+		// leave the original modules untouched - they are also used by the debugger
+		for (int i = 0; i < modules.size(); i++) {
+			spv[i] = m_renderSPIRV(*modules[i], optimize);
+			if (!ShaderCompiler::PrepareSPIRVForGL(spv[i], locations, samplers))
+				return 0;
+		}
+
+		GLuint program = glCreateProgram();
+		std::vector<GLuint> shaders;
+		bool compiled = true;
+		for (int i = 0; i < spv.size() && compiled; i++) {
+			GLuint shader = gl::CompileSPIRVShader(types[i], spv[i], entries[i]);
+			compiled = gl::CheckShaderCompilationStatus(shader);
+
+			glAttachShader(program, shader);
+			shaders.push_back(shader);
+		}
+
+		if (compiled)
+			glLinkProgram(program);
+
+		for (GLuint shader : shaders)
+			glDeleteShader(shader);
+
+		if (!compiled || !gl::CheckShaderLinkStatus(program, nullptr)) {
+			Logger::Get().Log(Logger::Category::Render, Logger::Level::Info, "Driver didn't accept the SPIR-V - falling back to GLSL");
+			glDeleteProgram(program);
+			return 0;
+		}
+
+		vars.SetSPIRVReflection(program, locations, samplers);
+
+		return program;
+	}
 	void RenderEngine::m_updatePassFBO(ed::pipe::ShaderPass* pass)
 	{
-		bool changed = false;
+		std::vector<GLuint>& attached = m_fbos[pass];
+		bool changed = m_fboCount[pass] != pass->RTCount;
 
-		for (int i = 0; i < pass->RTCount; i++)
-			if (pass->RenderTextures[i] != m_fbos[pass][i]) {
+		for (int i = 0; i < pass->RTCount && !changed; i++)
+			if (pass->RenderTextures[i] != attached[i])
 				changed = true;
-				break;
-			}
-		for (int i = 0; i < pass->RTCount; i++)
-			m_fbos[pass][i] = pass->RenderTextures[i];
-
-		changed = changed || m_fboCount[pass] != pass->RTCount;
-		m_fboCount[pass] = pass->RTCount;
 
 		if (!changed && !m_fbosNeedUpdate)
 			return;
 
+		// swapping ping-pong render textures toggles between two sets of attachments - reuse the other fbo
+		auto other = m_fboPingPong.find(pass);
+		if (!m_fbosNeedUpdate && other != m_fboPingPong.end() && other->second.Count == pass->RTCount
+			&& std::equal(pass->RenderTextures, pass->RenderTextures + pass->RTCount, other->second.Textures.begin())) {
+			std::swap(pass->FBO, other->second.FBO);
+			std::swap(m_fboMS[pass], other->second.FBOMS);
+			std::swap(attached, other->second.Textures);
+			std::swap(m_fboCount[pass], other->second.Count);
+			return;
+		}
+
+		bool hasPingPong = false;
+		for (int i = 0; i < pass->RTCount && !hasPingPong; i++)
+			hasPingPong = pass->RenderTextures[i] != m_rtColor && m_objects->GetPingPong(pass->RenderTextures[i], false) != nullptr;
+
+		m_deletePingPongFBO(pass);
+		if (hasPingPong && pass->FBO != 0 && !m_fbosNeedUpdate) {
+			// keep the current fbo around for when the textures get swapped back
+			PassFramebuffers& fbo = m_fboPingPong[pass];
+			fbo.Textures = attached;
+			fbo.Count = m_fboCount[pass];
+			fbo.FBO = pass->FBO;
+			fbo.FBOMS = m_fboMS[pass];
+			pass->FBO = 0;
+		}
+
+		for (int i = 0; i < pass->RTCount; i++)
+			attached[i] = pass->RenderTextures[i];
+		m_fboCount[pass] = pass->RTCount;
+
 		GLuint lastID = pass->RenderTextures[pass->RTCount - 1];
 		GLuint depthID = lastID == m_rtColor ? m_rtDepth : m_objects->GetRenderTexture(lastID)->DepthStencilBuffer;
 		GLuint depthMSID = lastID == m_rtColor ? m_rtDepthMS : m_objects->GetRenderTexture(lastID)->DepthStencilBufferMS;
@@ -2286,7 +3064,184 @@ namespace ed {
 		}
 		retval = glCheckFramebufferStatus(GL_FRAMEBUFFER);
 		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		GLState::Instance().InvalidateFramebuffer();
 
 		m_fbosNeedUpdate = false;
 	}
+	void RenderEngine::m_deletePingPongFBO(pipe::ShaderPass* pass)
+	{
+		auto fbo = m_fboPingPong.find(pass);
+		if (fbo == m_fboPingPong.end())
+			return;
+
+		glDeleteFramebuffers(1, &fbo->second.FBO);
+		glDeleteFramebuffers(1, &fbo->second.FBOMS);
+		m_fboPingPong.erase(fbo);
+	}
+	void RenderEngine::m_loadResources()
+	{
+		// runs before GLState::Begin() since loading binds textures behind GLState's back
+		bool loadBound = m_objects->NeedsLoadBound();
+		for (PipelineItem* item : m_items) {
+			if (item->Type == PipelineItem::ItemType::ShaderPass) {
+				pipe::ShaderPass* data = (pipe::ShaderPass*)item->Data;
+				if (!data->Active)
+					continue;
+
+				// new meshes need their VAOs rebuilt for ping-pong instance buffers too
+				if (m_project->HasPendingModels() && m_project->LoadPendingModels(item))
+					for (PipelineItem* child : data->Items)
+						m_deleteVertexInput(child);
+			} else if (item->Type == PipelineItem::ItemType::ComputePass) {
+				if (!((pipe::ComputePass*)item->Data)->Active)
+					continue;
+			}
+
+			if (loadBound)
+				m_objects->LoadBound(item);
+		}
+
+		// objects that are still unloaded aren't used by any active pass
+		if (loadBound)
+			m_objects->ValidateBinds();
+	}
+	void RenderEngine::m_setGeometryTransform(PipelineItem* item)
+	{
+		SystemVariableManager& systemVM = SystemVariableManager::Instance();
+
+		if (item->Type == PipelineItem::ItemType::Geometry) {
+			pipe::GeometryItem* geoData = (pipe::GeometryItem*)item->Data;
+
+			if (geoData->Type == pipe::GeometryItem::Rectangle) {
+				// TODO: don't multiply with m_renderer->GetLastRenderSize() but rather with actual RT size
+				glm::vec2 viewSize = systemVM.GetViewportSize(); // size of the whole image when rendering in tiles
+				glm::vec3 scaleRect(geoData->Scale.x * viewSize.x, geoData->Scale.y * viewSize.y, 1.0f);
+				glm::vec3 posRect((geoData->Position.x + 0.5f) * viewSize.x, (geoData->Position.y + 0.5f) * viewSize.y, -1000.0f);
+				systemVM.SetGeometryTransform(item, scaleRect, geoData->Rotation, posRect);
+			} else
+				systemVM.SetGeometryTransform(item, geoData->Scale, geoData->Rotation, geoData->Position);
+		} else if (item->Type == PipelineItem::ItemType::Model) {
+			pipe::Model* objData = (pipe::Model*)item->Data;
+			systemVM.SetGeometryTransform(item, objData->Scale, objData->Rotation, objData->Position);
+		}
+	}
+	void RenderEngine::m_updateVertexInput(pipe::ShaderPass* pass, PipelineItem* item)
+	{
+		BufferObject* bobj = nullptr;
+		if (item->Type == PipelineItem::ItemType::Geometry)
+			bobj = (BufferObject*)((pipe::GeometryItem*)item->Data)->InstanceBuffer;
+		else if (item->Type == PipelineItem::ItemType::Model)
+			bobj = (BufferObject*)((pipe::Model*)item->Data)->InstanceBuffer;
+		else if (item->Type == PipelineItem::ItemType::VertexBuffer)
+			bobj = (BufferObject*)((pipe::VertexBuffer*)item->Data)->Buffer;
+
+		// VAOs of other items are built by whoever changes their buffers
+		if (bobj == nullptr || (!bobj->PingPong && m_vertexInput.count(item) == 0))
+			return;
+
+		GLuint handle = m_objects->GetPingPongRead(bobj->ID, true);
+		auto it = m_vertexInput.find(item);
+		if (it != m_vertexInput.end() && it->second.Handle == handle)
+			return;
+
+		std::vector<GLuint*> itemVAOs;
+		if (item->Type == PipelineItem::ItemType::Geometry)
+			itemVAOs.push_back(&((pipe::GeometryItem*)item->Data)->VAO);
+		else if (item->Type == PipelineItem::ItemType::Model) {
+			for (auto& mesh : ((pipe::Model*)item->Data)->Data->Meshes)
+				itemVAOs.push_back(&mesh.VAO);
+		} else
+			itemVAOs.push_back(&((pipe::VertexBuffer*)item->Data)->VAO);
+
+		// the VAOs were rebuilt somewhere else (input layout, instance buffer, model) - start over
+		if (it != m_vertexInput.end()) {
+			const std::vector<GLuint>& current = it->second.VAOs[it->second.Handle];
+			bool rebuilt = current.size() != itemVAOs.size();
+			for (int i = 0; i < current.size() && !rebuilt; i++)
+				rebuilt = current[i] != *itemVAOs[i];
+			if (rebuilt)
+				m_deleteVertexInput(item);
+		}
+
+		VertexInput& input = m_vertexInput[item];
+		std::vector<GLuint>& vaos = input.VAOs[handle];
+		if (vaos.empty()) {
+			// the first copy of the buffer reuses the item's own VAOs, the other one gets new VAOs once
+			bool ownVAOs = input.VAOs.size() == 1;
+			for (int i = 0; i < itemVAOs.size(); i++)
+				vaos.push_back(ownVAOs ? *itemVAOs[i] : 0);
+
+			if (item->Type == PipelineItem::ItemType::Geometry) {
+				pipe::GeometryItem* geo = (pipe::GeometryItem*)item->Data;
+				gl::CreateVAO(vaos[0], geo->VBO, pass->InputLayout, 0, handle, m_objects->ParseBufferFormat(bobj->ViewFormat));
+			} else if (item->Type == PipelineItem::ItemType::Model) {
+				pipe::Model* mdl = (pipe::Model*)item->Data;
+				for (int i = 0; i < mdl->Data->Meshes.size(); i++)
+					gl::CreateVAO(vaos[i], mdl->Data->Meshes[i].VBO, pass->InputLayout, mdl->Data->Meshes[i].EBO, handle, m_objects->ParseBufferFormat(bobj->ViewFormat));
+			} else
+				gl::CreateBufferVAO(vaos[0], handle, m_objects->ParseBufferFormat(bobj->ViewFormat));
+		}
+
+		for (int i = 0; i < itemVAOs.size(); i++)
+			*itemVAOs[i] = vaos[i];
+		input.Handle = handle;
+
+		GLState::Instance().InvalidateVertexArray();
+	}
+	void RenderEngine::m_deleteVertexInput(PipelineItem* item)
+	{
+		auto it = m_vertexInput.find(item);
+		if (it == m_vertexInput.end())
+			return;
+
+		// the VAOs that the item currently uses are owned (and deleted) by the item
+		for (auto& vaos : it->second.VAOs)
+			if (vaos.first != it->second.Handle && !vaos.second.empty())
+				glDeleteVertexArrays(vaos.second.size(), vaos.second.data());
+
+		m_vertexInput.erase(it);
+	}
+	int RenderEngine::m_bindPreviousVersions(const std::vector<GLuint>& ubos)
+	{
+		// previous versions of the ping-pong objects are bound after the regular slots, in the same order
+		int slot = ubos.size();
+		for (GLuint ubo : ubos) {
+			bool isImage = m_objects->IsImage(ubo);
+			ObjectManagerItem* item = m_objects->GetPingPong(ubo, !isImage);
+			if (item == nullptr || (isImage && item->Image == nullptr))
+				continue;
+
+			if (isImage) {
+				glBindImageTexture(slot, item->Image->PreviousTexture, 0, GL_FALSE, 0, GL_READ_ONLY, item->Image->Format);
+				m_barriers.Read(item->Image->PreviousTexture, true, GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+			} else {
+				glBindBufferBase(GL_SHADER_STORAGE_BUFFER, slot, item->Buffer->PreviousID);
+				m_barriers.Read(item->Buffer->PreviousID, false, GL_SHADER_STORAGE_BARRIER_BIT);
+			}
+
+			slot++;
+		}
+
+		return slot;
+	}
+	void RenderEngine::m_swapPingPong(ObjectManagerItem* item)
+	{
+		GLuint oldTexture = item->RT ? item->Texture : 0;
+
+		m_objects->SwapPingPong(item);
+
+		// shader passes render to the current handle - m_updatePassFBO switches to the fbo built for it
+		if (item->RT == nullptr)
+			return;
+
+		for (PipelineItem* pass : m_pipeline->GetList()) {
+			if (pass->Type != PipelineItem::ItemType::ShaderPass)
+				continue;
+
+			pipe::ShaderPass* data = (pipe::ShaderPass*)pass->Data;
+			for (int i = 0; i < data->RTCount; i++)
+				if (data->RenderTextures[i] == oldTexture)
+					data->RenderTextures[i] = item->Texture;
+		}
+	}
 }
\ No newline at end of file
@@ -1,10 +1,13 @@
 #pragma once
 #include <SHADERed/Engine/Timer.h>
+#include <SHADERed/Objects/BarrierTracker.h>
 #include <SHADERed/Objects/DebugInformation.h>
+#include <SHADERed/Objects/DrawBatcher.h>
 #include <SHADERed/Objects/MessageStack.h>
 #include <SHADERed/Objects/PipelineManager.h>
 #include <SHADERed/Objects/PluginManager.h>
 #include <SHADERed/Objects/ProjectParser.h>
+#include <SHADERed/Objects/ShaderLanguage.h>
 
 #include <functional>
 #include <unordered_map>
@@ -22,6 +25,7 @@
 
 namespace ed {
 	class ObjectManager;
+	class ObjectManagerItem;
 
 	class RenderEngine {
 	public:
@@ -33,6 +37,8 @@ namespace ed {
 
 		void Render(int width, int height, bool isDebug = false, PipelineItem* breakItem = nullptr);
 		inline void Render(bool isDebug = false, PipelineItem* breakItem = nullptr) { Render(m_lastSize.x, m_lastSize.y, isDebug, breakItem); }
+		// render width*sampleCount x height*sampleCount image tile by tile & downsample it to width x height RGBA8 outPixels
+		void RenderTiled(int width, int height, int tileSize, int sampleCount, unsigned char* outPixels);
 		void Recompile(const char* name);
 		void RecompileFile(const char* fname);
 		void RecompileFromSource(const char* name, const std::string& vs = "", const std::string& ps = "", const std::string& gs = "");
@@ -51,10 +57,23 @@ namespace ed {
 		inline GLuint GetTexture() { return m_rtColor; }
 		inline GLuint GetDepthTexture() { return m_rtDepth; }
 		inline glm::ivec2 GetLastRenderSize() { return m_lastSize; }
+		inline BarrierTracker& GetBarrierTracker() { return m_barriers; }
 
 		inline bool IsPaused() { return m_paused; }
 		void Pause(bool pause);
 
+		// call after stepping the frame clock manually while paused (exports, next frame button)
+		void StepPingPong();
+
+		// damage tracking - a static pipeline is only rendered again after something changed
+		inline void Invalidate() { m_dirtyFrames = 3; }
+		inline bool NeedsRender() { return m_dirtyFrames > 0 || IsTimeDependent(); }
+		inline void InvalidateTimeDependency() { m_timeDependencyChanged = true; } // call after editing the pipeline, variables or objects
+		bool IsTimeDependent();
+
+		// render all audio passes to a .wav/.flac/.ogg file without going through the sound device
+		bool ExportAudio(const std::string& file, float duration);
+
 		// list of items waiting to be parsed
 		std::vector<PipelineItem*> SPIRVQueue;
 
@@ -106,6 +125,8 @@ namespace ed {
 
 		// paused time?
 		bool m_paused;
+		int m_dirtyFrames;
+		bool m_timeDependent, m_timeDependencyChanged; // cached IsTimeDependent() result
 
 		/* 'window' FBO */
 		glm::ivec2 m_lastSize;
@@ -115,6 +136,9 @@ namespace ed {
 		// check for the #include's & change the source code accordingly (includeStack == prevent recursion)
 		void m_includeCheck(std::string& src, std::vector<std::string> includeStack, int& lineBias);
 
+		// bind resources & variables of an audio pass
+		void m_bindAudioPass(int index);
+
 		// apply macros to GLSL source code
 		void m_applyMacros(std::string& source, pipe::ShaderPass* pass);
 		void m_applyMacros(std::string& source, pipe::ComputePass* pass);
@@ -144,17 +168,53 @@ namespace ed {
 		std::unordered_map<pipe::ShaderPass*, std::vector<GLuint>> m_fbos;
 		std::unordered_map<pipe::ShaderPass*, GLuint> m_fboMS; // multisampled fbo's
 		std::unordered_map<pipe::ShaderPass*, GLuint> m_fboCount;
+		struct PassFramebuffers {
+			std::vector<GLuint> Textures;
+			GLuint Count, FBO, FBOMS;
+		};
+		std::unordered_map<pipe::ShaderPass*, PassFramebuffers> m_fboPingPong; // fbo's for the other version of the ping-pong render textures
+		void m_deletePingPongFBO(pipe::ShaderPass* pass);
 		std::unordered_map<pipe::ComputePass*, int> m_uboMax;
+		DrawBatcher m_batcher; // merged geometry of the passes that opted in with their Batch property
+		void m_setGeometryTransform(PipelineItem* item);
+		BarrierTracker m_barriers; // compute writes that later passes haven't waited for yet
 		struct ShaderPack {
-			ShaderPack() { VS = GS = PS = 0; }
+			ShaderPack() { VS = GS = PS = 0; SPIRV = false; }
 			GLuint VS, PS, GS;
+			std::string VSCode, PSCode, GSCode; // final GLSL
+			bool SPIRV; // linked from SPIR-V, GLSL wasn't generated
 		};
 		std::vector<ShaderPack> m_shaderSources;
+		void m_addDependencies(PipelineItem* item); // top-level shader files of an item, includes are added by the compilers
+		void m_restoreShaderSources(int index); // compile the shader objects skipped because of the program cache
 
 		GLuint m_generalDebugShader;
+		GLuint m_getDebugShader(int index); // debug programs are linked on first use
+
+		// ARB_gl_spirv
+		bool m_spirvSupported;
+		bool m_canUseSPIRV(ShaderLanguage lang);
+		GLuint m_linkSPIRV(ShaderVariableContainer& vars, const std::vector<GLenum>& types, const std::vector<const std::vector<unsigned int>*>& modules, const std::vector<std::string>& entries, bool optimize);
+
+		// SPIR-V that gets converted to GLSL / loaded - the original is kept for the debugger
+		std::vector<unsigned int> m_renderSPIRV(const std::vector<unsigned int>& spv, bool optimize);
 
 		void m_updatePassFBO(ed::pipe::ShaderPass* pass);
 
+		// load the lazily created objects & models that the passes which are about to render use
+		void m_loadResources();
+
+		// ping-pong objects
+		struct VertexInput {
+			GLuint Handle; // buffer that the item's VAOs currently read from
+			std::unordered_map<GLuint, std::vector<GLuint>> VAOs; // buffer -> VAO for each mesh
+		};
+		std::unordered_map<PipelineItem*, VertexInput> m_vertexInput;
+		void m_updateVertexInput(pipe::ShaderPass* pass, PipelineItem* item);
+		void m_deleteVertexInput(PipelineItem* item);
+		int m_bindPreviousVersions(const std::vector<GLuint>& ubos); // returns the number of used slots
+		void m_swapPingPong(ObjectManagerItem* item);
+
 		std::vector<ItemVariableValue> m_itemValues; // list of all values to apply once we start rendering
 
 		eng::Timer m_cacheTimer;
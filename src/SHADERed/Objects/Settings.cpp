@@ -21,6 +21,8 @@ namespace ed {
 		General.AutoRecompile = false;
 		General.AutoUniforms = true;
 		General.AutoUniformsPin = true;
+		General.DirectSPIRV = false;
+		General.LazyLoading = false;
 		General.AutoUniformsFunction = true;
 		General.AutoUniformsDelete = true;
 		General.ReopenShaders = true;
@@ -78,7 +80,10 @@ namespace ed {
 		Preview.FPSLimit = -1;
 		Preview.ApplyFPSLimitToApp = false;
 		Preview.LostFocusLimitFPS = false;
+		Preview.IdleWhenStatic = true;
+		Preview.FrustumCulling = false;
 		Preview.MSAA = 1;
+		Preview.FixedTimeStepFPS = 0;
 	}
 	void Settings::Load()
 	{
@@ -114,6 +119,8 @@ namespace ed {
 		General.AutoUniformsPin = ini.GetBoolean("general", "autouniformspin", true);
 		General.AutoUniformsFunction = ini.GetBoolean("general", "autouniformsfunction", true);
 		General.AutoUniformsDelete = ini.GetBoolean("general", "autouniformsdelete", true);
+		General.DirectSPIRV = ini.GetBoolean("general", "directspirv", false);
+		General.LazyLoading = ini.GetBoolean("general", "lazyloading", false);
 		General.StartUpTemplate = ini.Get("general", "template", "GLSL");
 		General.AutoScale = ini.GetBoolean("general", "autoscale", true);
 		General.Tips = ini.GetBoolean("general", "tips", false);
@@ -162,7 +169,10 @@ namespace ed {
 		Preview.FPSLimit = ini.GetInteger("preview", "fpslimit", -1);
 		Preview.ApplyFPSLimitToApp = ini.GetBoolean("preview", "fpslimitwholeapp", false);
 		Preview.LostFocusLimitFPS = ini.GetBoolean("preview", "fpslimitlostfocus", false);
+		Preview.IdleWhenStatic = ini.GetBoolean("preview", "idlewhenstatic", true);
+		Preview.FrustumCulling = ini.GetBoolean("preview", "frustumculling", false);
 		Preview.MSAA = ini.GetInteger("preview", "msaa", 1);
+		Preview.FixedTimeStepFPS = ini.GetInteger("preview", "fixedtimestepfps", 0);
 
 		m_parseExt(ini.Get("plugins", "notloaded", ""), Plugins.NotLoaded);
 
@@ -203,6 +213,8 @@ namespace ed {
 		ini << "autouniformspin=" << General.AutoUniformsPin << std::endl;
 		ini << "autouniformsfunction=" << General.AutoUniformsFunction << std::endl;
 		ini << "autouniformsdelete=" << General.AutoUniformsDelete << std::endl;
+		ini << "directspirv=" << General.DirectSPIRV << std::endl;
+		ini << "lazyloading=" << General.LazyLoading << std::endl;
 		ini << "template=" << General.StartUpTemplate << std::endl;
 		ini << "font=" << General.Font << std::endl;
 		ini << "fontsize=" << General.FontSize << std::endl;
@@ -253,7 +265,10 @@ namespace ed {
 		ini << "fpslimit=" << Preview.FPSLimit << std::endl;
 		ini << "fpslimitwholeapp=" << Preview.ApplyFPSLimitToApp << std::endl;
 		ini << "fpslimitlostfocus=" << Preview.LostFocusLimitFPS << std::endl;
+		ini << "idlewhenstatic=" << Preview.IdleWhenStatic << std::endl;
+		ini << "frustumculling=" << Preview.FrustumCulling << std::endl;
 		ini << "msaa=" << Preview.MSAA << std::endl;
+		ini << "fixedtimestepfps=" << Preview.FixedTimeStepFPS << std::endl;
 
 		ini << "[editor]" << std::endl;
 		ini << "smartpred=" << Editor.SmartPredictions << std::endl;
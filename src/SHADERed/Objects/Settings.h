@@ -21,7 +21,7 @@ namespace ed {
 			bool VSync;
 			bool AutoOpenErrorWindow;
 			bool Toolbar;
-			bool Recovery; // [TODO] Not implemented
+			bool Recovery; // autosave <project>.recovery in the background
 			bool CheckUpdates;
 			bool RecompileOnFileChange;
 			bool AutoRecompile;
@@ -29,6 +29,8 @@ namespace ed {
 			bool AutoUniformsPin;
 			bool AutoUniformsFunction;
 			bool AutoUniformsDelete;
+			bool DirectSPIRV; // load HLSL & Vulkan GLSL through ARB_gl_spirv
+			bool LazyLoading; // decode textures, audio & models once something uses them
 			bool ReopenShaders;
 			bool UseExternalEditor;
 			bool OpenShadersOnDblClk;
@@ -89,7 +91,10 @@ namespace ed {
 			int FPSLimit;
 			bool ApplyFPSLimitToApp; // apply FPSLimit to whole app, not only preview
 			bool LostFocusLimitFPS;	 // limit to 30FPS when app loses focus
+			bool IdleWhenStatic;	 // don't redraw when nothing is animated and there is no input
+			bool FrustumCulling;	 // skip items outside of the camera in passes that use the built-in camera & GeometryTransform
 			int MSAA;				 // 1 (off), 2, 4, 8
+			int FixedTimeStepFPS;	 // > 0 -> advance time by 1/FixedTimeStepFPS each frame instead of using the wall clock
 		} Preview;
 
 		struct strProject {
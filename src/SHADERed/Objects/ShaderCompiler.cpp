@@ -2,6 +2,8 @@
 #include <fstream>
 #include <iostream>
 #include <sstream>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include <SHADERed/Engine/GLUtils.h>
@@ -9,11 +11,13 @@
 #include <SHADERed/Objects/Logger.h>
 #include <SHADERed/Objects/Settings.h>
 #include <SHADERed/Objects/ShaderCompiler.h>
+#include <SHADERed/Objects/Tracer.h>
 #include <glslang/SPIRV/GlslangToSpv.h>
 #include <glslang/StandAlone/DirStackFileIncluder.h>
 #include <glslang/glslang/Public/ShaderLang.h>
 #include <SPIRVCross/spirv_cross_util.hpp>
 #include <SPIRVCross/spirv_glsl.hpp>
+#include <spirv-tools/optimizer.hpp>
 
 const TBuiltInResource DefaultTBuiltInResource = {
 	/* .MaxLights = */ 32,
@@ -125,11 +129,15 @@ const TBuiltInResource DefaultTBuiltInResource = {
 };
 
 namespace ed {
+	static const char* StageNames[] = { "vertex", "pixel", "geometry", "compute", "audio", "plugin" };
+
 	std::string ShaderCompiler::ConvertToGLSL(const std::vector<unsigned int>& spvIn, ShaderLanguage inLang, ShaderStage sType, bool gsUsed, MessageStack* msgs)
 	{
 		if (spvIn.empty())
 			return "";
 
+		TraceScope trace("Shader", std::string("SPIR-V to GLSL (") + StageNames[(int)sType] + ")");
+
 		// Read SPIR-V
 		spirv_cross::CompilerGLSL glsl(std::move(spvIn));
 
@@ -174,7 +182,7 @@ namespace ed {
 			glsl.build_dummy_sampler_for_combined_images();
 			glsl.build_combined_image_samplers();
 		} catch (spirv_cross::CompilerError& e) {
-			ed::Logger::Get().Log("An exception occured: " + std::string(e.what()), true);
+			ed::Logger::Get().Log(Logger::Category::Shader, Logger::Level::Error, "An exception occured: " + std::string(e.what()));
 			if (msgs != nullptr)
 				msgs->Add(MessageStack::Type::Error, msgs->CurrentItem, "Transcompiling failed", -1, sType);
 			return "error";
@@ -185,7 +193,7 @@ namespace ed {
 		try {
 			source = glsl.compile();
 		} catch (spirv_cross::CompilerError& e) {
-			ed::Logger::Get().Log("Transcompiler threw an exception: " + std::string(e.what()), true);
+			ed::Logger::Get().Log(Logger::Category::Shader, Logger::Level::Error, "Transcompiler threw an exception: " + std::string(e.what()));
 			if (msgs != nullptr)
 				msgs->Add(MessageStack::Type::Error, msgs->CurrentItem, "Transcompiling failed", -1, sType);
 			return "error";
@@ -307,13 +315,13 @@ namespace ed {
 			}
 		}
 
-		ed::Logger::Get().Log("Finished transcompiling the shader");
+		ed::Logger::Get().Log(Logger::Category::Shader, Logger::Level::Info, "Finished transcompiling the shader");
 
 		return source;
 	}
 	bool ShaderCompiler::CompileToSPIRV(std::vector<unsigned int>& spvOut, ShaderLanguage inLang, const std::string& filename, ShaderStage sType, const std::string& entry, std::vector<ShaderMacro>& macros, MessageStack* msgs, ProjectParser* project)
 	{
-		ed::Logger::Get().Log("Starting to transcompile a HLSL shader " + filename);
+		ed::Logger::Get().Log(Logger::Category::Shader, Logger::Level::Info, "Starting to transcompile a HLSL shader " + filename);
 
 		std::string source;
 
@@ -339,6 +347,8 @@ namespace ed {
 	}
 	bool ShaderCompiler::CompileSourceToSPIRV(std::vector<unsigned int>& spvOut, ShaderLanguage inLang, const std::string& filename, const std::string& source, ShaderStage sType, const std::string& entry, std::vector<ShaderMacro>& macros, MessageStack* msgs, ProjectParser* project)
 	{
+		TraceScope trace("Shader", std::string("Compile to SPIR-V (") + StageNames[(int)sType] + ")", filename);
+
 		spvOut.clear();
 
 		const char* inputStr = source.c_str();
@@ -399,25 +409,11 @@ namespace ed {
 			for (auto& str : Settings::Instance().Project.IncludePaths)
 				includer.pushExternalLocalDirectory(project->GetProjectPath(str));
 
-		std::string processedShader;
-
-		if (!shader.preprocess(&res, defVersion, ENoProfile, false, false, messages, &processedShader, includer)) {
-			if (msgs != nullptr) {
-				msgs->Add(gl::ParseGlslangMessages(msgs->CurrentItem, sType, shader.getInfoLog()));
-				msgs->Add(MessageStack::Type::Error, msgs->CurrentItem, "Shader preprocessing failed", -1, sType);
-			}
-			return false;
-		}
-
-		// update strings
-		const char* processedStr = processedShader.c_str();
-		shader.setStrings(&processedStr, 1);
-
 		// shader.setAutoMapBindings(true);
 		shader.setAutoMapLocations(true);
 
-		// parse
-		if (!shader.parse(&res, 100, false, messages)) {
+		// preprocess & parse in one go - includes are read through the shared IncludeCache
+		if (!shader.parse(&res, defVersion, ENoProfile, false, false, messages, includer)) {
 			if (msgs != nullptr)
 				msgs->Add(gl::ParseGlslangMessages(msgs->CurrentItem, sType, shader.getInfoLog()));
 			return false;
@@ -470,6 +466,320 @@ namespace ed {
 		*lang = -1;
 		return nullptr;
 	}
+	std::vector<unsigned int> ShaderCompiler::OptimizeSPIRV(const std::vector<unsigned int>& spvIn)
+	{
+		if (spvIn.empty())
+			return spvIn;
+
+		spvtools::Optimizer opt(SPV_ENV_UNIVERSAL_1_5);
+		opt.SetMessageConsumer([](spv_message_level_t level, const char* source, const spv_position_t& position, const char* message) {
+			if (level <= SPV_MSG_ERROR)
+				ed::Logger::Get().Log(Logger::Category::Shader, Logger::Level::Error, "spirv-opt: " + std::string(message));
+		});
+
+		// inlining, constant folding, dead branch elimination, scalar replacement, ...
+		opt.RegisterPerformancePasses();
+		opt.RegisterPass(spvtools::CreateLoopUnrollPass(true));
+		opt.RegisterPass(spvtools::CreateSimplificationPass());
+		opt.RegisterPass(spvtools::CreateDeadBranchElimPass());
+		opt.RegisterPass(spvtools::CreateAggressiveDCEPass());
+
+		std::vector<unsigned int> spvOut;
+		if (!opt.Run(spvIn.data(), spvIn.size(), &spvOut))
+			return spvIn;
+
+		return spvOut;
+	}
+	static void appendSPIRVString(std::vector<unsigned int>& out, const std::string& str)
+	{
+		size_t start = out.size();
+		out.resize(start + str.size() / 4 + 1, 0);
+		memcpy(&out[start], str.c_str(), str.size());
+	}
+	// HLSL cbuffers (including the implicit $Global) are turned into plain uniforms on the GLSL path - do the same
+	// here: every block variable is replaced with one UniformConstant variable per used member. SSBOs are left alone.
+	static bool flattenUniformBlocks(std::vector<unsigned int>& spv)
+	{
+		bool isHLSL = false;
+		std::unordered_set<unsigned int> blockTypes, bufferBlockTypes;
+		std::unordered_map<unsigned int, std::vector<unsigned int>> structMembers;
+		std::map<std::pair<unsigned int, unsigned int>, std::string> memberNames;
+		std::unordered_map<unsigned int, std::pair<unsigned int, unsigned int>> pointers; // id -> storage class, pointee
+		std::unordered_map<unsigned int, unsigned int> constants;
+		std::unordered_map<unsigned int, unsigned int> blockVars; // variable id -> struct id
+		std::unordered_map<unsigned int, std::map<unsigned int, unsigned int>> usedMembers; // variable id -> member index -> new variable id
+		std::map<unsigned int, unsigned int> chainPointers; // Uniform pointer type -> new UniformConstant pointer type
+		size_t namesEnd = 0, typesStart = 0, lastBlock = 0;
+		unsigned int bound = spv[3];
+
+		for (size_t i = 5; i < spv.size();) {
+			spv::Op opcode = (spv::Op)(spv[i] & spv::OpCodeMask);
+			unsigned int wordCount = spv[i] >> spv::WordCountShift;
+			if (wordCount == 0 || i + wordCount > spv.size())
+				return false;
+
+			if (typesStart == 0 && ((opcode >= spv::OpTypeVoid && opcode <= spv::OpTypeForwardPointer) || (opcode >= spv::OpConstantTrue && opcode <= spv::OpSpecConstantOp) || opcode == spv::OpVariable))
+				typesStart = i;
+
+			switch (opcode) {
+			case spv::OpSource:
+				isHLSL = wordCount > 1 && spv[i + 1] == spv::SourceLanguageHLSL;
+				break;
+			case spv::OpName:
+			case spv::OpMemberName:
+				namesEnd = i + wordCount;
+				if (opcode == spv::OpMemberName && wordCount > 3)
+					memberNames[std::make_pair(spv[i + 1], spv[i + 2])] = std::string((const char*)&spv[i + 3], (wordCount - 3) * sizeof(unsigned int)).c_str();
+				break;
+			case spv::OpDecorate:
+				if (wordCount > 2 && spv[i + 2] == spv::DecorationBlock)
+					blockTypes.insert(spv[i + 1]);
+				else if (wordCount > 2 && spv[i + 2] == spv::DecorationBufferBlock)
+					bufferBlockTypes.insert(spv[i + 1]);
+				break;
+			case spv::OpTypeStruct:
+				structMembers[spv[i + 1]] = std::vector<unsigned int>(spv.begin() + i + 2, spv.begin() + i + wordCount);
+				break;
+			case spv::OpTypePointer:
+				pointers[spv[i + 1]] = std::make_pair(spv[i + 2], spv[i + 3]);
+				break;
+			case spv::OpConstant:
+				if (wordCount > 3)
+					constants[spv[i + 2]] = spv[i + 3];
+				break;
+			case spv::OpVariable:
+				if (spv[i + 3] == spv::StorageClassUniform) {
+					unsigned int pointee = pointers[spv[i + 1]].second;
+					if (bufferBlockTypes.count(pointee))
+						break;
+					if (!isHLSL || blockTypes.count(pointee) == 0)
+						return false; // Vulkan GLSL blocks become uniform structs, arrays of blocks need a buffer per element
+					blockVars[spv[i + 2]] = pointee;
+					lastBlock = i;
+				}
+				break;
+			case spv::OpAccessChain:
+			case spv::OpInBoundsAccessChain:
+				if (blockVars.count(spv[i + 3])) {
+					if (wordCount < 5 || constants.count(spv[i + 4]) == 0)
+						return false;
+
+					unsigned int member = constants[spv[i + 4]];
+					if (member >= structMembers[blockVars[spv[i + 3]]].size())
+						return false;
+
+					std::map<unsigned int, unsigned int>& used = usedMembers[spv[i + 3]];
+					if (used.count(member) == 0)
+						used[member] = bound++;
+					if (wordCount > 5 && chainPointers.count(spv[i + 1]) == 0)
+						chainPointers[spv[i + 1]] = bound++;
+				}
+				break;
+			default: break;
+			}
+
+			i += wordCount;
+		}
+
+		if (blockVars.empty())
+			return true;
+		if (namesEnd == 0 || typesStart == 0)
+			return false;
+
+		std::vector<unsigned int> out(spv.begin(), spv.begin() + 5);
+		std::unordered_map<unsigned int, unsigned int> replaced; // dropped access chain -> new variable
+		bool inFunctions = false;
+
+		for (size_t i = 5; i < spv.size();) {
+			spv::Op opcode = (spv::Op)(spv[i] & spv::OpCodeMask);
+			unsigned int wordCount = spv[i] >> spv::WordCountShift;
+
+			if (i == namesEnd) {
+				for (const auto& var : usedMembers)
+					for (const auto& member : var.second) {
+						const std::string& name = memberNames[std::make_pair(blockVars[var.first], member.first)];
+						if (name.empty())
+							return false;
+
+						size_t start = out.size();
+						out.push_back(spv::OpName);
+						out.push_back(member.second);
+						appendSPIRVString(out, name);
+						out[start] |= (unsigned int)(out.size() - start) << spv::WordCountShift;
+					}
+			}
+			if (i == typesStart) {
+				for (const auto& var : usedMembers)
+					for (const auto& member : var.second) {
+						out.push_back((4 << spv::WordCountShift) | spv::OpDecorate);
+						out.push_back(member.second);
+						out.push_back(spv::DecorationLocation);
+						out.push_back(0); // assigned by PrepareSPIRVForGL
+					}
+			}
+			if (opcode == spv::OpFunction)
+				inFunctions = true;
+
+			bool skip = false;
+			switch (opcode) {
+			case spv::OpEntryPoint: {
+				// SPIR-V 1.4+ lists every global variable in the interface
+				size_t nameEnd = i + 3;
+				while (nameEnd < i + wordCount && (spv[nameEnd] & 0xFF) && (spv[nameEnd] & 0xFF00) && (spv[nameEnd] & 0xFF0000) && (spv[nameEnd] & 0xFF000000))
+					nameEnd++;
+				nameEnd++;
+
+				size_t start = out.size();
+				out.insert(out.end(), spv.begin() + i, spv.begin() + std::min<size_t>(nameEnd, i + wordCount));
+				bool listsBlocks = false;
+				for (size_t w = nameEnd; w < i + wordCount; w++) {
+					if (blockVars.count(spv[w]))
+						listsBlocks = true;
+					else
+						out.push_back(spv[w]);
+				}
+				if (listsBlocks)
+					for (const auto& var : usedMembers)
+						for (const auto& member : var.second)
+							out.push_back(member.second);
+				out[start] = ((unsigned int)(out.size() - start) << spv::WordCountShift) | spv::OpEntryPoint;
+				skip = true;
+			} break;
+			case spv::OpName:
+			case spv::OpDecorate:
+				skip = blockVars.count(spv[i + 1]) > 0;
+				break;
+			case spv::OpVariable:
+				if (blockVars.count(spv[i + 2])) {
+					// every member type is declared by now
+					if (i == lastBlock) {
+						for (const auto& var : usedMembers) {
+							std::vector<unsigned int>& members = structMembers[blockVars[var.first]];
+							for (const auto& member : var.second) {
+								unsigned int pointerType = bound++;
+								out.insert(out.end(), { (4 << spv::WordCountShift) | spv::OpTypePointer, pointerType, spv::StorageClassUniformConstant, members[member.first] });
+								out.insert(out.end(), { (4 << spv::WordCountShift) | spv::OpVariable, pointerType, member.second, spv::StorageClassUniformConstant });
+							}
+						}
+						for (const auto& chain : chainPointers)
+							out.insert(out.end(), { (4 << spv::WordCountShift) | spv::OpTypePointer, chain.second, spv::StorageClassUniformConstant, pointers[chain.first].second });
+					}
+					skip = true;
+				}
+				break;
+			case spv::OpAccessChain:
+			case spv::OpInBoundsAccessChain:
+				if (blockVars.count(spv[i + 3])) {
+					unsigned int variable = usedMembers[spv[i + 3]][constants[spv[i + 4]]];
+					if (wordCount == 5)
+						replaced[spv[i + 2]] = variable;
+					else {
+						out.insert(out.end(), { ((wordCount - 1) << spv::WordCountShift) | opcode, chainPointers.count(spv[i + 1]) ? chainPointers[spv[i + 1]] : 0, spv[i + 2], variable });
+						out.insert(out.end(), spv.begin() + i + 5, spv.begin() + i + wordCount);
+					}
+					skip = true;
+				}
+				break;
+			default: break;
+			}
+
+			if (!skip) {
+				size_t start = out.size();
+				out.insert(out.end(), spv.begin() + i, spv.begin() + i + wordCount);
+
+				if (inFunctions && opcode != spv::OpLine) {
+					if ((opcode == spv::OpLoad || opcode == spv::OpAccessChain || opcode == spv::OpInBoundsAccessChain) && replaced.count(out[start + 3]))
+						out[start + 3] = replaced[out[start + 3]];
+
+					// anything else (whole block loads, pointers passed to functions...) needs the GLSL path
+					for (size_t w = start + 1; w < out.size(); w++)
+						if (blockVars.count(out[w]) || replaced.count(out[w]))
+							return false;
+				}
+			}
+
+			i += wordCount;
+		}
+
+		out[3] = bound;
+		spv = std::move(out);
+		return true;
+	}
+	bool ShaderCompiler::PrepareSPIRVForGL(std::vector<unsigned int>& spv, std::map<std::string, int>& locations, std::vector<std::string>& samplers)
+	{
+		if (spv.size() < 5 || spv[0] != spv::MagicNumber)
+			return false;
+		if (!flattenUniformBlocks(spv))
+			return false;
+
+		std::unordered_map<unsigned int, std::string> names;
+		std::unordered_map<unsigned int, size_t> locationWords; // id -> index of the Location literal
+		std::unordered_map<unsigned int, unsigned int> uniformPointers; // UniformConstant pointer type -> pointee
+		std::unordered_map<unsigned int, spv::Op> types;
+		std::vector<std::pair<unsigned int, unsigned int>> uniforms; // variable id, pointer type (in declaration order)
+
+		for (size_t i = 5; i < spv.size();) {
+			spv::Op opcode = (spv::Op)(spv[i] & spv::OpCodeMask);
+			unsigned int wordCount = spv[i] >> spv::WordCountShift;
+			if (wordCount == 0 || i + wordCount > spv.size())
+				return false;
+
+			switch (opcode) {
+			case spv::OpName:
+				if (wordCount > 2)
+					names[spv[i + 1]] = std::string((const char*)&spv[i + 2], (wordCount - 2) * sizeof(unsigned int)).c_str();
+				break;
+			case spv::OpDecorate:
+				if (wordCount > 3 && spv[i + 2] == spv::DecorationLocation)
+					locationWords[spv[i + 1]] = i + 3;
+				break;
+			case spv::OpTypeSampler: // HLSL textures & samplers are combined by SPIRV-Cross
+				return false;
+			case spv::OpTypeSampledImage:
+			case spv::OpTypeImage:
+			case spv::OpTypeArray:
+			case spv::OpTypeRuntimeArray:
+			case spv::OpTypeStruct:
+				types[spv[i + 1]] = opcode;
+				break;
+			case spv::OpTypePointer:
+				if (spv[i + 2] == spv::StorageClassUniformConstant)
+					uniformPointers[spv[i + 1]] = spv[i + 3];
+				break;
+			case spv::OpVariable:
+				if (spv[i + 3] == spv::StorageClassPushConstant)
+					return false;
+				if (spv[i + 3] == spv::StorageClassUniformConstant)
+					uniforms.push_back(std::make_pair(spv[i + 2], spv[i + 1]));
+				break;
+			default: break;
+			}
+
+			i += wordCount;
+		}
+
+		for (const auto& uniform : uniforms) {
+			const std::string& name = names[uniform.first];
+			spv::Op type = types.count(uniformPointers[uniform.second]) ? types[uniformPointers[uniform.second]] : spv::OpNop;
+
+			// images are bound through their binding
+			if (type == spv::OpTypeImage)
+				continue;
+
+			// every location would have to be set separately
+			if (name.empty() || locationWords.count(uniform.first) == 0 || type == spv::OpTypeArray || type == spv::OpTypeRuntimeArray || type == spv::OpTypeStruct)
+				return false;
+
+			if (locations.count(name) == 0)
+				locations[name] = (int)locations.size();
+			spv[locationWords[uniform.first]] = locations[name];
+
+			if (type == spv::OpTypeSampledImage && std::count(samplers.begin(), samplers.end(), name) == 0)
+				samplers.push_back(name);
+		}
+
+		return true;
+	}
 	ShaderLanguage ShaderCompiler::GetShaderLanguageFromExtension(const std::string& file)
 	{
 		std::vector<std::string>& hlslExts = Settings::Instance().General.HLSLExtensions;
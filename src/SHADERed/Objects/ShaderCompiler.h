@@ -4,6 +4,7 @@
 #include <SHADERed/Objects/ShaderLanguage.h>
 #include <SHADERed/Objects/ShaderStage.h>
 #include <SHADERed/Objects/ShaderMacro.h>
+#include <map>
 #include <string>
 
 namespace ed {
@@ -12,6 +13,15 @@ namespace ed {
 		static bool CompileToSPIRV(std::vector<unsigned int>& spvOut, ShaderLanguage inLang, const std::string& filename, ShaderStage shaderType, const std::string& entry, std::vector<ShaderMacro>& macros, MessageStack* msgs, ProjectParser* project);
 		static bool CompileSourceToSPIRV(std::vector<unsigned int>& spvOut, ShaderLanguage inLang, const std::string& filename, const std::string& source, ShaderStage shaderType, const std::string& entry, std::vector<ShaderMacro>& macros, MessageStack* msgs, ProjectParser* project);
 		static std::string ConvertToGLSL(const std::vector<unsigned int>& spvIn, ShaderLanguage inLang, ShaderStage sType, bool gsUsed, MessageStack* msgs);
+
+		// spirv-tools performance passes + loop unrolling, returns the input if the optimizer fails
+		static std::vector<unsigned int> OptimizeSPIRV(const std::vector<unsigned int>& spvIn);
+
+		// Prepares a module for ARB_gl_spirv: uniforms with the same name get the same location in every stage
+		// (locations & samplers are shared between the calls for one program). HLSL cbuffers are split into plain uniforms.
+		// Returns false if the module relies on something that only the SPIRV-Cross path handles (Vulkan GLSL uniform
+		// blocks, push constants, separate samplers, arrays...)
+		static bool PrepareSPIRVForGL(std::vector<unsigned int>& spv, std::map<std::string, int>& locations, std::vector<std::string>& samplers);
 		static IPlugin1* GetPluginLanguageFromExtension(int* lang, const std::string& filename, const std::vector<IPlugin1*>& pls);
 		static ShaderLanguage GetShaderLanguageFromExtension(const std::string& file);
 	};
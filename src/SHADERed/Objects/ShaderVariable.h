@@ -37,6 +37,8 @@ namespace ed {
 		KeysWASD,		   // vec4 - are W, A, S or D keys pressed
 		Mouse,			   // vec4 - (x,y,left,right) updated every frame
 		MouseButton,	   // vec4 - (x,y,left,right) updated only when mouse button pressed
+		ViewportOffset,	   // vec2 - position of the rendered tile in the whole image (always (0,0) when not rendering in tiles)
+		IterationIndex,	   // uint - index of the current compute pass iteration (always 0 in other passes)
 		PluginVariable,	   // a value that is updated by some plugin
 		Count
 	};
@@ -1,11 +1,15 @@
 #include <SHADERed/Objects/FunctionVariableManager.h>
 #include <SHADERed/Objects/ShaderVariableContainer.h>
 #include <SHADERed/Objects/SystemVariableManager.h>
+#include <algorithm>
 #include <iostream>
 #include <regex>
 
 namespace ed {
-	ShaderVariableContainer::ShaderVariableContainer() { }
+	ShaderVariableContainer::ShaderVariableContainer()
+	{
+		m_spvPass = 0;
+	}
 	ShaderVariableContainer::~ShaderVariableContainer()
 	{
 		for (int i = 0; i < m_vars.size(); i++) {
@@ -49,6 +53,15 @@ namespace ed {
 
 		m_uLocs.clear();
 
+		if (pass == m_spvPass) {
+			for (const auto& loc : m_spvLocs)
+				if (std::count(m_samplers.begin(), m_samplers.end(), loc.first) == 0)
+					m_uLocs[loc.first] = loc.second;
+			for (const auto& sampler : m_samplers)
+				glProgramUniform1i(pass, m_spvLocs[sampler], samplerLoc++);
+			return;
+		}
+
 		glGetProgramiv(pass, GL_ACTIVE_UNIFORMS, &count);
 		for (GLuint i = 0; i < count; i++) {
 			GLint size;
@@ -87,8 +100,19 @@ namespace ed {
 		if (unit >= m_samplers.size())
 			return;
 
+		if (pass != 0 && pass == m_spvPass) {
+			glUniform1i(m_spvLocs[m_samplers[unit]], unit);
+			return;
+		}
+
 		glUniform1i(glGetUniformLocation(pass, m_samplers[unit].c_str()), unit);
 	}
+	void ShaderVariableContainer::SetSPIRVReflection(GLuint pass, const std::map<std::string, int>& locations, const std::vector<std::string>& samplers)
+	{
+		m_spvPass = pass;
+		m_spvLocs = locations;
+		m_samplers = samplers;
+	}
 	void ShaderVariableContainer::Bind(void* item)
 	{
 		for (int i = 0; i < m_vars.size(); i++) {
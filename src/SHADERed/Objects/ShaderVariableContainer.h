@@ -31,9 +31,16 @@ namespace ed {
 		inline std::vector<ShaderVariable*>& GetVariables() { return m_vars; }
 		inline const std::vector<std::string>& GetSamplerList() { return m_samplers; }
 
+		// names can't be queried from programs loaded from SPIR-V (see ShaderCompiler::PrepareSPIRVForGL)
+		void SetSPIRVReflection(GLuint pass, const std::map<std::string, int>& locations, const std::vector<std::string>& samplers);
+		inline void ClearSPIRVReflection() { m_spvPass = 0; }
+
 	private:
 		std::vector<ShaderVariable*> m_vars;
 		std::map<std::string, GLint> m_uLocs;
 		std::vector<std::string> m_samplers;
+
+		GLuint m_spvPass;
+		std::map<std::string, int> m_spvLocs;
 	};
 }
\ No newline at end of file
@@ -9,12 +9,46 @@ namespace ed {
 		m_curGeoTransform.clear();
 		m_prevGeoTransform.clear();
 		m_advTimer = 0;
+		m_fixedBase = 0.0;
+		m_fixedTicks = 0;
 	}
 	void SystemVariableManager::CopyState()
 	{
 		memcpy(&m_prevState, &m_curState, sizeof(m_curState));
 		m_prevGeoTransform = m_curGeoTransform;
 	}
+	void SystemVariableManager::Tick()
+	{
+		CopyState();
+
+		if (IsFixedTimeStep()) {
+			m_fixedTicks++;
+			m_curState.DeltaTime = (float)m_fixedStep;
+		}
+
+		m_curState.FrameIndex++;
+	}
+	void SystemVariableManager::SetFixedTimeStep(double step)
+	{
+		step = std::max(step, 0.0);
+		if (step == m_fixedStep)
+			return;
+
+		// continue from the current time when switching between the clocks
+		if (step > 0.0) {
+			if (!IsFixedTimeStep())
+				m_fixedBase = m_timer.GetElapsedTime();
+			else
+				m_fixedBase += m_fixedTicks * m_fixedStep;
+			m_fixedTicks = 0;
+			m_curState.DeltaTime = (float)step;
+		} else {
+			m_advTimer += (float)(m_fixedBase + m_fixedTicks * m_fixedStep);
+			m_timer.Restart();
+		}
+
+		m_fixedStep = step;
+	}
 	void SystemVariableManager::Update(ed::ShaderVariable* var, void* item)
 	{
 		// update variable's Data pointer if it's using a system value
@@ -52,6 +86,10 @@ namespace ed {
 					glm::vec2 raw = this->GetViewportSize();
 					memcpy(var->Data, glm::value_ptr(raw), sizeof(glm::vec2));
 				} break;
+				case ed::SystemShaderVariable::ViewportOffset: {
+					glm::vec2 raw = this->GetViewportOffset();
+					memcpy(var->Data, glm::value_ptr(raw), sizeof(glm::vec2));
+				} break;
 				case ed::SystemShaderVariable::MousePosition: {
 					glm::vec2 raw = this->GetMousePosition();
 					memcpy(var->Data, glm::value_ptr(raw), sizeof(glm::vec2));
@@ -76,6 +114,10 @@ namespace ed {
 					unsigned int frame = this->GetFrameIndex();
 					memcpy(var->Data, &frame, sizeof(unsigned int));
 				} break;
+				case ed::SystemShaderVariable::IterationIndex: {
+					unsigned int iteration = this->GetIterationIndex();
+					memcpy(var->Data, &iteration, sizeof(unsigned int));
+				} break;
 				case ed::SystemShaderVariable::IsPicked: {
 					bool raw = this->IsPicked();
 					memcpy(var->Data, &raw, sizeof(bool));
@@ -113,23 +155,23 @@ namespace ed {
 					memcpy(var->Data, glm::value_ptr(rawMatrix), sizeof(glm::mat4));
 					break;
 				case ed::SystemShaderVariable::Projection:
-					rawMatrix = glm::perspective(glm::radians(45.0f), m_prevState.Viewport.x / m_prevState.Viewport.y, 0.1f, 1000.0f);
+					rawMatrix = m_getProjectionMatrix(m_prevState);
 					memcpy(var->Data, glm::value_ptr(rawMatrix), sizeof(glm::mat4));
 					break;
 				case ed::SystemShaderVariable::ViewProjection: {
 					glm::mat4 view = Settings::Instance().Project.FPCamera ? m_prevState.FPCam.GetMatrix() : m_prevState.ArcCam.GetMatrix();
-					glm::mat4 persp = glm::perspective(glm::radians(45.0f), m_prevState.Viewport.x / m_prevState.Viewport.y, 0.1f, 1000.0f);
+					glm::mat4 persp = m_getProjectionMatrix(m_prevState);
 
 					rawMatrix = persp * view;
 					memcpy(var->Data, glm::value_ptr(rawMatrix), sizeof(glm::mat4));
 				} break;
 				case ed::SystemShaderVariable::Orthographic:
-					rawMatrix = glm::ortho(0.0f, m_prevState.Viewport.x, m_prevState.Viewport.y, 0.0f, 0.1f, 1000.0f);
+					rawMatrix = m_getOrthographicMatrix(m_prevState);
 					memcpy(var->Data, glm::value_ptr(rawMatrix), sizeof(glm::mat4));
 					break;
 				case ed::SystemShaderVariable::ViewOrthographic: {
 					glm::mat4 view = Settings::Instance().Project.FPCamera ? m_prevState.FPCam.GetMatrix() : m_prevState.ArcCam.GetMatrix();
-					glm::mat4 ortho = glm::ortho(0.0f, m_prevState.Viewport.x, m_prevState.Viewport.y, 0.0f, 0.1f, 1000.0f);
+					glm::mat4 ortho = m_getOrthographicMatrix(m_prevState);
 					rawMatrix = ortho * view;
 					memcpy(var->Data, glm::value_ptr(rawMatrix), sizeof(glm::mat4));
 				} break;
@@ -138,7 +180,11 @@ namespace ed {
 					memcpy(var->Data, glm::value_ptr(rawMatrix), sizeof(glm::mat4));
 					break;
 				case ed::SystemShaderVariable::ViewportSize: {
-					glm::vec2 raw = m_prevState.Viewport;
+					glm::vec2 raw = m_getViewportSize(m_prevState);
+					memcpy(var->Data, glm::value_ptr(raw), sizeof(glm::vec2));
+				} break;
+				case ed::SystemShaderVariable::ViewportOffset: {
+					glm::vec2 raw = m_getViewportOffset(m_prevState);
 					memcpy(var->Data, glm::value_ptr(raw), sizeof(glm::vec2));
 				} break;
 				case ed::SystemShaderVariable::MousePosition: {
@@ -165,6 +211,10 @@ namespace ed {
 					unsigned int frame = m_prevState.FrameIndex;
 					memcpy(var->Data, &frame, sizeof(unsigned int));
 				} break;
+				case ed::SystemShaderVariable::IterationIndex: {
+					unsigned int iteration = m_prevState.IterationIndex;
+					memcpy(var->Data, &iteration, sizeof(unsigned int));
+				} break;
 				case ed::SystemShaderVariable::IsPicked: {
 					bool raw = m_prevState.IsPicked;
 					memcpy(var->Data, &raw, sizeof(bool));
@@ -197,6 +247,19 @@ namespace ed {
 			}
 		}
 	}
+	glm::mat4 SystemVariableManager::m_getTileMatrix(const ValueGroup& state)
+	{
+		// maps the tile's part of the clip space to the whole [-1, 1] range
+		glm::vec2 scale(1.0f / state.Tile.z, 1.0f / state.Tile.w);
+		glm::vec2 center(-1.0f + 2.0f * state.Tile.x + state.Tile.z, -1.0f + 2.0f * state.Tile.y + state.Tile.w);
+
+		glm::mat4 ret(1.0f);
+		ret[0][0] = scale.x;
+		ret[1][1] = scale.y;
+		ret[3][0] = -center.x * scale.x;
+		ret[3][1] = -center.y * scale.y;
+		return ret;
+	}
 	ed::SystemShaderVariable SystemVariableManager::GetTypeFromName(const std::string& name)
 	{
 		std::string vname = name;
@@ -207,8 +270,12 @@ namespace ed {
 			return SystemShaderVariable::Time;
 		else if (vname.find("time") != std::string::npos && (vname.find("d") != std::string::npos || vname.find("del") != std::string::npos || vname.find("delta") != std::string::npos))
 			return SystemShaderVariable::TimeDelta;
+		else if (vname == "iterationindex" || vname == "substepindex")
+			return SystemShaderVariable::IterationIndex;
 		else if (vname.find("frame") != std::string::npos || vname.find("index") != std::string::npos)
 			return SystemShaderVariable::FrameIndex;
+		else if (vname == "viewportoffset" || vname == "tileoffset")
+			return SystemShaderVariable::ViewportOffset;
 		else if (vname.find("size") != std::string::npos || vname.find("window") != std::string::npos || vname.find("viewport") != std::string::npos || vname.find("resolution") != std::string::npos || vname.find("res") != std::string::npos)
 			return SystemShaderVariable::ViewportSize;
 		else if (vname.find("mouse") != std::string::npos || vname == "mpos")
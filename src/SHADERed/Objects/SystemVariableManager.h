@@ -24,12 +24,17 @@ namespace ed {
 		SystemVariableManager()
 		{
 			m_curState.FrameIndex = 0;
+			m_curState.IterationIndex = 0;
 			m_curState.IsPicked = false;
 			m_curState.WASD = glm::vec4(0, 0, 0, 0);
 			m_curState.Viewport = glm::vec2(0, 1);
+			m_curState.Tile = glm::vec4(0, 0, 1, 1);
 			m_curState.MousePosition = glm::vec2(0, 0);
 			m_curState.DeltaTime = 0.0f;
 			m_curState.IsSavingToFile = false;
+			m_fixedStep = 0.0;
+			m_fixedBase = 0.0;
+			m_fixedTicks = 0;
 			m_curGeoTransform.clear();
 			m_prevGeoTransform.clear();
 		}
@@ -44,8 +49,10 @@ namespace ed {
 			case ed::SystemShaderVariable::Time: return ed::ShaderVariable::ValueType::Float1;
 			case ed::SystemShaderVariable::TimeDelta: return ed::ShaderVariable::ValueType::Float1;
 			case ed::SystemShaderVariable::FrameIndex: return ed::ShaderVariable::ValueType::Integer1;
+			case ed::SystemShaderVariable::IterationIndex: return ed::ShaderVariable::ValueType::Integer1;
 			case ed::SystemShaderVariable::View: return ed::ShaderVariable::ValueType::Float4x4;
 			case ed::SystemShaderVariable::ViewportSize: return ed::ShaderVariable::ValueType::Float2;
+			case ed::SystemShaderVariable::ViewportOffset: return ed::ShaderVariable::ValueType::Float2;
 			case ed::SystemShaderVariable::ViewProjection: return ed::ShaderVariable::ValueType::Float4x4;
 			case ed::SystemShaderVariable::Orthographic: return ed::ShaderVariable::ValueType::Float4x4;
 			case ed::SystemShaderVariable::ViewOrthographic: return ed::ShaderVariable::ValueType::Float4x4;
@@ -61,6 +68,24 @@ namespace ed {
 			return ed::ShaderVariable::ValueType::Float1;
 		}
 
+		// values that change from frame to frame (or with input) - passes that use them have to be rendered every frame
+		static inline bool IsTimeDependent(ed::SystemShaderVariable sysVar)
+		{
+			switch (sysVar) {
+			case ed::SystemShaderVariable::Time:
+			case ed::SystemShaderVariable::TimeDelta:
+			case ed::SystemShaderVariable::FrameIndex:
+			case ed::SystemShaderVariable::MousePosition:
+			case ed::SystemShaderVariable::Mouse:
+			case ed::SystemShaderVariable::MouseButton:
+			case ed::SystemShaderVariable::KeysWASD:
+			case ed::SystemShaderVariable::PluginVariable:
+				return true;
+			}
+
+			return false;
+		}
+
 		void Update(ed::ShaderVariable* var, void* item = nullptr);
 
 		static ed::SystemShaderVariable GetTypeFromName(const std::string& name);
@@ -68,20 +93,40 @@ namespace ed {
 		void Reset();
 		void CopyState();
 
+		// advance to the next frame - called once after each frame that wasn't paused
+		void Tick();
+
+		// step > 0 -> Time & TimeDelta are calculated from the number of ticks instead of the wall clock
+		void SetFixedTimeStep(double step);
+		inline bool IsFixedTimeStep() { return m_fixedStep > 0.0; }
+		inline double GetFixedTimeStep() { return m_fixedStep; }
+
+		// set FrameIndex and (with fixed time step) Time to the values they have on the given frame
+		inline void JumpToFrame(unsigned int frame)
+		{
+			m_curState.FrameIndex = frame;
+			m_fixedBase = 0.0;
+			m_fixedTicks = frame;
+			m_advTimer = 0.0f;
+		}
+
 		inline Camera* GetCamera() { return Settings::Instance().Project.FPCamera ? (Camera*)&m_curState.FPCam : (Camera*)&m_curState.ArcCam; }
 		inline glm::mat4 GetViewMatrix() { return Settings::Instance().Project.FPCamera ? m_curState.FPCam.GetMatrix() : m_curState.ArcCam.GetMatrix(); }
-		inline glm::mat4 GetProjectionMatrix() { return glm::perspective(glm::radians(45.0f), m_curState.Viewport.x / m_curState.Viewport.y, 0.1f, 1000.0f); }
-		inline glm::mat4 GetOrthographicMatrix() { return glm::ortho(0.0f, m_curState.Viewport.x, m_curState.Viewport.y, 0.0f, 0.1f, 1000.0f); }
+		inline glm::mat4 GetProjectionMatrix() { return m_getProjectionMatrix(m_curState); }
+		inline glm::mat4 GetOrthographicMatrix() { return m_getOrthographicMatrix(m_curState); }
 		inline glm::mat4 GetViewProjectionMatrix() { return GetProjectionMatrix() * GetViewMatrix(); }
 		inline glm::mat4 GetViewOrthographicMatrix() { return GetOrthographicMatrix() * GetViewMatrix(); }
 		inline glm::mat4 GetGeometryTransform(PipelineItem* item) { return m_curGeoTransform[item]; }
-		inline glm::vec2 GetViewportSize() { return m_curState.Viewport; }
+		inline glm::vec2 GetViewportSize() { return m_getViewportSize(m_curState); }
+		inline glm::vec2 GetViewportOffset() { return m_getViewportOffset(m_curState); }
+		inline glm::vec4 GetTile() { return m_curState.Tile; }
 		inline glm::ivec4 GetKeysWASD() { return m_curState.WASD; }
 		inline glm::vec2 GetMousePosition() { return m_curState.MousePosition; }
 		inline glm::vec4 GetMouse() { return m_curState.Mouse; }
 		inline glm::vec4 GetMouseButton() { return m_curState.MouseButton; }
 		inline unsigned int GetFrameIndex() { return m_curState.FrameIndex; }
-		inline float GetTime() { return m_timer.GetElapsedTime() + m_advTimer; }
+		inline unsigned int GetIterationIndex() { return m_curState.IterationIndex; }
+		inline float GetTime() { return (IsFixedTimeStep() ? (float)(m_fixedBase + m_fixedTicks * m_fixedStep) : m_timer.GetElapsedTime()) + m_advTimer; }
 		inline eng::Timer& GetTimeClock() { return m_timer; }
 		inline float GetTimeDelta() { return m_curState.DeltaTime; }
 		inline bool IsPicked() { return m_curState.IsPicked; }
@@ -91,6 +136,8 @@ namespace ed {
 			m_curGeoTransform[item] = glm::translate(glm::mat4(1), pos) * glm::yawPitchRoll(rota.y, rota.x, rota.z) * glm::scale(glm::mat4(1.0f), scale);
 		}
 		inline void SetViewportSize(float x, float y) { m_curState.Viewport = glm::vec2(x, y); }
+		// tiled rendering: (x, y, width, height) of the rendered tile relative to the whole image, (0,0) = bottom left corner
+		inline void SetTile(const glm::vec4& tile) { m_curState.Tile = tile; }
 		inline void SetMousePosition(float x, float y) { m_curState.MousePosition = glm::vec2(x, y); }
 		inline void SetMouse(float x, float y, float left, float right) { m_curState.Mouse = glm::vec4(x, y, left, right); }
 		inline void SetMouseButton(float x, float y, float left, float right) { m_curState.MouseButton = glm::vec4(x, y, left, right); }
@@ -98,6 +145,7 @@ namespace ed {
 		inline void SetPicked(bool picked) { m_curState.IsPicked = picked; }
 		inline void SetKeysWASD(int w, int a, int s, int d) { m_curState.WASD = glm::ivec4(w, a, s, d); }
 		inline void SetFrameIndex(unsigned int ind) { m_curState.FrameIndex = ind; }
+		inline void SetIterationIndex(unsigned int ind) { m_curState.IterationIndex = ind; }
 		inline void SetSavingToFile(bool isSaving) { m_curState.IsSavingToFile = isSaving; }
 
 		inline void AdvanceTimer(float t) { m_advTimer += t; }
@@ -106,19 +154,40 @@ namespace ed {
 		eng::Timer m_timer;
 		float m_advTimer;
 
+		// fixed time step clock
+		double m_fixedStep, m_fixedBase;
+		unsigned long long m_fixedTicks;
+
 
 		struct ValueGroup {
 			float DeltaTime;
 			ArcBallCamera ArcCam;
 			FirstPersonCamera FPCam;
 			glm::vec2 Viewport, MousePosition;
+			glm::vec4 Tile;
 			bool IsPicked;
 			bool IsSavingToFile;
 			unsigned int FrameIndex;
+			unsigned int IterationIndex;
 			glm::ivec4 WASD;
 			glm::vec4 Mouse, MouseButton;
 		} m_prevState, m_curState;
 
 		std::unordered_map<PipelineItem*, glm::mat4> m_curGeoTransform, m_prevGeoTransform;
+
+		// Viewport holds the size of the tile that's being rendered, these return values for the whole image
+		inline glm::vec2 m_getViewportSize(const ValueGroup& state) { return state.Viewport / glm::vec2(state.Tile.z, state.Tile.w); }
+		inline glm::vec2 m_getViewportOffset(const ValueGroup& state) { return m_getViewportSize(state) * glm::vec2(state.Tile.x, state.Tile.y); }
+		glm::mat4 m_getTileMatrix(const ValueGroup& state);
+		inline glm::mat4 m_getProjectionMatrix(const ValueGroup& state)
+		{
+			glm::vec2 size = m_getViewportSize(state);
+			return m_getTileMatrix(state) * glm::perspective(glm::radians(45.0f), size.x / size.y, 0.1f, 1000.0f);
+		}
+		inline glm::mat4 m_getOrthographicMatrix(const ValueGroup& state)
+		{
+			glm::vec2 size = m_getViewportSize(state);
+			return m_getTileMatrix(state) * glm::ortho(0.0f, size.x, size.y, 0.0f, 0.1f, 1000.0f);
+		}
 	};
 }
\ No newline at end of file
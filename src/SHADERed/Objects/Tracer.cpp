@@ -0,0 +1,128 @@
+#include <SHADERed/Objects/Logger.h>
+#include <SHADERed/Objects/Tracer.h>
+#include <algorithm>
+#include <fstream>
+
+namespace ed {
+	static void writeJSONString(std::ofstream& out, const std::string& str)
+	{
+		out << '"';
+		for (char c : str) {
+			if (c == '"' || c == '\\')
+				out << '\\' << c;
+			else if (c == '\n')
+				out << "\\n";
+			else if (c == '\t')
+				out << "\\t";
+			else if ((unsigned char)c < 0x20)
+				out << ' ';
+			else
+				out << c;
+		}
+		out << '"';
+	}
+
+	Tracer::Tracer()
+	{
+		m_enabled = false;
+		m_output = "";
+		m_dropped = 0;
+		m_start = std::chrono::steady_clock::now();
+	}
+
+	void Tracer::Start(const std::string& outputFile)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		m_output = outputFile;
+		m_start = std::chrono::steady_clock::now();
+		m_events.clear();
+		m_events.reserve(4096);
+		m_threads.clear();
+		m_threads.push_back(std::this_thread::get_id()); // tid 0 = the thread that started the trace
+		m_dropped = 0;
+		m_enabled = true;
+
+		Logger::Get().Log("Recording a trace to " + outputFile);
+	}
+	long long Tracer::Now()
+	{
+		return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_start).count();
+	}
+	void Tracer::Add(const std::string& name, const char* category, const std::string& detail, long long start, long long duration)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		if (m_events.size() >= MaxEvents) {
+			m_dropped++;
+			return;
+		}
+
+		// small sequential thread ids are easier to read in the viewer than hashed std::thread::id
+		std::thread::id threadID = std::this_thread::get_id();
+		unsigned int tid = std::find(m_threads.begin(), m_threads.end(), threadID) - m_threads.begin();
+		if (tid == m_threads.size())
+			m_threads.push_back(threadID);
+
+		Event evt;
+		evt.Name = name;
+		evt.Detail = detail;
+		evt.Category = category;
+		evt.Thread = tid;
+		evt.Start = start;
+		evt.Duration = duration;
+		m_events.push_back(evt);
+	}
+	bool Tracer::Save()
+	{
+		if (!m_enabled)
+			return false;
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		std::ofstream out(m_output);
+		if (!out.is_open()) {
+			Logger::Get().Log("Failed to write the trace to " + m_output, true);
+			return false;
+		}
+
+		out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+		// records are separated, not terminated - a trailing comma isn't valid JSON
+		const char* separator = "\n";
+
+		// thread names
+		for (unsigned int i = 0; i < m_threads.size(); i++) {
+			out << separator << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << i << ",\"args\":{\"name\":\"";
+			out << (i == 0 ? "Main" : "Thread " + std::to_string(i)) << "\"}}";
+			separator = ",\n";
+		}
+
+		for (size_t i = 0; i < m_events.size(); i++) {
+			const Event& evt = m_events[i];
+
+			out << separator << "{\"name\":";
+			writeJSONString(out, evt.Name);
+			out << ",\"cat\":\"" << evt.Category << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << evt.Thread;
+			out << ",\"ts\":" << evt.Start << ",\"dur\":" << evt.Duration;
+
+			if (!evt.Detail.empty()) {
+				out << ",\"args\":{\"detail\":";
+				writeJSONString(out, evt.Detail);
+				out << "}";
+			}
+
+			out << "}";
+			separator = ",\n";
+		}
+
+		out << "\n]}\n";
+		out.close();
+
+		if (m_dropped > 0)
+			Logger::Get().Log("Trace event limit reached - " + std::to_string(m_dropped) + " events were dropped", true);
+		Logger::Get().Log("Saved " + std::to_string(m_events.size()) + " trace events to " + m_output);
+
+		return true;
+	}
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ed {
+	/* Records timed spans (project loading, texture decoding, shader compilation...)
+	   and writes them as Chrome trace event JSON (chrome://tracing, Perfetto).
+	   Disabled unless started with --trace - TraceScope then only checks a bool. */
+	class Tracer {
+	public:
+		Tracer();
+
+		static Tracer& Instance()
+		{
+			static Tracer ret;
+			return ret;
+		}
+
+		void Start(const std::string& outputFile);
+		inline bool IsEnabled() { return m_enabled; }
+
+		void Add(const std::string& name, const char* category, const std::string& detail, long long start, long long duration);
+		long long Now(); // microseconds since Start()
+
+		// writes everything recorded so far to the output file
+		bool Save();
+
+		static const int MaxEvents = 1000000;
+
+	private:
+		struct Event {
+			std::string Name, Detail;
+			const char* Category;
+			unsigned int Thread;
+			long long Start, Duration;
+		};
+
+		std::atomic<bool> m_enabled;
+		std::string m_output;
+		std::chrono::steady_clock::time_point m_start;
+
+		std::mutex m_mutex;
+		std::vector<Event> m_events;
+		std::vector<std::thread::id> m_threads; // index = tid in the trace
+		int m_dropped;
+	};
+
+	class TraceScope {
+	public:
+		TraceScope(const char* category, const std::string& name, const std::string& detail = "")
+		{
+			m_enabled = Tracer::Instance().IsEnabled();
+			if (m_enabled) {
+				m_category = category;
+				m_name = name;
+				m_detail = detail;
+				m_start = Tracer::Instance().Now();
+			}
+		}
+		~TraceScope()
+		{
+			if (m_enabled)
+				Tracer::Instance().Add(m_name, m_category, m_detail, m_start, Tracer::Instance().Now() - m_start);
+		}
+
+	private:
+		bool m_enabled;
+		const char* m_category;
+		std::string m_name, m_detail;
+		long long m_start;
+	};
+}
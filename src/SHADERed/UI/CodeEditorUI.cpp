@@ -1,3 +1,5 @@
+#include <SHADERed/Objects/DependencyGraph.h>
+#include <SHADERed/Objects/IncludeCache.h>
 #include <SHADERed/Objects/KeyboardShortcuts.h>
 #include <SHADERed/Objects/Logger.h>
 #include <SHADERed/Objects/Names.h>
@@ -9,6 +11,7 @@
 
 #include <imgui/imgui.h>
 #include <imgui/imgui_internal.h>
+#include <algorithm>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
@@ -267,19 +270,22 @@ namespace ed {
 					} else {
 						if (m_editor[i]) {
 							// add error markers if needed
-							auto msgs = m_data->Messages.GetMessages();
-							int groupMsg = 0;
-							TextEditor::ErrorMarkers groupErrs;
-							for (int j = 0; j < msgs.size(); j++) {
-								ed::MessageStack::Message* msg = &msgs[j];
-
-								if (groupErrs.count(msg->Line))
-									continue;
-
-								if (msg->Line > 0 && msg->Group == m_items[i]->Name && msg->Shader == m_shaderStage[i])
-									groupErrs[msg->Line] = msg->Text;
+							unsigned int msgGeneration = m_data->Messages.GetGeneration();
+							if (m_markerGeneration[m_editor[i]] != msgGeneration) {
+								const std::vector<MessageStack::Message>& msgs = m_data->Messages.GetGroupMessages(m_items[i]->Name);
+								TextEditor::ErrorMarkers groupErrs;
+								for (int j = 0; j < msgs.size(); j++) {
+									const ed::MessageStack::Message* msg = &msgs[j];
+
+									if (groupErrs.count(msg->Line))
+										continue;
+
+									if (msg->Line > 0 && msg->Shader == m_shaderStage[i])
+										groupErrs[msg->Line] = msg->Text;
+								}
+								m_editor[i]->SetErrorMarkers(groupErrs);
+								m_markerGeneration[m_editor[i]] = msgGeneration;
 							}
-							m_editor[i]->SetErrorMarkers(groupErrs);
 
 							bool statusbar = Settings::Instance().Editor.StatusBar;
 
@@ -373,6 +379,7 @@ namespace ed {
 						plugin->ShaderEditor_Close(m_pluginEditor[i].LanguageID, m_pluginEditor[i].ID);
 
 					m_items.erase(m_items.begin() + i);
+					m_markerGeneration.erase(m_editor[i]);
 					delete m_editor[i];
 					m_editor.erase(m_editor.begin() + i);
 					m_pluginEditor.erase(m_pluginEditor.begin() + i);
@@ -987,6 +994,7 @@ namespace ed {
 					shader->Owner->CodeEditor_CloseItem(m_paths[i].c_str());
 				}
 
+				m_markerGeneration.erase(m_editor[i]);
 				delete m_editor[i];
 
 				m_items.erase(m_items.begin() + i);
@@ -1106,147 +1114,74 @@ namespace ed {
 			m_trackThread = nullptr;
 		}
 	}
-	void CodeEditorUI::m_trackWorker()
+	void CodeEditorUI::m_trackedFileChanged(const std::string& path)
 	{
-		std::string curProject = m_data->Parser.GetOpenedFile();
+		IncludeCache::Instance().Invalidate(DependencyGraph::Normalize(path));
 
-		std::vector<PipelineItem*> passes = m_data->Pipeline.GetList();
-		std::vector<bool> gsUsed(passes.size());
+		std::vector<std::string> dependents = DependencyGraph::Instance().GetDependents(path);
+		if (dependents.empty())
+			return;
 
-		std::vector<std::string> allFiles;	// list of all files we care for
-		std::vector<std::string> allPasses; // list of shader pass names that correspond to the file name
-		std::vector<std::string> paths;		// list of all paths that we should have "notifications turned on"
+		std::lock_guard<std::mutex> lock(m_trackFilesMutex);
+		for (const auto& item : dependents) {
+			// did we modify this file through "Compile" option?
+			auto ignored = std::find(m_trackIgnore.begin(), m_trackIgnore.end(), item);
+			if (ignored != m_trackIgnore.end()) {
+				m_trackIgnore.erase(ignored);
+				continue;
+			}
+
+			if (std::count(m_trackedNeedsUpdate.begin(), m_trackedNeedsUpdate.end(), item) == 0)
+				m_trackedNeedsUpdate.push_back(item);
+			m_trackUpdatesNeeded++;
+		}
+
+		// wake up the main loop in case it's idle
+		SDL_Event wakeEvent = {};
+		wakeEvent.type = SDL_USEREVENT;
+		SDL_PushEvent(&wakeEvent);
+	}
+	void CodeEditorUI::m_trackWorker()
+	{
+		DependencyGraph& deps = DependencyGraph::Instance();
+		unsigned int watchedVersion = deps.GetVersion() - 1;
+
+		std::vector<std::string> paths; // list of all directories that we should have "notifications turned on"
 
 		m_trackUpdatesNeeded = 0;
 
 #if defined(__APPLE__)
 		// TODO: implementation for macos (cant test)
 #elif defined(__linux__) || defined(__unix__)
-
-		int bufLength, bufIndex = 0;
+		int bufLength = 0;
 		int notifyEngine = inotify_init1(IN_NONBLOCK);
 		char buffer[EVENT_BUF_LEN];
 
 		std::vector<int> notifyIDs;
 
 		if (notifyEngine < 0) {
-			// TODO: log!
+			Logger::Get().Log("Failed to initialize inotify - file changes won't be tracked", true);
 			return;
 		}
-
-		// make sure that read() doesn't block on exit
-		int flags = fcntl(notifyEngine, F_GETFL, 0);
-		flags = (flags | O_NONBLOCK);
-		fcntl(notifyEngine, F_SETFL, flags);
-
 #elif defined(_WIN32)
 		// variables for storing all the handles
-		std::vector<HANDLE> events(paths.size());
-		std::vector<HANDLE> hDirs(paths.size());
-		std::vector<OVERLAPPED> pOverlap(paths.size());
+		std::vector<HANDLE> events;
+		std::vector<HANDLE> hDirs;
+		std::vector<OVERLAPPED> pOverlap;
 
-		// buffer data
+		// buffer data - one per directory since the reads are asynchronous
 		const int bufferLen = 2048;
-		char buffer[bufferLen];
+		std::vector<std::vector<DWORD>> buffers;
 		DWORD bytesReturned;
 		char filename[SHADERED_MAX_PATH];
 #endif
 
 		// run this loop until we close the thread
 		while (m_trackerRunning) {
-			std::this_thread::sleep_for(std::chrono::milliseconds(25));
-
-			for (int j = 0; j < m_trackedNeedsUpdate.size(); j++)
-				m_trackedNeedsUpdate[j] = false;
-
-			// check if user added/changed shader paths
-			std::vector<PipelineItem*> nPasses = m_data->Pipeline.GetList();
-			bool needsUpdate = false;
-			for (auto& pass : nPasses) {
-				if (pass->Type == PipelineItem::ItemType::ShaderPass) {
-					pipe::ShaderPass* data = (pipe::ShaderPass*)pass->Data;
-
-					bool foundVS = false, foundPS = false, foundGS = false;
-
-					std::string vsPath(m_data->Parser.GetProjectPath(data->VSPath));
-					std::string psPath(m_data->Parser.GetProjectPath(data->PSPath));
-
-					for (auto& f : allFiles) {
-						if (f == vsPath) {
-							foundVS = true;
-							if (foundPS) break;
-						} else if (f == psPath) {
-							foundPS = true;
-							if (foundVS) break;
-						}
-					}
-
-					if (data->GSUsed) {
-						std::string gsPath(m_data->Parser.GetProjectPath(data->GSPath));
-						for (auto& f : allFiles)
-							if (f == gsPath) {
-								foundGS = true;
-								break;
-							}
-					} else
-						foundGS = true;
-
-					if (!foundGS || !foundVS || !foundPS) {
-						needsUpdate = true;
-						break;
-					}
-				} else if (pass->Type == PipelineItem::ItemType::ComputePass) {
-					pipe::ComputePass* data = (pipe::ComputePass*)pass->Data;
-
-					bool found = false;
+			// the watch list only changes when a pass was (re)compiled with a different set of files
+			if (watchedVersion != deps.GetVersion()) {
+				watchedVersion = deps.GetVersion();
 
-					std::string path(m_data->Parser.GetProjectPath(data->Path));
-
-					for (auto& f : allFiles)
-						if (f == path)
-							found = true;
-
-					if (!found) {
-						needsUpdate = true;
-						break;
-					}
-				} else if (pass->Type == PipelineItem::ItemType::AudioPass) {
-					pipe::AudioPass* data = (pipe::AudioPass*)pass->Data;
-
-					bool found = false;
-
-					std::string path(m_data->Parser.GetProjectPath(data->Path));
-
-					for (auto& f : allFiles)
-						if (f == path)
-							found = true;
-
-					if (!found) {
-						needsUpdate = true;
-						break;
-					}
-				} else if (pass->Type == PipelineItem::ItemType::PluginItem) {
-					pipe::PluginItemData* data = (pipe::PluginItemData*)pass->Data;
-
-					if (data->Owner->ShaderFilePath_HasChanged()) {
-						needsUpdate = true;
-						data->Owner->ShaderFilePath_Update();
-					}
-				}
-			}
-
-			for (int i = 0; i < gsUsed.size() && i < nPasses.size(); i++) {
-				if (nPasses[i]->Type == PipelineItem::ItemType::ShaderPass) {
-					bool used = ((pipe::ShaderPass*)nPasses[i]->Data)->GSUsed;
-					if (gsUsed[i] != used) {
-						gsUsed[i] = used;
-						needsUpdate = true;
-					}
-				}
-			}
-
-			// update our file collection if needed
-			if (needsUpdate || nPasses.size() != passes.size() || curProject != m_data->Parser.GetOpenedFile() || paths.size() == 0) {
 #if defined(__APPLE__)
 				// TODO: implementation for macos
 #elif defined(__linux__) || defined(__unix__)
@@ -1262,69 +1197,24 @@ namespace ed {
 				hDirs.clear();
 #endif
 
-				allFiles.clear();
-				allPasses.clear();
+				// every shader file and every file they #include
 				paths.clear();
-				curProject = m_data->Parser.GetOpenedFile();
-
-				// get all paths to all shaders
-				passes = nPasses;
-				gsUsed.resize(passes.size());
-				m_trackedNeedsUpdate.resize(passes.size());
-				for (const auto& pass : passes) {
-					if (pass->Type == PipelineItem::ItemType::ShaderPass) {
-						pipe::ShaderPass* data = (pipe::ShaderPass*)pass->Data;
-
-						std::string vsPath(m_data->Parser.GetProjectPath(data->VSPath));
-						std::string psPath(m_data->Parser.GetProjectPath(data->PSPath));
-
-						allFiles.push_back(vsPath);
-						paths.push_back(vsPath.substr(0, vsPath.find_last_of("/\\") + 1));
-						allPasses.push_back(pass->Name);
-
-						allFiles.push_back(psPath);
-						paths.push_back(psPath.substr(0, psPath.find_last_of("/\\") + 1));
-						allPasses.push_back(pass->Name);
-
-						if (data->GSUsed) {
-							std::string gsPath(m_data->Parser.GetProjectPath(data->GSPath));
-
-							allFiles.push_back(gsPath);
-							paths.push_back(gsPath.substr(0, gsPath.find_last_of("/\\") + 1));
-							allPasses.push_back(pass->Name);
-						}
-					} else if (pass->Type == PipelineItem::ItemType::ComputePass) {
-						pipe::ComputePass* data = (pipe::ComputePass*)pass->Data;
-
-						std::string path(m_data->Parser.GetProjectPath(data->Path));
-
-						allFiles.push_back(path);
-						paths.push_back(path.substr(0, path.find_last_of("/\\") + 1));
-						allPasses.push_back(pass->Name);
-					} else if (pass->Type == PipelineItem::ItemType::AudioPass) {
-						pipe::AudioPass* data = (pipe::AudioPass*)pass->Data;
-
-						std::string path(m_data->Parser.GetProjectPath(data->Path));
-
-						allFiles.push_back(path);
-						paths.push_back(path.substr(0, path.find_last_of("/\\") + 1));
-						allPasses.push_back(pass->Name);
-					} else if (pass->Type == PipelineItem::ItemType::PluginItem) {
-						pipe::PluginItemData* data = (pipe::PluginItemData*)pass->Data;
-
-						int count = data->Owner->ShaderFilePath_GetCount();
-
-						for (int i = 0; i < count; i++) {
-							std::string path(m_data->Parser.GetProjectPath(data->Owner->ShaderFilePath_Get(i)));
-
-							allFiles.push_back(path);
-							paths.push_back(path.substr(0, path.find_last_of("/\\") + 1));
-							allPasses.push_back(pass->Name);
-						}
-					}
+				std::vector<std::string> files = deps.GetFiles();
+				for (const auto& file : files) {
+					std::string dir = file.substr(0, file.find_last_of('/') + 1);
+					if (!dir.empty() && std::count(paths.begin(), paths.end(), dir) == 0)
+						paths.push_back(dir);
 				}
 
-				// delete directories that appear twice or that are subdirectories
+#if defined(__APPLE__)
+				// TODO: implementation for macos
+#elif defined(__linux__) || defined(__unix__)
+				// create HANDLE to all tracked directories
+				notifyIDs.resize(paths.size());
+				for (int i = 0; i < paths.size(); i++)
+					notifyIDs[i] = inotify_add_watch(notifyEngine, paths[i].c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+#elif defined(_WIN32)
+				// subdirectories are covered by their parent's watch
 				{
 					std::vector<bool> toDelete(paths.size(), false);
 
@@ -1334,7 +1224,7 @@ namespace ed {
 						for (int j = 0; j < paths.size(); j++) {
 							if (j == i || toDelete[j]) continue;
 
-							if (paths[j].find(paths[i]) != std::string::npos)
+							if (paths[j].find(paths[i]) == 0)
 								toDelete[j] = true;
 						}
 					}
@@ -1347,17 +1237,10 @@ namespace ed {
 						}
 				}
 
-#if defined(__APPLE__)
-				// TODO: implementation for macos
-#elif defined(__linux__) || defined(__unix__)
-				// create HANDLE to all tracked directories
-				notifyIDs.resize(paths.size());
-				for (int i = 0; i < paths.size(); i++)
-					notifyIDs[i] = inotify_add_watch(notifyEngine, paths[i].c_str(), IN_MODIFY);
-#elif defined(_WIN32)
 				events.resize(paths.size());
 				hDirs.resize(paths.size());
 				pOverlap.resize(paths.size());
+				buffers.resize(paths.size(), std::vector<DWORD>(bufferLen / sizeof(DWORD)));
 
 				// create HANDLE to all tracked directories
 				for (int i = 0; i < paths.size(); i++) {
@@ -1369,146 +1252,89 @@ namespace ed {
 					if (hDirs[i] == INVALID_HANDLE_VALUE)
 						return;
 
-					pOverlap[i].OffsetHigh = 0;
+					pOverlap[i] = OVERLAPPED();
 					pOverlap[i].hEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
 
 					events[i] = pOverlap[i].hEvent;
+
+					ReadDirectoryChangesW(hDirs[i], buffers[i].data(), bufferLen, TRUE,
+						FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_LAST_WRITE, &bytesReturned, &pOverlap[i], NULL);
 				}
 #endif
 			}
 
-			if (paths.size() == 0) {
-				std::this_thread::sleep_for(std::chrono::milliseconds(500));
-				continue;
-			}
-
 #if defined(__APPLE__)
 			// TODO: implementation for macos
+			std::this_thread::sleep_for(std::chrono::milliseconds(500));
 		}
 #elif defined(__linux__) || defined(__unix__)
+			// block until something changes - the timeout is only there to notice
+			// that the thread should stop or that the dependency graph changed
 			fd_set rfds;
-			int eCount = select(notifyEngine + 1, &rfds, NULL, NULL, NULL);
+			FD_ZERO(&rfds);
+			FD_SET(notifyEngine, &rfds);
 
+			timeval timeout;
+			timeout.tv_sec = 0;
+			timeout.tv_usec = 250 * 1000;
+
+			int eCount = select(notifyEngine + 1, &rfds, NULL, NULL, &timeout);
 			if (eCount <= 0) continue;
 
 			// check for changes
 			bufLength = read(notifyEngine, buffer, EVENT_BUF_LEN);
-			if (bufLength < 0) { /* TODO: error! */
-			}
+			if (bufLength <= 0)
+				continue;
 
 			// read all events
+			int bufIndex = 0;
 			while (bufIndex < bufLength) {
 				struct inotify_event* event = (struct inotify_event*)&buffer[bufIndex];
-				if (event->len) {
-					if (event->mask & IN_MODIFY) {
-						if (event->mask & IN_ISDIR) { /* it is a directory - do nothing */
-						} else {
-							// check if its our shader and push it on the update queue if it is
-							char filename[SHADERED_MAX_PATH];
-							strcpy(filename, event->name);
-
-							int pathIndex = 0;
-							for (int i = 0; i < notifyIDs.size(); i++) {
-								if (event->wd == notifyIDs[i]) {
-									pathIndex = i;
-									break;
-								}
-							}
-
-							std::lock_guard<std::mutex> lock(m_trackFilesMutex);
-							std::string updatedFile(paths[pathIndex] + filename);
-
-							for (int i = 0; i < allFiles.size(); i++)
-								if (allFiles[i] == updatedFile) {
-									// did we modify this file through "Compile" option?
-									bool shouldBeIgnored = false;
-									for (int j = 0; j < m_trackIgnore.size(); j++)
-										if (m_trackIgnore[j] == allPasses[i]) {
-											shouldBeIgnored = true;
-											m_trackIgnore.erase(m_trackIgnore.begin() + j);
-											break;
-										}
-
-									if (!shouldBeIgnored) {
-										m_trackUpdatesNeeded++;
-
-										for (int j = 0; j < passes.size(); j++)
-											if (allPasses[i] == passes[j]->Name)
-												m_trackedNeedsUpdate[j] = true;
-									}
-								}
+				if (event->len && !(event->mask & IN_ISDIR)) {
+					for (int i = 0; i < notifyIDs.size(); i++)
+						if (event->wd == notifyIDs[i]) {
+							m_trackedFileChanged(paths[i] + event->name);
+							break;
 						}
-					}
 				}
 				bufIndex += EVENT_SIZE + event->len;
 			}
-			bufIndex = 0;
 		}
 
 		for (int i = 0; i < notifyIDs.size(); i++)
 			inotify_rm_watch(notifyEngine, notifyIDs[i]);
 		close(notifyEngine);
 #elif defined(_WIN32)
-			// notification data
-			FILE_NOTIFY_INFORMATION* notif;
-			int bufferOffset;
-
-			// check for changes
-			for (int i = 0; i < paths.size(); i++) {
-				ReadDirectoryChangesW(
-					hDirs[i],
-					&buffer,
-					bufferLen * sizeof(char),
-					TRUE,
-					FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_LAST_WRITE,
-					&bytesReturned,
-					&pOverlap[i],
-					NULL);
+			if (paths.size() == 0) {
+				std::this_thread::sleep_for(std::chrono::milliseconds(250));
+				continue;
 			}
 
-			DWORD dwWaitStatus = WaitForMultipleObjects(paths.size(), events.data(), false, 1000);
+			DWORD dwWaitStatus = WaitForMultipleObjects(paths.size(), events.data(), false, 250);
+			if (dwWaitStatus == WAIT_TIMEOUT || dwWaitStatus == WAIT_FAILED)
+				continue;
 
-			// check if we got any info
-			if (dwWaitStatus != WAIT_TIMEOUT) {
-				bufferOffset = 0;
+			int pathIndex = dwWaitStatus - WAIT_OBJECT_0;
+			if (GetOverlappedResult(hDirs[pathIndex], &pOverlap[pathIndex], &bytesReturned, FALSE) && bytesReturned > 0) {
+				FILE_NOTIFY_INFORMATION* notif;
+				int bufferOffset = 0;
 				do {
 					// get notification data
-					notif = (FILE_NOTIFY_INFORMATION*)((char*)buffer + bufferOffset);
-					strcpy_s(filename, "");
-					int filenamelen = WideCharToMultiByte(CP_ACP, 0, notif->FileName, notif->FileNameLength / 2, filename, sizeof(filename), NULL, NULL);
-					if (filenamelen == 0)
-						continue;
-					filename[notif->FileNameLength / 2] = 0;
-
-					if (notif->Action == FILE_ACTION_MODIFIED) {
-						std::lock_guard<std::mutex> lock(m_trackFilesMutex);
-
-						std::string updatedFile(paths[dwWaitStatus - WAIT_OBJECT_0] + std::string(filename));
-
-						for (int i = 0; i < allFiles.size(); i++)
-							if (allFiles[i] == updatedFile) {
-								// did we modify this file through "Compile" option?
-								bool shouldBeIgnored = false;
-								for (int j = 0; j < m_trackIgnore.size(); j++)
-									if (m_trackIgnore[j] == allPasses[i]) {
-										shouldBeIgnored = true;
-										m_trackIgnore.erase(m_trackIgnore.begin() + j);
-										break;
-									}
-
-								if (!shouldBeIgnored) {
-									m_trackUpdatesNeeded++;
-
-									for (int j = 0; j < passes.size(); j++)
-										if (allPasses[i] == passes[j]->Name)
-											m_trackedNeedsUpdate[j] = true;
-								}
-							}
-					}
+					notif = (FILE_NOTIFY_INFORMATION*)((char*)buffers[pathIndex].data() + bufferOffset);
+					int filenamelen = WideCharToMultiByte(CP_ACP, 0, notif->FileName, notif->FileNameLength / 2, filename, sizeof(filename) - 1, NULL, NULL);
+					filename[filenamelen] = 0;
+
+					if (filenamelen > 0 && notif->Action == FILE_ACTION_MODIFIED)
+						m_trackedFileChanged(paths[pathIndex] + std::string(filename));
 
 					bufferOffset += notif->NextEntryOffset;
 				} while (notif->NextEntryOffset);
 			}
+
+			// wait for the next change in this directory
+			ResetEvent(events[pathIndex]);
+			ReadDirectoryChangesW(hDirs[pathIndex], buffers[pathIndex].data(), bufferLen, TRUE,
+				FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_LAST_WRITE, &bytesReturned, &pOverlap[pathIndex], NULL);
 		}
 		for (int i = 0; i < hDirs.size(); i++)
 			CloseHandle(hDirs[i]);
@@ -1518,7 +1344,6 @@ namespace ed {
 		hDirs.clear();
 #endif
 	}
-
 	TextEditor::LanguageDefinition CodeEditorUI::m_buildLanguageDefinition(IPlugin1* plugin, int languageID)
 	{
 		TextEditor::LanguageDefinition langDef;
@@ -69,8 +69,18 @@ namespace ed {
 		inline ImFont* GetImFont() { return m_font; }
 
 		inline bool TrackedFilesNeedUpdate() { return m_trackUpdatesNeeded > 0; }
-		inline void EmptyTrackedFiles() { m_trackUpdatesNeeded = 0; }
-		inline std::vector<bool> TrackedNeedsUpdate() { return m_trackedNeedsUpdate; }
+		inline void EmptyTrackedFiles()
+		{
+			std::lock_guard<std::mutex> lock(m_trackFilesMutex);
+			m_trackedNeedsUpdate.clear();
+			m_trackUpdatesNeeded = 0;
+		}
+		// names of the items whose shader files (or the files they include) changed
+		inline std::vector<std::string> TrackedNeedsUpdate()
+		{
+			std::lock_guard<std::mutex> lock(m_trackFilesMutex);
+			return m_trackedNeedsUpdate;
+		}
 
 		void SetOpenedFilesData(const std::vector<std::string>& data);
 		std::vector<std::string> GetOpenedFilesData();
@@ -120,6 +130,7 @@ namespace ed {
 		std::vector<std::string> m_paths;
 		std::vector<ShaderStage> m_shaderStage;
 		std::vector<PluginShaderEditor> m_pluginEditor;
+		std::unordered_map<TextEditor*, unsigned int> m_markerGeneration; // MessageStack generation the error markers were built from
 		std::deque<bool> m_editorOpen;
 
 		int m_editorSaveRequestID;
@@ -143,7 +154,8 @@ namespace ed {
 
 		// all the variables needed for the file change notifications
 		void m_trackWorker();
-		std::vector<bool> m_trackedNeedsUpdate;
+		void m_trackedFileChanged(const std::string& path);
+		std::vector<std::string> m_trackedNeedsUpdate;
 		bool m_trackFileChanges;
 		std::atomic<bool> m_trackerRunning;
 		std::atomic<int> m_trackUpdatesNeeded;
@@ -13,6 +13,13 @@ namespace ed {
 	{
 		const std::vector<MessageStack::Message>& msgs = m_data->Messages.GetMessages();
 
+		if (m_generation != m_data->Messages.GetGeneration()) {
+			m_lines.resize(msgs.size());
+			for (int i = 0; i < msgs.size(); i++)
+				m_lines[i] = msgs[i].Line == -1 ? "" : std::to_string(msgs[i].Line);
+			m_generation = m_data->Messages.GetGeneration();
+		}
+
 		if (ImGui::BeginTable("##msg_table", 4, ImGuiTableFlags_Resizable | ImGuiTableFlags_ScrollFreezeTopRow | ImGuiTableFlags_ScrollY)) {
 			ImGui::TableSetupColumn("Shader Pass", ImGuiTableColumnFlags_WidthFixed, 120.0f);
 			ImGui::TableSetupColumn("Source", ImGuiTableColumnFlags_WidthFixed, 120.0f);
@@ -23,54 +30,59 @@ namespace ed {
 			int rowIndex = 0;
 			ed::CustomColors clrs = ThemeContainer::Instance().GetCustomStyle(Settings::Instance().Theme);
 
-			for (int i = 0; i < msgs.size(); i++) {
-				ImGui::TableNextRow();
+			// only the visible rows are submitted
+			ImGuiListClipper clipper;
+			clipper.Begin(msgs.size());
+			while (clipper.Step()) {
+				for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++) {
+					ImGui::TableNextRow();
 
-				const MessageStack::Message* m = &msgs[i];
+					const MessageStack::Message* m = &msgs[i];
 
-				ImVec4 color = clrs.InfoMessage;
-				if (m->MType == MessageStack::Type::Error)
-					color = clrs.ErrorMessage;
-				else if (m->MType == MessageStack::Type::Warning)
-					color = clrs.WarningMessage;
+					ImVec4 color = clrs.InfoMessage;
+					if (m->MType == MessageStack::Type::Error)
+						color = clrs.ErrorMessage;
+					else if (m->MType == MessageStack::Type::Warning)
+						color = clrs.WarningMessage;
 
-				ImGui::TableSetColumnIndex(0);
-				ImGui::PushID(i);
-				if (ImGui::Selectable(m->Group.c_str(), false, ImGuiSelectableFlags_SpanAllColumns | ImGuiSelectableFlags_AllowDoubleClick)) {
-					if (ImGui::IsMouseDoubleClicked(ImGuiMouseButton_Left)) {
-						ed::PipelineItem* pass = m_data->Pipeline.Get(m->Group.c_str());
+					ImGui::TableSetColumnIndex(0);
+					ImGui::PushID(i);
+					if (ImGui::Selectable(m->Group.c_str(), false, ImGuiSelectableFlags_SpanAllColumns | ImGuiSelectableFlags_AllowDoubleClick)) {
+						if (ImGui::IsMouseDoubleClicked(ImGuiMouseButton_Left)) {
+							ed::PipelineItem* pass = m_data->Pipeline.Get(m->Group.c_str());
 
-						if (pass != nullptr) {
-							CodeEditorUI* codeUI = (reinterpret_cast<CodeEditorUI*>(m_ui->Get(ViewID::Code)));
-							if (pass->Type == PipelineItem::ItemType::ShaderPass && m->Shader != ShaderStage::Count)
-								codeUI->Open(pass, m->Shader);
-							else if (pass->Type == PipelineItem::ItemType::ComputePass && m->Shader != ShaderStage::Count)
-								codeUI->Open(pass, m->Shader);
-							else if (pass->Type == PipelineItem::ItemType::AudioPass && m->Shader != ShaderStage::Count)
-								codeUI->Open(pass, m->Shader);
-							else if (pass->Type == PipelineItem::ItemType::PluginItem) {
-								pipe::PluginItemData* plData = ((pipe::PluginItemData*)pass->Data);
-								plData->Owner->PipelineItem_OpenInEditor(plData->Type, plData->PluginData);
-							}
+							if (pass != nullptr) {
+								CodeEditorUI* codeUI = (reinterpret_cast<CodeEditorUI*>(m_ui->Get(ViewID::Code)));
+								if (pass->Type == PipelineItem::ItemType::ShaderPass && m->Shader != ShaderStage::Count)
+									codeUI->Open(pass, m->Shader);
+								else if (pass->Type == PipelineItem::ItemType::ComputePass && m->Shader != ShaderStage::Count)
+									codeUI->Open(pass, m->Shader);
+								else if (pass->Type == PipelineItem::ItemType::AudioPass && m->Shader != ShaderStage::Count)
+									codeUI->Open(pass, m->Shader);
+								else if (pass->Type == PipelineItem::ItemType::PluginItem) {
+									pipe::PluginItemData* plData = ((pipe::PluginItemData*)pass->Data);
+									plData->Owner->PipelineItem_OpenInEditor(plData->Type, plData->PluginData);
+								}
 
-							TextEditor* editor = codeUI->Get(pass, m->Shader);
-							if (editor != nullptr && m->Line != -1)
-								editor->SetCursorPosition(TextEditor::Coordinates(std::max<int>(0, m->Line - 1), 0));
+								TextEditor* editor = codeUI->Get(pass, m->Shader);
+								if (editor != nullptr && m->Line != -1)
+									editor->SetCursorPosition(TextEditor::Coordinates(std::max<int>(0, m->Line - 1), 0));
+							}
 						}
 					}
-				}
-				ImGui::PopID();
+					ImGui::PopID();
 
-				ImGui::TableSetColumnIndex(1);
-				if (m->Shader != ShaderStage::Count) // TODO: array? duh
-					ImGui::Text(m->Shader == ShaderStage::Vertex ? "VS" : (m->Shader == ShaderStage::Pixel ? "PS" : (m->Shader == ShaderStage::Geometry ? "GS" : "CS")));
+					ImGui::TableSetColumnIndex(1);
+					if (m->Shader != ShaderStage::Count) // TODO: array? duh
+						ImGui::Text(m->Shader == ShaderStage::Vertex ? "VS" : (m->Shader == ShaderStage::Pixel ? "PS" : (m->Shader == ShaderStage::Geometry ? "GS" : "CS")));
 
-				ImGui::TableSetColumnIndex(2);
-				if (m->Line != -1)
-					ImGui::Text(std::to_string(m->Line).c_str());
+					ImGui::TableSetColumnIndex(2);
+					if (m->Line != -1)
+						ImGui::TextUnformatted(m_lines[i].c_str());
 
-				ImGui::TableSetColumnIndex(3);
-				ImGui::TextColored(color, m->Text.c_str());
+					ImGui::TableSetColumnIndex(3);
+					ImGui::TextColored(color, "%s", m->Text.c_str());
+				}
 			}
 
 			ImGui::EndTable();
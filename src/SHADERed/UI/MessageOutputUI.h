@@ -1,5 +1,7 @@
 #pragma once
 #include <SHADERed/UI/UIView.h>
+#include <string>
+#include <vector>
 
 namespace ed {
 	class MessageOutputUI : public UIView {
@@ -8,5 +10,10 @@ namespace ed {
 
 		virtual void OnEvent(const SDL_Event& e);
 		virtual void Update(float delta);
+
+	private:
+		// line number column, rebuilt only when the message stack changes
+		unsigned int m_generation = 0;
+		std::vector<std::string> m_lines;
 	};
 }
\ No newline at end of file
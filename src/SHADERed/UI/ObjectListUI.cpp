@@ -95,6 +95,7 @@ namespace ed {
 				}
 
 				bool hasPluginPreview = isPluginOwner && pobj->Owner->Object_HasPreview(pobj->Type);
+				m_data->Objects.Load(oItem); // thumbnail of a lazily created object
 				if (oItem->IsCube) {
 					m_cubePrev.Draw(tex);
 					ImGui::Image((void*)(intptr_t)m_cubePrev.GetTexture(), ImVec2(IMAGE_CONTEXT_WIDTH, ((float)imgWH) * IMAGE_CONTEXT_WIDTH), ImVec2(0, 1), ImVec2(1, 0));
@@ -185,6 +186,12 @@ namespace ed {
 					}
 				}
 
+				if (oItem->RT != nullptr || oItem->Image != nullptr || oItem->Buffer != nullptr) {
+					bool isPingPong = m_data->Objects.IsPingPong(items[i]);
+					if (ImGui::MenuItem("Ping-pong", (const char*)0, &isPingPong))
+						m_data->Objects.SetPingPong(items[i], isPingPong);
+				}
+
 				if (ImGui::Selectable("Delete")) {
 					if (m_data->Objects.IsRenderTexture(items[i])) {
 						auto& passes = m_data->Pipeline.GetList();
@@ -221,6 +228,12 @@ namespace ed {
 					if (isBuf) {
 						auto& passes = m_data->Pipeline.GetList();
 						for (int j = 0; j < passes.size(); j++) {
+							if (passes[j]->Type == PipelineItem::ItemType::ComputePass) {
+								pipe::ComputePass* cdata = (pipe::ComputePass*)passes[j]->Data;
+								if (cdata->IndirectBuffer == m_data->Objects.GetBuffer(items[i]))
+									cdata->IndirectBuffer = nullptr;
+							}
+
 							if (passes[j]->Type != PipelineItem::ItemType::ShaderPass)
 								continue;
 
@@ -16,6 +16,9 @@ namespace ed {
 				return;
 		}
 
+		// lazily created objects are loaded once someone looks at them
+		m_data->Objects.Load(m_data->Objects.GetObjectManagerItem(name));
+
 		mItem i;
 		i.Name = name;
 		i.Width = w;
@@ -174,9 +177,7 @@ namespace ed {
 							free(buf->Data);
 							buf->Data = newData;
 
-							glBindBuffer(GL_UNIFORM_BUFFER, buf->ID);
-							glBufferData(GL_UNIFORM_BUFFER, buf->Size, buf->Data, GL_STATIC_DRAW); // resize
-							glBindBuffer(GL_UNIFORM_BUFFER, 0);
+							m_data->Objects.UploadBufferData(buf);
 
 							m_data->Parser.ModifyProject();
 						}
@@ -187,9 +188,7 @@ namespace ed {
 						if (ImGui::Button("CLEAR##objprev_clearbuf")) {
 							memset(buf->Data, 0, buf->Size);
 
-							glBindBuffer(GL_UNIFORM_BUFFER, buf->ID);
-							glBufferData(GL_UNIFORM_BUFFER, buf->Size, buf->Data, GL_STATIC_DRAW); // upload data
-							glBindBuffer(GL_UNIFORM_BUFFER, 0);
+							m_data->Objects.UploadBufferData(buf);
 
 							m_data->Parser.ModifyProject();
 						}
@@ -237,7 +236,7 @@ namespace ed {
 						// update buffer data every 350ms
 						ImGui::Text(buf->PreviewPaused ? "Buffer view is paused" : "Buffer view is updated every 350ms");
 						if (!buf->PreviewPaused && m_bufUpdateClock.GetElapsedTime() > 0.350f) {
-							glBindBuffer(GL_SHADER_STORAGE_BUFFER, buf->ID);
+							glBindBuffer(GL_SHADER_STORAGE_BUFFER, buf->PingPong ? buf->PreviousID : buf->ID); // last complete version
 							glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, buf->Size, buf->Data);
 							glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
 							m_bufUpdateClock.Restart();
@@ -281,9 +280,7 @@ namespace ed {
 
 									int dOffset = i * perRow + curColOffset;
 									if (m_drawBufferElement(i, j, (void*)(((char*)buf->Data) + dOffset), item->CachedFormat[j])) {
-										glBindBuffer(GL_UNIFORM_BUFFER, buf->ID);
-										glBufferData(GL_UNIFORM_BUFFER, buf->Size, buf->Data, GL_STATIC_DRAW); // allocate 0 bytes of memory
-										glBindBuffer(GL_UNIFORM_BUFFER, 0);
+										m_data->Objects.UploadBufferData(buf);
 
 										m_data->Parser.ModifyProject();
 									}
@@ -313,7 +310,7 @@ namespace ed {
 						const glm::vec2& zPos = m_zoom[i].GetZoomPosition();
 						const glm::vec2& zSize = m_zoom[i].GetZoomSize();
 						
-						ImGui::Image((void*)(intptr_t)item->Texture, aSize, ImVec2(zPos.x, zPos.y + zSize.y), ImVec2(zPos.x + zSize.x, zPos.y));
+						ImGui::Image((void*)(intptr_t)m_data->Objects.GetPingPongRead(item->Texture, false), aSize, ImVec2(zPos.x, zPos.y + zSize.y), ImVec2(zPos.x + zSize.x, zPos.y));
 
 						if (ImGui::IsItemHovered()) {
 							m_curHoveredItem = i;
@@ -281,16 +281,10 @@ namespace ed {
 		ImGui::Checkbox("##optg_autoerror", &settings->General.AutoOpenErrorWindow);
 
 		/* RECOVERY: */
-		ImGui::PushItemFlag(ImGuiItemFlags_Disabled, true);
-		ImGui::PushStyleVar(ImGuiStyleVar_Alpha, ImGui::GetStyle().Alpha * 0.5f);
-
 		ImGui::Text("Save recovery file every 10mins: ");
 		ImGui::SameLine();
 		ImGui::Checkbox("##optg_recovery", &settings->General.Recovery);
 
-		ImGui::PopStyleVar();
-		ImGui::PopItemFlag();
-
 		/* CHECK FOR UPDATES: */
 		ImGui::Text("Check for updates on startup: ");
 		ImGui::SameLine();
@@ -338,6 +332,16 @@ namespace ed {
 			ImGui::PopItemFlag();
 		}
 
+		/* DIRECT SPIR-V: */
+		ImGui::Text("Load HLSL & Vulkan shaders as SPIR-V when supported: ");
+		ImGui::SameLine();
+		ImGui::Checkbox("##optg_directspirv", &settings->General.DirectSPIRV);
+
+		/* LAZY LOADING: */
+		ImGui::Text("Load textures, audio & models only when they are used: ");
+		ImGui::SameLine();
+		ImGui::Checkbox("##optg_lazyloading", &settings->General.LazyLoading);
+
 		/* REOPEN: */
 		ImGui::Text("Reopen shaders after openning a project: ");
 		ImGui::SameLine();
@@ -882,6 +886,24 @@ namespace ed {
 			ImGui::PopStyleVar();
 			ImGui::PopItemFlag();
 		}
+
+		/* IDLE WHEN STATIC: */
+		ImGui::Text("Only redraw when something changed or is animated: ");
+		ImGui::SameLine();
+		ImGui::Checkbox("##optp_idlestatic", &settings->Preview.IdleWhenStatic);
+
+		/* FRUSTUM CULLING: */
+		ImGui::Text("Skip items outside of the camera view: ");
+		ImGui::SameLine();
+		ImGui::Checkbox("##optp_frustumcull", &settings->Preview.FrustumCulling);
+
+		/* FIXED TIME STEP: */
+		ImGui::Text("Fixed time step (FPS, 0 = real time): ");
+		ImGui::SameLine();
+		ImGui::PushItemWidth(-1);
+		if (ImGui::InputInt("##optp_fixedstep", &settings->Preview.FixedTimeStepFPS, 1, 10))
+			settings->Preview.FixedTimeStepFPS = std::max(0, settings->Preview.FixedTimeStepFPS);
+		ImGui::PopItemWidth();
 	}
 	void OptionsUI::m_renderPlugins()
 	{
@@ -521,7 +521,7 @@ namespace ed {
 		ShaderVariable::ValueType type = var->GetType();
 
 		bool canInvert = type >= ShaderVariable::ValueType::Float2x2 && type <= ShaderVariable::ValueType::Float4x4;
-		bool canLastFrame = var->System != ed::SystemShaderVariable::Time && var->System != ed::SystemShaderVariable::IsPicked && var->System != ed::SystemShaderVariable::IsSavingToFile && var->System != ed::SystemShaderVariable::ViewportSize;
+		bool canLastFrame = var->System != ed::SystemShaderVariable::Time && var->System != ed::SystemShaderVariable::IsPicked && var->System != ed::SystemShaderVariable::IsSavingToFile && var->System != ed::SystemShaderVariable::ViewportSize && var->System != ed::SystemShaderVariable::IterationIndex;
 
 		if (var->System == ed::SystemShaderVariable::PluginVariable)
 			canLastFrame = canLastFrame || var->PluginSystemVarData.Owner->SystemVariables_HasLastFrame(var->PluginSystemVarData.Name, (plugin::VariableType)var->GetType());
@@ -1462,6 +1462,7 @@ namespace ed {
 		ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(0, 0, 0, 0));
 		if (ImGui::Button(std::string(std::string(data->Active ? UI_ICON_EYE : UI_ICON_EYE_BLOCKED) + "##hide" + std::string(item->Name)).c_str(), BUTTON_ICON_SIZE)) {
 			data->Active = !data->Active;
+			m_data->Objects.InvalidateBinds();
 			m_data->Parser.ModifyProject();
 		}
 		ImGui::SameLine(0, 0);
@@ -1675,6 +1676,7 @@ namespace ed {
 		ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(0, 0, 0, 0));
 		if (ImGui::Button(std::string(std::string(data->Active ? UI_ICON_EYE : UI_ICON_EYE_BLOCKED) + "##hide" + std::string(item->Name)).c_str(), BUTTON_ICON_SIZE)) {
 			data->Active = !data->Active;
+			m_data->Objects.InvalidateBinds();
 			m_data->Parser.ModifyProject();
 		}
 		ImGui::PopStyleColor();
@@ -1,6 +1,7 @@
 #include <SHADERed/Engine/GLUtils.h>
 #include <SHADERed/Engine/GeometryFactory.h>
 #include <SHADERed/Objects/DefaultState.h>
+#include <SHADERed/Objects/GLState.h>
 #include <SHADERed/Objects/KeyboardShortcuts.h>
 #include <SHADERed/Objects/Logger.h>
 #include <SHADERed/Objects/Settings.h>
@@ -83,6 +84,7 @@ namespace ed {
 
 			SystemVariableManager::Instance().AdvanceTimer(deltaTime); // add one second to timer
 			SystemVariableManager::Instance().SetFrameIndex(SystemVariableManager::Instance().GetFrameIndex() + 1);
+			m_data->Renderer.StepPingPong();
 
 			m_data->Renderer.Render(m_imgSize.x, m_imgSize.y);
 		});
@@ -94,6 +96,7 @@ namespace ed {
 
 			SystemVariableManager::Instance().AdvanceTimer(0.1f);																   // add one second to timer
 			SystemVariableManager::Instance().SetFrameIndex(SystemVariableManager::Instance().GetFrameIndex() + 0.1f / deltaTime); // add estimated number of frames
+			m_data->Renderer.StepPingPong();
 
 			m_data->Renderer.Render(m_imgSize.x, m_imgSize.y);
 		});
@@ -297,6 +300,7 @@ namespace ed {
 			m_zoomLastSize.x = imageSize.x;
 			m_zoomLastSize.y = imageSize.y;
 			SystemVariableManager::Instance().SetViewportSize(imageSize.x, imageSize.y);
+			renderer->Invalidate();
 
 			m_zoom.RebuildVBO(imageSize.x, imageSize.y);
 		}
@@ -306,8 +310,10 @@ namespace ed {
 
 		bool useFpsLimit = !capWholeApp && m_fpsLimit > 0 && m_elapsedTime >= 1.0f / m_fpsLimit;
 		if (capWholeApp || m_fpsLimit <= 0 || useFpsLimit) {
-			if (!paused) {
+			if (!paused && (!settings.Preview.IdleWhenStatic || renderer->NeedsRender())) {
+				m_pacer.BeginFrame();
 				renderer->Render(imageSize.x, imageSize.y);
+				m_pacer.EndFrame();
 				m_data->Objects.Update(delta);
 			}
 
@@ -320,8 +326,8 @@ namespace ed {
 			m_elapsedTime -= (1 / m_fpsLimit) * useFpsLimit + (delta * !useFpsLimit);
 		}
 
-		if (capWholeApp && m_fpsLimit > 0 && 1000 / delta > m_fpsLimit)
-			std::this_thread::sleep_for(std::chrono::milliseconds(1000 / (int)m_fpsLimit - (int)(1000 * delta)));
+		if (capWholeApp)
+			m_pacer.Wait(m_fpsLimit);
 
 		GLuint rtView = renderer->GetTexture();
 		
@@ -817,6 +823,14 @@ namespace ed {
 		float FPS = 1.0f / m_fpsDelta;
 		ImGui::Separator();
 		ImGui::Text("FPS: %.2f", FPS);
+		if (ImGui::IsItemHovered()) {
+			GLState& glState = GLState::Instance();
+			BarrierTracker& barriers = m_data->Renderer.GetBarrierTracker();
+			if (m_pacer.GetGPUTime() >= 0.0f)
+				ImGui::SetTooltip("CPU: %.3f ms\nGPU: %.3f ms\nState changes: %d (%d redundant skipped)\nMemory barriers: %d (%d passes didn't wait)", m_pacer.GetCPUTime() * 1000.0f, m_pacer.GetGPUTime() * 1000.0f, glState.GetIssuedCount(), glState.GetSkippedCount(), barriers.GetBarrierCount(), barriers.GetSkippedCount());
+			else
+				ImGui::SetTooltip("CPU: %.3f ms\nState changes: %d (%d redundant skipped)\nMemory barriers: %d (%d passes didn't wait)", m_pacer.GetCPUTime() * 1000.0f, glState.GetIssuedCount(), glState.GetSkippedCount(), barriers.GetBarrierCount(), barriers.GetSkippedCount());
+		}
 
 		if (isTimeVisible) {
 			ImGui::SameLine(Settings::Instance().CalculateSize(120));
@@ -902,6 +916,7 @@ namespace ed {
 				SystemVariableManager::Instance().AdvanceTimer(0.1f);																   // add one second to timer
 				SystemVariableManager::Instance().SetFrameIndex(SystemVariableManager::Instance().GetFrameIndex() + 0.1f / deltaTime); // add estimated number of frames
 			}
+			m_data->Renderer.StepPingPong();
 
 			m_data->Renderer.Render(m_imgSize.x, m_imgSize.y);
 		}
@@ -1,4 +1,5 @@
 #pragma once
+#include <SHADERed/Objects/FramePacer.h>
 #include <SHADERed/Objects/GizmoObject.h>
 #include <SHADERed/UI/Tools/Magnifier.h>
 #include <SHADERed/UI/UIView.h>
@@ -83,6 +84,7 @@ namespace ed {
 		glm::vec3 m_pos1, m_pos2;
 
 		eng::Timer m_fpsTimer;
+		FramePacer m_pacer;
 		float m_fpsDelta;
 		float m_fpsUpdateTime; // check if 0.5s passed then update the fps widget
 
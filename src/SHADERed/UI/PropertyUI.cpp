@@ -1,4 +1,6 @@
 #include <SHADERed/Engine/GLUtils.h>
+#include <SHADERed/Objects/DependencyGraph.h>
+#include <SHADERed/Objects/DrawBatcher.h>
 #include <SHADERed/Objects/Logger.h>
 #include <SHADERed/Objects/Names.h>
 #include <SHADERed/Objects/ShaderCompiler.h>
@@ -94,6 +96,7 @@ namespace ed {
 						}
 
 						m_data->Messages.RenameGroup(m_current->Name, m_itemName);
+						DependencyGraph::Instance().RenameItem(m_current->Name, m_itemName);
 						memcpy(m_current->Name, m_itemName, PIPELINE_ITEM_NAME_LENGTH);
 						m_data->Parser.ModifyProject();
 					}
@@ -313,6 +316,33 @@ namespace ed {
 					ImGui::NextColumn();
 
 					if (!item->GSUsed) ImGui::PopItemFlag();
+
+					/* spirv-opt - GLSL is handed to the driver as it is, only HLSL, Vulkan GLSL & plugin languages go through SPIR-V */
+					bool usesSPIRV = ShaderCompiler::GetShaderLanguageFromExtension(item->VSPath) != ShaderLanguage::GLSL || ShaderCompiler::GetShaderLanguageFromExtension(item->PSPath) != ShaderLanguage::GLSL || (item->GSUsed && ShaderCompiler::GetShaderLanguageFromExtension(item->GSPath) != ShaderLanguage::GLSL);
+					if (usesSPIRV) {
+						ImGui::Separator();
+
+						ImGui::Text("Optimize:");
+						ImGui::NextColumn();
+						if (ImGui::Checkbox("##pui_optimize", &item->Optimize)) {
+							m_data->Parser.ModifyProject();
+							m_data->Renderer.Recompile(m_current->Name);
+						}
+						ImGui::NextColumn();
+					}
+
+					/* multi-draw batching */
+					if (DrawBatcher::IsSupported()) {
+						ImGui::Separator();
+
+						ImGui::Text("Batch:");
+						ImGui::NextColumn();
+						if (ImGui::Checkbox("##pui_batch", &item->Batch))
+							m_data->Parser.ModifyProject();
+						if (ImGui::IsItemHovered())
+							ImGui::SetTooltip("Draw geometry & models with one multi-draw call. Shaders read the world matrix from\nlayout(std430, binding = %d) buffer { mat4 transforms[]; } at gl_BaseInstance + gl_InstanceID", DrawBatcher::TransformBinding);
+						ImGui::NextColumn();
+					}
 				} else if (m_current->Type == ed::PipelineItem::ItemType::ComputePass) {
 					ed::pipe::ComputePass* item = reinterpret_cast<ed::pipe::ComputePass*>(m_current->Data);
 
@@ -362,6 +392,77 @@ namespace ed {
 
 						m_data->Parser.ModifyProject();
 					}
+					ImGui::NextColumn();
+					ImGui::Separator();
+
+					/* indirect dispatch buffer */
+					ImGui::Text("Indirect buffer:");
+					ImGui::NextColumn();
+
+					const auto& bufList = m_data->Objects.GetItemDataList();
+					auto& bufNames = m_data->Objects.GetObjects();
+					ImGui::PushItemWidth(-1);
+					if (ImGui::BeginCombo("##pui_csindirect", ((item->IndirectBuffer == nullptr) ? "NULL" : (m_data->Objects.GetBufferNameByID(((BufferObject*)item->IndirectBuffer)->ID).c_str())))) {
+						// null element -> use the group size
+						if (ImGui::Selectable("NULL", item->IndirectBuffer == nullptr)) {
+							item->IndirectBuffer = nullptr;
+							m_data->Parser.ModifyProject();
+						}
+
+						for (int i = 0; i < bufList.size(); i++) {
+							if (bufList[i]->Buffer == nullptr)
+								continue;
+
+							ed::BufferObject* buf = bufList[i]->Buffer;
+							if (ImGui::Selectable(bufNames[i].c_str(), buf == item->IndirectBuffer)) {
+								item->IndirectBuffer = buf;
+								m_data->Parser.ModifyProject();
+							}
+						}
+
+						ImGui::EndCombo();
+					}
+					ImGui::PopItemWidth();
+					ImGui::NextColumn();
+					ImGui::Separator();
+
+					if (item->IndirectBuffer != nullptr) {
+						/* indirect buffer offset */
+						ImGui::Text("Indirect offset:");
+						ImGui::NextColumn();
+						int offset = item->IndirectOffset;
+						ImGui::PushItemWidth(-1);
+						if (ImGui::InputInt("##pui_csindirectoffset", &offset, 4, 16)) {
+							item->IndirectOffset = std::max<int>(offset, 0) & ~3; // must be aligned to 4 bytes
+							m_data->Parser.ModifyProject();
+						}
+						ImGui::PopItemWidth();
+						ImGui::NextColumn();
+						ImGui::Separator();
+					}
+
+					/* iterations */
+					ImGui::Text("Iterations:");
+					ImGui::NextColumn();
+					ImGui::PushItemWidth(-1);
+					if (ImGui::InputInt("##pui_csiterations", &item->Iterations, 1, 10)) {
+						item->Iterations = std::max<int>(item->Iterations, 1);
+						m_data->Parser.ModifyProject();
+					}
+					ImGui::PopItemWidth();
+					ImGui::NextColumn();
+
+					/* spirv-opt */
+					if (ShaderCompiler::GetShaderLanguageFromExtension(item->Path) != ShaderLanguage::GLSL) {
+						ImGui::Separator();
+
+						ImGui::Text("Optimize:");
+						ImGui::NextColumn();
+						if (ImGui::Checkbox("##pui_csoptimize", &item->Optimize)) {
+							m_data->Parser.ModifyProject();
+							m_data->Renderer.Recompile(m_current->Name);
+						}
+					}
 				} else if (m_current->Type == ed::PipelineItem::ItemType::AudioPass) {
 					ed::pipe::AudioPass* item = reinterpret_cast<ed::pipe::AudioPass*>(m_current->Data);
 
@@ -1,24 +1,45 @@
 #include <SHADERed/UI/Tools/StatsPage.h>
+#include <SHADERed/Objects/ShaderCompiler.h>
 #include <SHADERed/Objects/ThemeContainer.h>
 #include <SHADERed/Objects/Settings.h>
 #include <imgui/imgui.h>
 #include <spirv-tools/libspirv.h>
-#include <spirv-tools/optimizer.hpp>
 
 namespace ed {
 	void StatsPage::OnEvent(const SDL_Event& e) { }
 	void StatsPage::Update(float delta)
 	{
-		ImGui::Text("Arithmetic instruction count: %d", m_info.ArithmeticInstCount);
-		ImGui::Text("Bit instruction count: %d", m_info.BitInstCount);
-		ImGui::Text("Logical instruction count: %d", m_info.LogicalInstCount);
-		ImGui::Text("Texture instruction count: %d", m_info.TextureInstCount);
-		ImGui::Text("Derivative instruction count: %d", m_info.DerivativeInstCount);
-		ImGui::Text("Control flow instruction count: %d", m_info.ControlFlowInstCount);
+		// what would spirv-opt do with this shader
+		ImGui::Columns(3, "##stats_counts", false);
+		ImGui::NextColumn();
+		ImGui::Text("Original");
+		ImGui::NextColumn();
+		ImGui::Text("Optimized");
+		ImGui::NextColumn();
+
+		auto countRow = [](const char* label, int original, int optimized) {
+			ImGui::Text("%s", label);
+			ImGui::NextColumn();
+			ImGui::Text("%d", original);
+			ImGui::NextColumn();
+			ImGui::Text("%d", optimized);
+			ImGui::NextColumn();
+		};
+		countRow("Arithmetic instruction count:", m_info.ArithmeticInstCount, m_infoOptimized.ArithmeticInstCount);
+		countRow("Bit instruction count:", m_info.BitInstCount, m_infoOptimized.BitInstCount);
+		countRow("Logical instruction count:", m_info.LogicalInstCount, m_infoOptimized.LogicalInstCount);
+		countRow("Texture instruction count:", m_info.TextureInstCount, m_infoOptimized.TextureInstCount);
+		countRow("Derivative instruction count:", m_info.DerivativeInstCount, m_infoOptimized.DerivativeInstCount);
+		countRow("Control flow instruction count:", m_info.ControlFlowInstCount, m_infoOptimized.ControlFlowInstCount);
+		countRow("SPIR-V size (words):", (int)m_spv.size(), (int)m_spvOptimized.size());
+		ImGui::Columns(1);
 
 		ImGui::NewLine();
 
 		ImGui::Text("SPIR-V: ");
+		ImGui::SameLine();
+		if (ImGui::Checkbox("Optimized##stats_showopt", &m_showOptimized))
+			m_spirv.SetText(m_showOptimized ? m_disassemblyOptimized : m_disassembly);
 		ImGui::Separator();
 		m_spirv.Render("stats");
 		ImGui::Separator();					
@@ -31,48 +52,46 @@ namespace ed {
 		if (item->Type == PipelineItem::ItemType::ShaderPass) {
 			pipe::ShaderPass* pass = (pipe::ShaderPass*)item->Data;
 
-			spvtools::SpirvTools core(SPV_ENV_UNIVERSAL_1_3);
-			std::string disassembly;
-
-			m_spv = pass->VSSPV;
 			if (stage == ShaderStage::Pixel)
-				m_spv = pass->PSSPV;
+				m_setSPIRV(pass->PSSPV);
 			else if (stage == ShaderStage::Geometry)
-				m_spv = pass->GSSPV;
-
-			core.Disassemble(m_spv, &disassembly, SPV_BINARY_TO_TEXT_OPTION_INDENT | SPV_BINARY_TO_TEXT_OPTION_FRIENDLY_NAMES);
-
-			m_spirv.SetPalette(ThemeContainer::Instance().GetTextEditorStyle(Settings::Instance().Theme));
-			m_spirv.SetText(disassembly);
+				m_setSPIRV(pass->GSSPV);
+			else
+				m_setSPIRV(pass->VSSPV);
 		}
 		else if (item->Type == PipelineItem::ItemType::ComputePass) {
 			pipe::ComputePass* pass = (pipe::ComputePass*)item->Data;
 
-			spvtools::SpirvTools core(SPV_ENV_UNIVERSAL_1_3);
-			std::string disassembly;
-
-			m_spv = pass->SPV;
-			core.Disassemble(m_spv, &disassembly, SPV_BINARY_TO_TEXT_OPTION_INDENT | SPV_BINARY_TO_TEXT_OPTION_FRIENDLY_NAMES);
-
-			m_spirv.SetPalette(ThemeContainer::Instance().GetTextEditorStyle(Settings::Instance().Theme));
-			m_spirv.SetText(disassembly);
+			m_setSPIRV(pass->SPV);
 		} else if (item->Type == PipelineItem::ItemType::PluginItem) {
 			pipe::PluginItemData* pass = (pipe::PluginItemData*)item->Data;
 
-			spvtools::SpirvTools core(SPV_ENV_UNIVERSAL_1_3);
-			std::string disassembly;
-
 			unsigned int spvSize = pass->Owner->PipelineItem_GetSPIRVSize(pass->Type, pass->PluginData, (ed::plugin::ShaderStage)stage);
 			unsigned int* spv = pass->Owner->PipelineItem_GetSPIRV(pass->Type, pass->PluginData, (ed::plugin::ShaderStage)stage); 
 
-			m_spv = std::vector<unsigned int>(spv, spv + spvSize);
-			core.Disassemble(m_spv, &disassembly, SPV_BINARY_TO_TEXT_OPTION_INDENT | SPV_BINARY_TO_TEXT_OPTION_FRIENDLY_NAMES);
+			m_setSPIRV(std::vector<unsigned int>(spv, spv + spvSize));
+		}
 
-			m_spirv.SetPalette(ThemeContainer::Instance().GetTextEditorStyle(Settings::Instance().Theme));
-			m_spirv.SetText(disassembly);
+		if (!m_spv.empty()) {
+			m_info.Parse(m_spv);
+			m_infoOptimized.Parse(m_spvOptimized);
 		}
+	}
+	void StatsPage::m_setSPIRV(const std::vector<unsigned int>& spv)
+	{
+		spvtools::SpirvTools core(SPV_ENV_UNIVERSAL_1_3);
 
+		m_spv = spv;
+		m_spvOptimized.clear();
 		if (!m_spv.empty())
-			m_info.Parse(m_spv);
+			m_spvOptimized = ShaderCompiler::OptimizeSPIRV(m_spv);
+
+		m_disassembly.clear();
+		m_disassemblyOptimized.clear();
+		core.Disassemble(m_spv, &m_disassembly, SPV_BINARY_TO_TEXT_OPTION_INDENT | SPV_BINARY_TO_TEXT_OPTION_FRIENDLY_NAMES);
+		core.Disassemble(m_spvOptimized, &m_disassemblyOptimized, SPV_BINARY_TO_TEXT_OPTION_INDENT | SPV_BINARY_TO_TEXT_OPTION_FRIENDLY_NAMES);
+
+		m_spirv.SetPalette(ThemeContainer::Instance().GetTextEditorStyle(Settings::Instance().Theme));
+		m_spirv.SetText(m_showOptimized ? m_disassemblyOptimized : m_disassembly);
 	}
-}
\ No newline at end of file
+}
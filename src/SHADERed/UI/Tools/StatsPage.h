@@ -11,6 +11,7 @@ namespace ed {
 				: UIView(ui, objects, name, visible)
 		{
 			m_spirv.SetReadOnly(true);
+			m_showOptimized = false;
 		}
 
 		virtual void OnEvent(const SDL_Event& e);
@@ -19,9 +20,13 @@ namespace ed {
 		void Refresh(PipelineItem* item, ShaderStage stage);
 
 	private:
-		SPIRVParser m_info;
+		SPIRVParser m_info, m_infoOptimized;
 		TextEditor m_spirv;
 
-		std::vector<unsigned int> m_spv;
+		std::vector<unsigned int> m_spv, m_spvOptimized;
+		std::string m_disassembly, m_disassemblyOptimized;
+		bool m_showOptimized;
+
+		void m_setSPIRV(const std::vector<unsigned int>& spv);
 	};
 }
\ No newline at end of file